@@ -0,0 +1,95 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyntheticImage.h"
+#include <cstring>
+#include <vector>
+
+namespace grk
+{
+SyntheticImage::SyntheticImage(uint16_t numcomps, uint32_t width, uint32_t height,
+							   uint32_t imageno, bool noise)
+	: numcomps(numcomps), width(width), height(height), imageno(imageno), noise(noise)
+{}
+int32_t SyntheticImage::getSample(uint32_t i, uint32_t j, uint16_t compno) const
+{
+	if(!noise)
+		return (int32_t)((i * (3 + compno) + j * 5 + ((i * j) >> 4) + imageno * 7) & 0xFF);
+	uint32_t x = i * 2654435761U ^ j * 40503U ^ compno * 977U ^ imageno * 0x9E3779B9U;
+	x ^= x >> 13;
+	x *= 0x5bd1e995U;
+	x ^= x >> 15;
+
+	return (int32_t)(x & 0xFF);
+}
+grk_image* SyntheticImage::create(void) const
+{
+	std::vector<grk_image_cmptparm> params(numcomps);
+	memset(params.data(), 0, numcomps * sizeof(grk_image_cmptparm));
+	for(auto& param : params)
+	{
+		param.dx = 1;
+		param.dy = 1;
+		param.w = width;
+		param.h = height;
+		param.prec = 8;
+	}
+	auto image = grk_image_new(numcomps, params.data(), GRK_CLRSPC_SRGB, true);
+	if(!image)
+		return nullptr;
+	image->x1 = width;
+	image->y1 = height;
+	for(uint16_t compno = 0; compno < numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		for(uint32_t j = 0; j < height; ++j)
+		{
+			for(uint32_t i = 0; i < width; ++i)
+				comp->data[(uint64_t)j * comp->stride + i] = getSample(i, j, compno);
+		}
+	}
+
+	return image;
+}
+bool SyntheticImage::compress(grk_cparameters* parameters, GRK_CODEC_FORMAT format,
+							  grk_stream* stream, grk_codec_stats* stats) const
+{
+	auto image = create();
+	if(!image)
+		return false;
+	auto codec = grk_compress_create(format, stream);
+	bool rc = codec && grk_compress_init(codec, parameters, image) &&
+			  grk_compress_start(codec) && grk_compress(codec) && grk_compress_end(codec);
+	if(rc && stats)
+		rc = grk_codec_get_stats(codec, stats);
+	grk_object_unref(codec);
+	grk_object_unref(&image->obj);
+
+	return rc;
+}
+bool SyntheticImage::compress(grk_cparameters* parameters, const char* file,
+							  grk_codec_stats* stats) const
+{
+	auto stream = grk_stream_create_file_stream(file, 1024 * 1024, false);
+	if(!stream)
+		return false;
+	bool rc = compress(parameters, GRK_CODEC_J2K, stream, stats);
+	grk_object_unref(stream);
+
+	return rc;
+}
+
+} // namespace grk
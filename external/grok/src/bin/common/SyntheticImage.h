@@ -0,0 +1,72 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "grok.h"
+
+namespace grk
+{
+/**
+ * Synthetic 8 bit sRGB image, so that tests and benchmarks can compress
+ * images of any geometry without reading them from disk.
+ *
+ * Samples are either a smooth pattern, which compresses well, or noise,
+ * which keeps packets long and makes them differ from tile to tile.
+ * Each image index in a run of images gives a different image.
+ */
+struct SyntheticImage
+{
+	SyntheticImage(uint16_t numcomps, uint32_t width, uint32_t height, uint32_t imageno,
+				   bool noise);
+	int32_t getSample(uint32_t i, uint32_t j, uint16_t compno) const;
+	/**
+	 * Create image, filled with samples
+	 *
+	 * @return image, to be released with grk_object_unref, or nullptr on failure
+	 */
+	grk_image* create(void) const;
+	/**
+	 * Compress image to a stream
+	 *
+	 * @param parameters compression parameters
+	 * @param format code stream format
+	 * @param stream destination stream, which is not released
+	 * @param stats if not nullptr, receives the compressor's stats
+	 *
+	 * @return true if successful
+	 */
+	bool compress(grk_cparameters* parameters, GRK_CODEC_FORMAT format, grk_stream* stream,
+				  grk_codec_stats* stats) const;
+	/**
+	 * Compress image to a J2K file
+	 *
+	 * @param parameters compression parameters
+	 * @param file destination file
+	 * @param stats if not nullptr, receives the compressor's stats
+	 *
+	 * @return true if successful
+	 */
+	bool compress(grk_cparameters* parameters, const char* file, grk_codec_stats* stats) const;
+
+	uint16_t numcomps;
+	uint32_t width;
+	uint32_t height;
+	uint32_t imageno;
+	bool noise;
+};
+
+} // namespace grk
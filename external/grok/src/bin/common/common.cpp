@@ -23,6 +23,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <cinttypes>
 #include <condition_variable>
 using namespace std::chrono_literals;
 
@@ -324,6 +325,45 @@ char* actual_path(const char* outfile, bool* mem_allocated)
 #endif
 }
 
+void accumulateCodecStats(grk_codec_stats* total, grk_codec* codec)
+{
+	grk_codec_stats stats;
+	if(!codec || !grk_codec_get_stats(codec, &stats))
+		return;
+	for(uint32_t i = 0; i < GRK_NUM_STAGES; ++i)
+	{
+		auto dest = total->stages + i;
+		auto src = stats.stages + i;
+		dest->count += src->count;
+		dest->wallNs += src->wallNs;
+		dest->cpuNs += src->cpuNs;
+		dest->bytes += src->bytes;
+	}
+}
+
+bool writeCodecStats(const char* fileName, const grk_codec_stats* stats)
+{
+	FILE* fp = fopen(fileName, "w");
+	if(!fp)
+	{
+		spdlog::error("Unable to open stats file {} for writing", fileName);
+		return false;
+	}
+	fprintf(fp, "{\n\t\"stages\": {\n");
+	for(uint32_t i = 0; i < GRK_NUM_STAGES; ++i)
+	{
+		auto stage = stats->stages + i;
+		fprintf(fp,
+				"\t\t\"%s\": {\"count\": %" PRIu64 ", \"wall_ns\": %" PRIu64
+				", \"cpu_ns\": %" PRIu64 ", \"bytes\": %" PRIu64 "}%s\n",
+				grk_codec_stage_name((GRK_STAGE)i), stage->count, stage->wallNs, stage->cpuNs,
+				stage->bytes, i + 1 < GRK_NUM_STAGES ? "," : "");
+	}
+	fprintf(fp, "\t}\n}\n");
+
+	return safe_fclose(fp);
+}
+
 uint32_t uint_adds(uint32_t a, uint32_t b)
 {
 	uint64_t sum = (uint64_t)a + (uint64_t)b;
@@ -124,6 +124,14 @@ const char* pathSeparator();
 char* get_file_name(char* name);
 uint32_t get_num_images(char* imgdirpath);
 char* actual_path(const char* outfile, bool* mem_allocated);
+/**
+ * Add counters of one codec to a running total
+ */
+void accumulateCodecStats(grk_codec_stats* total, grk_codec* codec);
+/**
+ * Write codec stage counters to a JSON file
+ */
+bool writeCodecStats(const char* fileName, const grk_codec_stats* stats);
 
 // swap endian for 16 bit integer
 template<typename T>
@@ -326,6 +326,9 @@ static void compress_help_display(void)
 	fprintf(stdout, "    A value of -1 will specify all devices.\n");
 	fprintf(stdout, "[-W | -logfile] <log file name>\n"
 					"    log to file. File name will be set to \"log file name\"\n");
+	fprintf(stdout, "[-j | -Stats] <stats file name>\n"
+					"    Write wall time, CPU time and byte counters of each codec stage,\n"
+					"    summed over all compressed images, to JSON file\n");
 }
 
 static GRK_PROG_ORDER getProgression(const char progression[4])
@@ -492,6 +495,8 @@ static int parseCommandLine(int argc, char** argv, CompressInitParams* initParam
 			"e", "Repetitions",
 			"Number of compress repetitions, for either a folder or a single file", false, 0,
 			"unsigned integer", cmd);
+		TCLAP::ValueArg<std::string> statsArg("j", "Stats", "Codec stage stats file", false, "",
+											  "string", cmd);
 
 		TCLAP::ValueArg<uint16_t> rsizArg("Z", "RSIZ", "RSIZ", false, 0, "unsigned integer", cmd);
 
@@ -633,6 +638,8 @@ static int parseCommandLine(int argc, char** argv, CompressInitParams* initParam
 
 		if(repetitionsArg.isSet())
 			parameters->repeats = repetitionsArg.getValue();
+		if(statsArg.isSet())
+			initParams->statsFile = statsArg.getValue();
 
 		if(kernelBuildOptionsArg.isSet())
 			parameters->kernelBuildOptions = kernelBuildOptionsArg.getValue();
@@ -1738,6 +1745,8 @@ static int compress(const std::string& inputFile, CompressInitParams* initParams
 }
 
 grk_img_fol img_fol_plugin, out_fol_plugin;
+// codec stage stats, summed over all compressed images
+static grk_codec_stats codecStats;
 
 static bool pluginCompressCallback(grk_plugin_compress_user_callback_info* info)
 {
@@ -2149,6 +2158,7 @@ static bool pluginCompressCallback(grk_plugin_compress_user_callback_info* info)
 		}
 	}
 cleanup:
+	accumulateCodecStats(&codecStats, codec);
 	if(stream)
 		grk_object_unref(stream);
 	grk_object_unref(codec);
@@ -2324,6 +2334,9 @@ int main(int argc, char** argv)
 						 (elapsed.count() * 1000) / (double)numCompressedFiles,
 						 numCompressedFiles > 1 ? "ms/image" : "ms");
 		}
+		if(!initParams.statsFile.empty() &&
+		   !writeCodecStats(initParams.statsFile.c_str(), &codecStats))
+			success = 1;
 	}
 	catch(std::bad_alloc& ba)
 	{
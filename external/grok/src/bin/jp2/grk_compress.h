@@ -36,6 +36,8 @@ struct CompressInitParams
 	grk_img_fol inputFolder;
 	grk_img_fol outFolder;
 	bool transferExifTags;
+	// JSON file for codec stage stats; empty if stats are not written
+	std::string statsFile;
 };
 
 } // namespace grk
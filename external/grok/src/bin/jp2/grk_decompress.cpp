@@ -198,6 +198,9 @@ static void decompress_help_display(void)
 		"    Store XML metadata to file. File name will be set to \"xml file name\" + \".xml\"\n");
 	fprintf(stdout, "  [-W | -logfile] <log file name>\n"
 					"    log to file. File name will be set to \"log file name\"\n");
+	fprintf(stdout, "  [-j | -Stats] <stats file name>\n"
+					"    Write wall time, CPU time and byte counters of each codec stage,\n"
+					"    summed over all decompressed images, to JSON file\n");
 	fprintf(stdout, "\n");
 }
 
@@ -498,6 +501,8 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 			"e", "Repetitions",
 			"Number of compress repetitions, for either a folder or a single file", false, 0,
 			"unsigned integer", cmd);
+		TCLAP::ValueArg<std::string> statsArg("j", "Stats", "Codec stage stats file", false, "",
+											  "string", cmd);
 
 		TCLAP::SwitchArg verboseArg("v", "verbose", "Verbose", cmd);
 		cmd.parse(argc, argv);
@@ -737,6 +742,8 @@ int GrkDecompress::parseCommandLine(int argc, char** argv, DecompressInitParams*
 		{
 			parameters->repeats = repetitionsArg.getValue();
 		}
+		if(statsArg.isSet())
+			statsFile = statsArg.getValue();
 
 		if(kernelBuildOptionsArg.isSet())
 		{
@@ -1555,6 +1562,7 @@ int GrkDecompress::postProcess(grk_plugin_decompress_callback_info* info)
 	}
 	failed = false;
 cleanup:
+	accumulateCodecStats(&codecStats, info->codec);
 	grk_object_unref(info->stream);
 	info->stream = nullptr;
 	grk_object_unref(info->codec);
@@ -1631,6 +1639,8 @@ int GrkDecompress::main(int argc, char** argv)
 			}
 		}
 		printTiming(numDecompressed, std::chrono::high_resolution_clock::now() - start);
+		if(!statsFile.empty() && !writeCodecStats(statsFile.c_str(), &codecStats))
+			rc = EXIT_FAILURE;
 	}
 	catch(std::bad_alloc& ba)
 	{
@@ -1644,7 +1654,10 @@ cleanup:
 	grk_deinitialize();
 	return rc;
 }
-GrkDecompress::GrkDecompress() : storeToDisk(true), imageFormat(nullptr) {}
+GrkDecompress::GrkDecompress() : storeToDisk(true), imageFormat(nullptr)
+{
+	memset(&codecStats, 0, sizeof(codecStats));
+}
 GrkDecompress::~GrkDecompress(void)
 {
 	delete imageFormat;
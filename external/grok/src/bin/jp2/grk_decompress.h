@@ -73,6 +73,9 @@ class GrkDecompress
 
 	bool storeToDisk;
 	IImageFormat* imageFormat;
+	// JSON file for codec stage stats; empty if stats are not written
+	std::string statsFile;
+	grk_codec_stats codecStats;
 };
 
 } // namespace grk
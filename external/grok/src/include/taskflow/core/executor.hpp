@@ -139,6 +139,18 @@ class Executor {
     */
     int this_worker_id() const;
 
+    /**
+    @brief runs a taskflow from a worker of this executor and returns when it completes
+
+    Unlike waiting on the future returned by tf::Executor::run, the calling
+    worker keeps executing tasks while the taskflow is pending, so a task
+    may run a nested taskflow without starving the executor.
+    (backport of tf::Executor::corun from later Taskflow releases)
+
+    @param taskflow a tf::Taskflow object
+    */
+    void corun(Taskflow& taskflow);
+
     /** 
     @brief runs a given function asynchronously
 
@@ -1172,6 +1184,21 @@ inline void Executor::wait_for_all() {
   _topology_cv.wait(lock, [&](){ return _num_topologies == 0; });
 }
 
+// Function: corun
+inline void Executor::corun(Taskflow& f) {
+
+  auto worker = _this_worker;
+
+  if(worker == nullptr || worker->_executor != this) {
+    TF_THROW("corun must be called by a worker of the executor");
+  }
+
+  // auxiliary parent that collects the join counter of the graph
+  Node parent;
+
+  _invoke_dynamic_task_internal(*worker, &parent, f._graph, false);
+}
+
 // ############################################################################
 // Forward Declaration: Subflow
 // ############################################################################
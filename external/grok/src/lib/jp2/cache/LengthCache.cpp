@@ -413,7 +413,7 @@ TilePartLengthInfo TileLengthMarkers::getNext(void)
 	return 0;
 }
 bool TileLengthMarkers::skipTo(uint16_t skipTileIndex, IBufferedStream* stream,
-							   uint64_t firstSotPos)
+							   uint64_t firstSotPos, PacketLengthMarkers* plm)
 {
 	assert(stream);
 	rewind();
@@ -427,6 +427,10 @@ bool TileLengthMarkers::skipTo(uint16_t skipTileIndex, IBufferedStream* stream,
 			GRK_ERROR("corrupt TLM marker");
 			return false;
 		}
+		if(plm)
+			plm->skipTilePart(firstSotPos - 2 + skip,
+							  tl.length > sot_marker_segment_len ? tl.length - sot_marker_segment_len
+																 : 0);
 		skip += tl.length;
 		tl = getNext();
 		tileIndex = (uint16_t)(tl.hasTileIndex ? tl.tileIndex : tileIndex + 1U);
@@ -434,6 +438,21 @@ bool TileLengthMarkers::skipTo(uint16_t skipTileIndex, IBufferedStream* stream,
 
 	return stream->seek(firstSotPos + skip);
 }
+void TileLengthMarkers::getTilePartPositions(uint64_t firstSotPos,
+											 std::vector<TilePartPosition>& positions)
+{
+	rewind();
+	uint64_t position = firstSotPos;
+	uint32_t numTileParts = 0;
+	for(auto tl = getNext(); tl.length; tl = getNext())
+	{
+		// without tile indices, there is exactly one tile part per tile, in tile order
+		auto tileIndex = (uint16_t)(tl.hasTileIndex ? tl.tileIndex : numTileParts);
+		positions.emplace_back(tileIndex, position, tl.length);
+		position += tl.length;
+		numTileParts++;
+	}
+}
 bool TileLengthMarkers::writeBegin(uint16_t numTilePartsTotal)
 {
 	streamStart = m_stream->tell();
@@ -20,6 +20,8 @@
 
 namespace grk
 {
+struct PacketLengthMarkers;
+
 struct MarkerInfo
 {
 	MarkerInfo(uint16_t _id, uint64_t _pos, uint32_t _len);
@@ -109,6 +111,20 @@ struct TilePartLengthInfo
 	uint16_t tileIndex;
 	uint32_t length;
 };
+/**
+ * Stream position of a tile part, derived from TLM markers
+ */
+struct TilePartPosition
+{
+	TilePartPosition(uint16_t tileno, uint64_t pos, uint32_t len)
+		: tileIndex(tileno), position(pos), length(len)
+	{}
+	uint16_t tileIndex;
+	/** position of SOT marker */
+	uint64_t position;
+	/** length of tile part, including SOT marker */
+	uint32_t length;
+};
 typedef std::vector<TilePartLengthInfo> TL_INFO_VEC;
 // map of (TLM marker id) => (tile part length vector)
 typedef std::map<uint8_t, TL_INFO_VEC*> TL_MAP;
@@ -122,7 +138,23 @@ struct TileLengthMarkers
 	bool read(uint8_t* headerData, uint16_t header_size);
 	void rewind(void);
 	TilePartLengthInfo getNext(void);
-	bool skipTo(uint16_t skipTileIndex, IBufferedStream* stream, uint64_t firstSotPos);
+	/**
+	 * Seek to first tile part of tile
+	 *
+	 * @param skipTileIndex	tile index
+	 * @param stream		code stream
+	 * @param firstSotPos	position just after first SOT marker id
+	 * @param plm			PLM markers, moved past tile parts that are seeked past (may be null)
+	 */
+	bool skipTo(uint16_t skipTileIndex, IBufferedStream* stream, uint64_t firstSotPos,
+				PacketLengthMarkers* plm);
+	/**
+	 * Get positions of all tile parts, in code stream order
+	 *
+	 * @param firstSotPos	position of first SOT marker
+	 * @param positions		receives tile part positions
+	 */
+	void getTilePartPositions(uint64_t firstSotPos, std::vector<TilePartPosition>& positions);
 
 	bool writeBegin(uint16_t numTilePartsTotal);
 	void push(uint16_t tileIndex, uint32_t tile_part_size);
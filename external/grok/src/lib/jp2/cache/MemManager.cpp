@@ -147,4 +147,68 @@ void grkFree(void* ptr)
 	if(ptr)
 		free(ptr);
 }
+BufferPool::BufferPool(void) : BufferPool(defaultMaxRetainedBytes) {}
+BufferPool::BufferPool(size_t maxRetainedBytes)
+	: maxRetainedBytes_(maxRetainedBytes), retainedBytes_(0)
+{}
+BufferPool::~BufferPool()
+{
+	clear();
+}
+size_t BufferPool::sizeClass(size_t size)
+{
+	if(size <= minClassSize)
+		return minClassSize;
+	// four classes per power of two, so at most a quarter of a block is wasted
+	size_t step = minClassSize;
+	while(step <= (size >> 3))
+		step <<= 1;
+	size_t rounded = (size + step - 1) & ~(step - 1);
+
+	return rounded < size ? size : rounded;
+}
+void* BufferPool::acquire(size_t size)
+{
+	size = sizeClass(size);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto iter = released_.find(size);
+		if(iter != released_.end() && !iter->second.empty())
+		{
+			auto ptr = iter->second.back();
+			iter->second.pop_back();
+			retainedBytes_ -= size;
+			return ptr;
+		}
+	}
+
+	return grkAlignedMalloc(size);
+}
+void BufferPool::release(void* ptr, size_t size)
+{
+	if(!ptr)
+		return;
+	size = sizeClass(size);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if(retainedBytes_ + size <= maxRetainedBytes_)
+		{
+			released_[size].push_back(ptr);
+			retainedBytes_ += size;
+			return;
+		}
+	}
+	grkAlignedFree(ptr);
+}
+void BufferPool::clear(void)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	for(auto& sized : released_)
+	{
+		for(auto ptr : sized.second)
+			grkAlignedFree(ptr);
+	}
+	released_.clear();
+	retainedBytes_ = 0;
+}
 } // namespace grk
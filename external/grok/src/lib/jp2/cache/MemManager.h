@@ -25,6 +25,9 @@
 #endif
 
 #include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
 
 namespace grk
 {
@@ -62,6 +65,52 @@ void* grkRealloc(void* m, size_t s);
  */
 void grkFree(void* m);
 
+
+/**
+ * Aligned memory blocks that are recycled, rather than freed, on release.
+ *
+ * Block sizes are rounded up to size classes, and released blocks are kept in
+ * free lists keyed by class, so that decompressing a run of images with similar
+ * geometry reuses the same blocks. Blocks released once the pool already retains
+ * its maximum number of bytes are freed instead.
+ * Thread safe.
+ */
+class BufferPool
+{
+  public:
+	BufferPool(void);
+	explicit BufferPool(size_t maxRetainedBytes);
+	~BufferPool();
+	/**
+	 * Get an aligned block, reusing a released block of the same size class if one is available
+	 * @param size Bytes to allocate
+	 * @return a pointer to the block, or nullptr if there is insufficient memory available
+	 */
+	void* acquire(size_t size);
+	/**
+	 * Return block to the pool
+	 * @param ptr block previously allocated with acquire
+	 * @param size size of block, as passed to acquire
+	 */
+	void release(void* ptr, size_t size);
+	/**
+	 * Free all released blocks
+	 */
+	void clear(void);
+
+	// blocks are rounded up to at least this many bytes
+	static const size_t minClassSize = 4096;
+	static const size_t defaultMaxRetainedBytes = (size_t)256 * 1024 * 1024;
+
+  private:
+	static size_t sizeClass(size_t size);
+	std::mutex mutex_;
+	std::map<size_t, std::vector<void*>> released_;
+	size_t maxRetainedBytes_;
+	// total size of released blocks
+	size_t retainedBytes_;
+};
+
 template<typename T>
 struct AllocatorVanilla
 {
@@ -69,22 +118,31 @@ struct AllocatorVanilla
 	{
 		return new T[length];
 	}
-	void dealloc(T* buf)
+	void dealloc(T* buf, size_t length)
 	{
+		GRK_UNUSED(length);
 		delete[] buf;
 	}
 };
 template<typename T>
 struct AllocatorAligned
 {
+	AllocatorAligned() : pool(nullptr) {}
 	T* alloc(size_t length)
 	{
+		if(pool)
+			return (T*)pool->acquire(length * sizeof(T));
 		return (T*)grkAlignedMalloc(length * sizeof(T));
 	}
-	void dealloc(T* buf)
+	void dealloc(T* buf, size_t length)
 	{
-		grkAlignedFree(buf);
+		if(pool && buf)
+			pool->release(buf, length * sizeof(T));
+		else
+			grkAlignedFree(buf);
 	}
+	// if set, memory is recycled through this pool
+	BufferPool* pool;
 };
 template<typename T, template<typename TT> typename A>
 struct grkBuffer : A<T>
@@ -135,7 +193,7 @@ struct grkBuffer : A<T>
 	virtual void dealloc()
 	{
 		if(owns_data)
-			A<T>::dealloc(buf);
+			A<T>::dealloc(buf, len);
 		buf = nullptr;
 		owns_data = false;
 		offset = 0;
@@ -269,6 +327,11 @@ struct grkBuffer2d : private grkBuffer<T, A>, public grkRectU32
 
 		return true;
 	}
+	// recycle buffer memory through pool
+	void setPool(BufferPool* bufferPool)
+	{
+		this->pool = bufferPool;
+	}
 	// set buf to buf without owning it
 	void attach(T* buffer, uint32_t strd)
 	{
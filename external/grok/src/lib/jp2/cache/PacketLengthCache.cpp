@@ -20,11 +20,14 @@ namespace grk
 {
 #include "grk_includes.h"
 
-PacketLengthCache::PacketLengthCache(CodingParams* cp) : pltMarkers(nullptr), m_cp(cp) {}
+PacketLengthCache::PacketLengthCache(CodingParams* cp)
+	: pltMarkers(nullptr), plmMarkers(nullptr), m_cp(cp)
+{}
 
 PacketLengthCache::~PacketLengthCache()
 {
 	delete pltMarkers;
+	delete plmMarkers;
 }
 
 PacketLengthMarkers* PacketLengthCache::createMarkers(IBufferedStream* strm)
@@ -46,18 +49,28 @@ void PacketLengthCache::deleteMarkers(void)
 	pltMarkers = nullptr;
 }
 
+void PacketLengthCache::pushPlmLengths(const PL_INFO_VEC* lengths)
+{
+	if(!plmMarkers)
+	{
+		plmMarkers = new PacketLengthMarkers();
+		plmMarkers->pushInit();
+	}
+	for(auto len : *lengths)
+		plmMarkers->pushNextPacketLength(len);
+}
+
 PacketInfo* PacketLengthCache::next(void)
 {
 	auto packetInfo = packetInfoCache.get();
-	if(!packetInfo->packetLength)
+	// packet lengths are popped even when the packet is already known,
+	// so that markers stay in step with packets iterated by a later decompress
+	if(pltMarkers)
 	{
-		// we don't currently support PLM markers,
-		// so we disable packet length markers if we have both PLT and PLM
-		auto packetLengths = pltMarkers;
-		bool usePlt = packetLengths && !m_cp->plm_markers;
-		if(usePlt)
+		auto packetLength = pltMarkers->popNextPacketLength();
+		if(!packetInfo->packetLength)
 		{
-			packetInfo->packetLength = packetLengths->popNextPacketLength();
+			packetInfo->packetLength = packetLength;
 			if(packetInfo->packetLength == 0)
 			{
 				GRK_ERROR("PLT marker: missing packet lengths.");
@@ -65,18 +78,30 @@ PacketInfo* PacketLengthCache::next(void)
 			}
 		}
 	}
+	else if(plmMarkers)
+	{
+		// PLM lengths may not cover all tile parts : if missing,
+		// then the packet length is found by reading the packet header
+		auto packetLength = plmMarkers->popNextPacketLength();
+		if(!packetInfo->packetLength)
+			packetInfo->packetLength = packetLength;
+	}
 
 	return packetInfo;
 }
 
 void PacketLengthCache::rewind(void)
 {
-	auto packetLengths = pltMarkers;
-	// we don't currently support PLM markers,
-	// so we disable packet length markers if we have both PLT and PLM
-	bool usePlt = packetLengths && !m_cp->plm_markers;
-	if(usePlt)
-		packetLengths->rewind();
+	if(pltMarkers)
+		pltMarkers->rewind();
+	if(plmMarkers)
+		plmMarkers->rewind();
+	packetInfoCache.rewind();
+}
+
+void PacketLengthCache::clearPacketInfo(void)
+{
+	packetInfoCache.clear();
 }
 
 } // namespace grk
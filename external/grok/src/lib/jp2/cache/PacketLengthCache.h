@@ -28,11 +28,27 @@ class PacketLengthCache
 	PacketLengthMarkers* createMarkers(IBufferedStream* strm);
 	PacketLengthMarkers* getMarkers(void);
 	void deleteMarkers(void);
+	/**
+	 * Add packet lengths of a tile part, read from PLM markers.
+	 * PLT markers take precedence over PLM markers
+	 *
+	 * @param lengths packet lengths
+	 */
+	void pushPlmLengths(const PL_INFO_VEC* lengths);
 	PacketInfo* next(void);
+	/**
+	 * Rewind to first packet; packet info from previous
+	 * packet iteration is kept
+	 */
 	void rewind(void);
+	/**
+	 * Discard packet info, as packet headers must be read again
+	 */
+	void clearPacketInfo(void);
 
   private:
 	PacketLengthMarkers* pltMarkers;
+	PacketLengthMarkers* plmMarkers;
 	SequentialCache<PacketInfo> packetInfoCache;
 	CodingParams* m_cp;
 };
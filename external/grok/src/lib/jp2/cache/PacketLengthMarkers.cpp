@@ -30,7 +30,7 @@ const uint32_t available_packet_len_bytes_per_plt = USHRT_MAX - 1 - 4;
 PacketLengthMarkers::PacketLengthMarkers()
 	: m_markers(new PL_MAP()), m_markerIndex(0), m_curr_vec(nullptr), m_packetIndex(0),
 	  m_packet_len(0), m_markerBytesWritten(0), m_totalBytesWritten(0), m_marker_len_cache(0),
-	  m_stream(nullptr), preCalculatedMarkerLengths(false)
+	  m_stream(nullptr), preCalculatedMarkerLengths(false), m_tilePartIndex(0)
 {}
 PacketLengthMarkers::PacketLengthMarkers(IBufferedStream* strm) : PacketLengthMarkers()
 {
@@ -187,10 +187,12 @@ bool PacketLengthMarkers::readPLM(uint8_t* headerData, uint16_t header_size)
 		GRK_ERROR("PLM marker segment too short");
 		return false;
 	}
-	// Zplm
-	uint8_t Zplm = *headerData++;
+	// Zplm : PLM segments are expected in index order,
+	// and tile parts are listed in code stream order
+	++headerData;
 	--header_size;
-	readInit(Zplm);
+	m_packet_len = 0;
+	bool firstInSegment = true;
 	while(header_size > 0)
 	{
 		// Nplm
@@ -200,12 +202,17 @@ bool PacketLengthMarkers::readPLM(uint8_t* headerData, uint16_t header_size)
 			GRK_ERROR("Malformed PLM marker segment");
 			return false;
 		}
+		m_tilePartContinues.push_back(firstInSegment && !m_tilePartLengths.empty());
+		firstInSegment = false;
+		m_tilePartLengths.emplace_back();
+		m_curr_vec = &m_tilePartLengths.back();
 		for(uint32_t i = 0; i < Nplm; ++i)
 		{
 			uint8_t tmp = *headerData;
 			++headerData;
 			readNext(tmp);
 		}
+		m_curr_vec = nullptr;
 		header_size = (uint16_t)(header_size - (1 + Nplm));
 		if(m_packet_len != 0)
 		{
@@ -215,6 +222,75 @@ bool PacketLengthMarkers::readPLM(uint8_t* headerData, uint16_t header_size)
 	}
 	return true;
 }
+void PacketLengthMarkers::seekTilePart(uint64_t sotPosition)
+{
+	auto iter = m_tilePartStart.find(sotPosition);
+	if(iter != m_tilePartStart.end())
+		m_tilePartIndex = iter->second;
+	else
+		m_tilePartStart[sotPosition] = m_tilePartIndex;
+}
+void PacketLengthMarkers::discardTileParts(void)
+{
+	GRK_WARN("PLM marker: packet lengths do not match tile part length. "
+			 "PLM markers will be ignored.");
+	m_tilePartLengths.clear();
+	m_tilePartContinues.clear();
+	m_tilePartStart.clear();
+	m_tilePartIndex = 0;
+}
+bool PacketLengthMarkers::popTilePartLengths(uint64_t sotPosition, uint64_t tilePartDataLength,
+											 PL_INFO_VEC* lengths)
+{
+	seekTilePart(sotPosition);
+	if(m_tilePartIndex == m_tilePartLengths.size())
+		return false;
+	// a tile part's lengths may continue in the next PLM segment
+	uint64_t totalLength = 0;
+	do
+	{
+		auto tilePart = m_tilePartLengths.begin() + (ptrdiff_t)m_tilePartIndex++;
+		lengths->insert(lengths->end(), tilePart->begin(), tilePart->end());
+		totalLength = std::accumulate(tilePart->begin(), tilePart->end(), totalLength);
+	} while(totalLength < tilePartDataLength && m_tilePartIndex < m_tilePartLengths.size());
+	if(totalLength != tilePartDataLength ||
+	   std::find(lengths->begin(), lengths->end(), 0U) != lengths->end())
+	{
+		discardTileParts();
+		lengths->clear();
+		return false;
+	}
+
+	return true;
+}
+void PacketLengthMarkers::skipTilePart(uint64_t sotPosition, uint64_t tilePartLength)
+{
+	seekTilePart(sotPosition);
+	if(m_tilePartIndex == m_tilePartLengths.size())
+		return;
+	// last tile part of code stream
+	if(!tilePartLength)
+	{
+		m_tilePartIndex = m_tilePartLengths.size();
+		return;
+	}
+	// tile part header length is unknown, so a following Nplm only continues the tile part
+	// if it begins a PLM marker segment, and still fits before the end of the tile part
+	uint64_t maxDataLength = tilePartLength >= 2 ? tilePartLength - 2 : 0;
+	auto tilePart = m_tilePartLengths.begin() + (ptrdiff_t)m_tilePartIndex++;
+	uint64_t totalLength = std::accumulate(tilePart->begin(), tilePart->end(), (uint64_t)0);
+	while(m_tilePartIndex < m_tilePartLengths.size() && m_tilePartContinues[m_tilePartIndex])
+	{
+		tilePart = m_tilePartLengths.begin() + (ptrdiff_t)m_tilePartIndex;
+		uint64_t length = std::accumulate(tilePart->begin(), tilePart->end(), (uint64_t)0);
+		if(totalLength + length > maxDataLength)
+			break;
+		totalLength += length;
+		m_tilePartIndex++;
+	}
+	if(totalLength > maxDataLength)
+		discardTileParts();
+}
 bool PacketLengthMarkers::readPLT(uint8_t* headerData, uint16_t header_size)
 {
 	if(header_size < 1)
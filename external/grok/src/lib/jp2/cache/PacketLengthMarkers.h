@@ -44,6 +44,25 @@ struct PacketLengthMarkers
 	// decompressor  packet lengths
 	bool readPLT(uint8_t* headerData, uint16_t header_size);
 	bool readPLM(uint8_t* headerData, uint16_t header_size);
+	/**
+	 * Pop the PLM packet lengths of a tile part.
+	 * PLM packet lengths are discarded if they do not add up to the tile part length.
+	 *
+	 * @param sotPosition position of tile part's SOT marker
+	 * @param tilePartDataLength length of tile part data
+	 * @param lengths vector that receives the packet lengths
+	 * @return true if packet lengths are available for the tile part
+	 */
+	bool popTilePartLengths(uint64_t sotPosition, uint64_t tilePartDataLength,
+							PL_INFO_VEC* lengths);
+	/**
+	 * Move past the PLM packet lengths of a tile part that is skipped or seeked past
+	 *
+	 * @param sotPosition position of tile part's SOT marker
+	 * @param tilePartLength length of tile part following its SOT marker segment,
+	 * or zero if tile part extends to the end of the code stream
+	 */
+	void skipTilePart(uint64_t sotPosition, uint64_t tilePartLength);
 	void rewind(void);
 	uint32_t popNextPacketLength(void);
 
@@ -58,6 +77,9 @@ struct PacketLengthMarkers
 	void tryWriteMarkerHeader(PacketLengthMarkerInfo* markerInfo, bool simulate);
 	void writeMarkerLength(PacketLengthMarkerInfo* markerInfo);
 	void writeIncrement(uint32_t bytes);
+	// move PLM tile part cursor to tile part at SOT position, if it was seen before
+	void seekTilePart(uint64_t sotPosition);
+	void discardTileParts(void);
 
 	PL_MAP* m_markers;
 	uint8_t m_markerIndex;
@@ -69,6 +91,14 @@ struct PacketLengthMarkers
 	uint64_t m_marker_len_cache;
 	IBufferedStream* m_stream;
 	bool preCalculatedMarkerLengths;
+	// PLM packet lengths, one vector per Nplm, in code stream order
+	std::vector<PL_INFO_VEC> m_tilePartLengths;
+	// true if Nplm is first in a PLM marker segment after the first segment,
+	// so it may continue the tile part of the previous Nplm
+	std::vector<bool> m_tilePartContinues;
+	size_t m_tilePartIndex;
+	// index of first Nplm of each tile part read so far, keyed by SOT position
+	std::map<uint64_t, size_t> m_tilePartStart;
 };
 
 } // namespace grk
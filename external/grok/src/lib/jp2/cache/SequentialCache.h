@@ -26,10 +26,19 @@ class SequentialCache
   public:
 	SequentialCache(void) : SequentialCache(kSequentialChunkSize) {}
 	SequentialCache(uint64_t maxChunkSize)
-		: m_chunkSize(std::min<uint64_t>(maxChunkSize, kSequentialChunkSize)), m_currChunk(nullptr),
-		  m_index(0)
+		: m_chunkSize(std::min<uint64_t>(maxChunkSize, kSequentialChunkSize)), m_index(0)
 	{}
 	virtual ~SequentialCache(void)
+	{
+		clear();
+	}
+	// items are kept, and will be returned again in the same order
+	void rewind(void)
+	{
+		m_index = 0;
+	}
+	// items are discarded
+	void clear(void)
 	{
 		for(auto& ch : chunks)
 		{
@@ -37,46 +46,27 @@ class SequentialCache
 				delete ch[i];
 			delete[] ch;
 		}
-	}
-	void rewind(void)
-	{
-		if(chunks.empty())
-			return;
+		chunks.clear();
 		m_index = 0;
-		m_currChunk = chunks[0];
 	}
 	T* get()
 	{
 		uint64_t itemIndex = m_index % m_chunkSize;
 		uint64_t chunkIndex = m_index / m_chunkSize;
-		bool initialized = (m_currChunk != nullptr);
-		bool lastChunk = (chunkIndex == chunks.size() - 1);
-		bool endOfChunk = (itemIndex == m_chunkSize - 1);
-		bool createNew = !initialized || (lastChunk && endOfChunk);
-		itemIndex++;
-		if(createNew || endOfChunk)
+		if(chunkIndex == chunks.size())
 		{
-			itemIndex = 0;
-			chunkIndex++;
-			if(createNew)
-			{
-				m_currChunk = new T*[m_chunkSize];
-				memset(m_currChunk, 0, m_chunkSize * sizeof(T*));
-				chunks.push_back(m_currChunk);
-			}
-			else
-			{
-				m_currChunk = chunks[chunkIndex];
-			}
+			auto chunk = new T*[m_chunkSize];
+			memset(chunk, 0, m_chunkSize * sizeof(T*));
+			chunks.push_back(chunk);
 		}
-		auto item = m_currChunk[itemIndex];
+		auto item = chunks[chunkIndex][itemIndex];
 		if(!item)
 		{
 			item = create();
-			m_currChunk[itemIndex] = item;
+			chunks[chunkIndex][itemIndex] = item;
 		}
-		if(initialized)
-			m_index++;
+		m_index++;
+
 		return item;
 	}
 
@@ -90,7 +80,7 @@ class SequentialCache
   private:
 	std::vector<T**> chunks;
 	uint64_t m_chunkSize;
-	T** m_currChunk;
+	// index of next item
 	uint64_t m_index;
 	static constexpr uint64_t kSequentialChunkSize = 1024;
 };
@@ -18,16 +18,20 @@
 
 namespace grk
 {
-TileCacheEntry::TileCacheEntry(TileProcessor* p) : processor(p) {}
+TileCacheEntry::TileCacheEntry(TileProcessor* p)
+	: processor(p), reduce(0), layers(0), imageBytes(0), processorBytes(0), cached(false),
+	  pinned(false)
+{}
 TileCacheEntry::TileCacheEntry() : TileCacheEntry(nullptr) {}
 TileCacheEntry::~TileCacheEntry()
 {
 	delete processor;
 }
 TileCache::TileCache(GRK_TILE_CACHE_STRATEGY strategy)
-	: tileComposite(nullptr), m_strategy(strategy)
+	: tileComposite(nullptr), m_strategy(strategy), m_maxBytes(0)
 {
 	tileComposite = new GrkImage();
+	memset(&m_stats, 0, sizeof(m_stats));
 }
 TileCache::TileCache() : TileCache(GRK_TILE_CACHE_NONE) {}
 TileCache::~TileCache()
@@ -39,14 +43,17 @@ TileCache::~TileCache()
 }
 bool TileCache::empty()
 {
+	std::lock_guard<std::mutex> lock(m_mutex);
 	return m_cache.empty();
 }
+// the map is read by cache updates from tiles that are still being decompressed,
+// while the decompressor adds entries for later tiles
 TileCacheEntry* TileCache::put(uint16_t tileIndex, TileProcessor* processor)
 {
-	TileCacheEntry* entry = nullptr;
-	if(m_cache.find(tileIndex) != m_cache.end())
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto entry = find(tileIndex);
+	if(entry)
 	{
-		entry = m_cache[tileIndex];
 		entry->processor = processor;
 	}
 	else
@@ -59,15 +66,144 @@ TileCacheEntry* TileCache::put(uint16_t tileIndex, TileProcessor* processor)
 }
 TileCacheEntry* TileCache::get(uint16_t tileIndex)
 {
-	if(m_cache.find(tileIndex) != m_cache.end())
-		return m_cache[tileIndex];
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return find(tileIndex);
+}
+TileCacheEntry* TileCache::find(uint16_t tileIndex)
+{
+	auto iter = m_cache.find(tileIndex);
 
-	return nullptr;
+	return iter != m_cache.end() ? iter->second : nullptr;
 }
 void TileCache::setStrategy(GRK_TILE_CACHE_STRATEGY strategy)
 {
 	m_strategy = strategy;
 }
+void TileCache::setMaxBytes(uint64_t maxBytes)
+{
+	m_maxBytes = maxBytes;
+}
+bool TileCache::isCaching(void)
+{
+	return m_strategy != GRK_TILE_CACHE_NONE;
+}
+void TileCache::beginDecompress(const std::vector<uint16_t>& tileIndices)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	// eviction is deferred until current decompress has finished, so that
+	// images from previous decompress can still be hit
+	for(auto& entry : m_cache)
+		entry.second->pinned = false;
+	for(auto tileIndex : tileIndices)
+	{
+		auto entry = find(tileIndex);
+		if(entry)
+			entry->pinned = true;
+	}
+}
+bool TileCache::lookup(uint16_t tileIndex, grkRectU32 window, uint8_t reduce, uint16_t layers)
+{
+	if(!isCaching())
+		return false;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto entry = find(tileIndex);
+	if(!entry || !entry->processor)
+	{
+		m_stats.misses++;
+		return false;
+	}
+	auto image = entry->processor->getImage();
+	// images transformed by the file format colour stage can't be composited again
+	if(entry->cached && image && !image->color_applied && entry->window == window &&
+	   entry->reduce == reduce && entry->layers == layers)
+	{
+		m_lru.splice(m_lru.begin(), m_lru, entry->lruPosition);
+		entry->pinned = true;
+		m_stats.hits++;
+		return true;
+	}
+	// stale image will be replaced by the decompressor, so it must not be
+	// touched by eviction in the meantime
+	uncache(entry);
+	m_stats.misses++;
+
+	return false;
+}
+void TileCache::add(uint16_t tileIndex, grkRectU32 window, uint8_t reduce, uint16_t layers)
+{
+	if(!isCaching())
+		return;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto entry = find(tileIndex);
+	if(!entry || !entry->processor)
+		return;
+	uncache(entry);
+	entry->window = window;
+	entry->reduce = reduce;
+	entry->layers = layers;
+	// a tile without an image can't be hit, but its processor is kept for refinement
+	auto image = entry->processor->getImage();
+	setBytes(entry, image ? image->dataBytes() : 0, entry->processor->getRetainedBytes());
+	entry->pinned = true;
+	entry->cached = true;
+	m_lru.push_front(tileIndex);
+	entry->lruPosition = m_lru.begin();
+}
+void TileCache::setBytes(TileCacheEntry* entry, uint64_t imageBytes, uint64_t processorBytes)
+{
+	m_stats.bytes -= entry->imageBytes + entry->processorBytes;
+	entry->imageBytes = imageBytes;
+	entry->processorBytes = processorBytes;
+	m_stats.bytes += imageBytes + processorBytes;
+}
+void TileCache::uncache(TileCacheEntry* entry)
+{
+	if(!entry->cached)
+		return;
+	m_lru.erase(entry->lruPosition);
+	// stale image is about to be replaced
+	setBytes(entry, 0, entry->processorBytes);
+	entry->cached = false;
+}
+void TileCache::evict(bool canReread)
+{
+	if(m_strategy != GRK_TILE_CACHE_LRU || m_maxBytes == 0)
+		return;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	// walk from least recently used, skipping tiles needed by current decompress
+	auto iter = m_lru.end();
+	while(m_stats.bytes > m_maxBytes && iter != m_lru.begin())
+	{
+		--iter;
+		auto entry = find(*iter);
+		if(entry->pinned)
+			continue;
+		iter = m_lru.erase(iter);
+		entry->cached = false;
+		m_stats.evictions++;
+		// packed packet headers are consumed when tile is first read, so
+		// tile processor and its compressed data must be kept
+		auto tcp = entry->processor->getTileCodingParams();
+		if(!canReread || tcp->ppt)
+		{
+			entry->processor->releaseImage();
+			setBytes(entry, 0, entry->processorBytes);
+			continue;
+		}
+		delete tcp->m_compressedTileData;
+		tcp->m_compressedTileData = nullptr;
+		delete entry->processor;
+		entry->processor = nullptr;
+		setBytes(entry, 0, 0);
+	}
+}
+void TileCache::getStats(grk_tile_cache_stats* stats)
+{
+	if(!stats)
+		return;
+	std::lock_guard<std::mutex> lock(m_mutex);
+	*stats = m_stats;
+}
 GrkImage* TileCache::getComposite()
 {
 	return tileComposite;
@@ -82,8 +218,12 @@ std::vector<GrkImage*> TileCache::getAllImages(void)
 std::vector<GrkImage*> TileCache::getTileImages(void)
 {
 	std::vector<GrkImage*> rc;
+	std::lock_guard<std::mutex> lock(m_mutex);
 	for(auto& entry : m_cache)
 	{
+		// when caching, only images belonging to current decompress are returned
+		if(!entry.second->processor || (isCaching() && !entry.second->pinned))
+			continue;
 		auto image = entry.second->processor->getImage();
 		if(image)
 			rc.push_back(image);
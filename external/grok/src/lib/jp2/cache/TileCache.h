@@ -17,6 +17,8 @@
 #pragma once
 
 #include <map>
+#include <list>
+#include <mutex>
 
 namespace grk
 {
@@ -32,6 +34,20 @@ struct TileCacheEntry
 	~TileCacheEntry();
 
 	TileProcessor* processor;
+
+	// decompress parameters that cached image was generated with
+	grkRectU32 window;
+	uint8_t reduce;
+	uint16_t layers;
+	// size of cached image in bytes
+	uint64_t imageBytes;
+	// bytes kept by processor and compressed tile data, to decompress tile again
+	uint64_t processorBytes;
+	// true if entry is in the LRU list
+	bool cached;
+	// true if image belongs to current decompress, and may not be evicted
+	bool pinned;
+	std::list<uint16_t>::iterator lruPosition;
 };
 
 class TileCache
@@ -43,17 +59,70 @@ class TileCache
 
 	bool empty(void);
 	void setStrategy(GRK_TILE_CACHE_STRATEGY strategy);
+	void setMaxBytes(uint64_t maxBytes);
+	bool isCaching(void);
 	TileCacheEntry* put(uint16_t tileIndex, TileProcessor* processor);
 	TileCacheEntry* get(uint16_t tileIndex);
+	/**
+	 * Start a new decompress: images from previous decompress are unpinned,
+	 * and may now be evicted, while images of tiles to be decompressed are pinned
+	 *
+	 * @param tileIndices indices of tiles to be decompressed
+	 */
+	void beginDecompress(const std::vector<uint16_t>& tileIndices);
+	/**
+	 * Look up cached tile image
+	 *
+	 * @param tileIndex tile index
+	 * @param window unreduced tile window
+	 * @param reduce number of discarded resolutions
+	 * @param layers number of decompressed layers
+	 *
+	 * @return true if cached image was generated with the same parameters;
+	 * image is then pinned for current decompress
+	 */
+	bool lookup(uint16_t tileIndex, grkRectU32 window, uint8_t reduce, uint16_t layers);
+	/**
+	 * Add freshly decompressed tile to cache. Tile image, if any, and
+	 * processor state are both counted against the cache budget
+	 *
+	 * @param tileIndex tile index
+	 * @param window unreduced tile window
+	 * @param reduce number of discarded resolutions
+	 * @param layers number of decompressed layers
+	 */
+	void add(uint16_t tileIndex, grkRectU32 window, uint8_t reduce, uint16_t layers);
+	/**
+	 * Evict least recently used tiles until cache is within budget.
+	 * Must be called once current decompress has finished: an evicted tile
+	 * loses its image, processor and compressed data, and must then be read
+	 * again from the code stream.
+	 *
+	 * @param canReread false if tile data can't be read again from the code stream
+	 * (e.g. packed packet headers), in which case only images are evicted,
+	 * and processor bytes stay counted
+	 */
+	void evict(bool canReread);
+	void getStats(grk_tile_cache_stats* stats);
 	GrkImage* getComposite(void);
 	std::vector<GrkImage*> getAllImages(void);
 	std::vector<GrkImage*> getTileImages(void);
 
   private:
+	// caller must hold m_mutex
+	TileCacheEntry* find(uint16_t tileIndex);
+	void uncache(TileCacheEntry* entry);
+	// update entry sizes, and cache total
+	void setBytes(TileCacheEntry* entry, uint64_t imageBytes, uint64_t processorBytes);
 	// each component is sub-sampled and resolution-reduced
 	GrkImage* tileComposite;
 	std::map<uint32_t, TileCacheEntry*> m_cache;
 	GRK_TILE_CACHE_STRATEGY m_strategy;
+	uint64_t m_maxBytes;
+	// tile indices, from most to least recently used
+	std::list<uint16_t> m_lru;
+	grk_tile_cache_stats m_stats;
+	std::mutex m_mutex;
 };
 
 } // namespace grk
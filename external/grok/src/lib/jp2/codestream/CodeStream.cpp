@@ -24,7 +24,8 @@ namespace grk
 {
 CodeStream::CodeStream(IBufferedStream* stream)
 	: codeStreamInfo(nullptr), m_headerImage(nullptr), m_currentTileProcessor(nullptr),
-	  m_stream(stream), m_multiTile(false), current_plugin_tile(nullptr)
+	  m_stream(stream), m_multiTile(false), current_plugin_tile(nullptr),
+	  m_stats(stream ? stream->getIOStats() : nullptr), m_decompressContext(nullptr)
 {
 }
 CodeStream::~CodeStream()
@@ -32,6 +33,8 @@ CodeStream::~CodeStream()
 	if(m_headerImage)
 		grk_object_unref(&m_headerImage->obj);
 	delete codeStreamInfo;
+	if(m_decompressContext)
+		grk_object_unref(m_decompressContext->getWrapper());
 }
 CodingParams* CodeStream::getCodingParams(void)
 {
@@ -57,6 +60,14 @@ grk_plugin_tile* CodeStream::getCurrentPluginTile()
 {
 	return current_plugin_tile;
 }
+CodecStats* CodeStream::getStats(void)
+{
+	return &m_stats;
+}
+DecompressContext* CodeStream::getDecompressContext(void)
+{
+	return m_decompressContext;
+}
 IBufferedStream* CodeStream::getStream()
 {
 	return m_stream;
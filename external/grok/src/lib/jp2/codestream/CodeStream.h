@@ -104,9 +104,14 @@ struct ICodeStreamCompress
 	virtual bool startCompress(void) = 0;
 	virtual bool compress(grk_plugin_tile* tile) = 0;
 	virtual bool compressTile(uint16_t tileIndex, uint8_t* p_data, uint64_t data_size) = 0;
+	virtual bool pushRows(const int32_t* const* data, const uint32_t* stride,
+						  uint32_t numRows) = 0;
 	virtual bool endCompress(void) = 0;
+	virtual void getCodecStats(grk_codec_stats* stats) = 0;
 };
 
+class DecompressContext;
+
 struct ICodeStreamDecompress
 {
   public:
@@ -116,8 +121,13 @@ struct ICodeStreamDecompress
 	virtual GrkImage* getImage(void) = 0;
 	virtual void initDecompress(grk_dparameters* p_param) = 0;
 	virtual bool setDecompressWindow(grkRectU32 window) = 0;
+	virtual bool setInterleavedOutput(uint8_t* buffer, uint64_t stride, uint8_t bitsPerSample) = 0;
 	virtual bool decompress(grk_plugin_tile* tile) = 0;
 	virtual bool decompressTile(uint16_t tileIndex) = 0;
+	virtual bool decompressRefine(uint16_t numLayers, uint8_t reduce) = 0;
+	virtual void getTileCacheStats(grk_tile_cache_stats* stats) = 0;
+	virtual void getCodecStats(grk_codec_stats* stats) = 0;
+	virtual void setDecompressContext(DecompressContext* context) = 0;
 	virtual bool endDecompress(void) = 0;
 	virtual void dump(uint32_t flag, FILE* outputFileStream) = 0;
 };
@@ -135,6 +145,8 @@ class CodeStream
 	GrkImage* getHeaderImage(void);
 	grk_plugin_tile* getCurrentPluginTile();
 	CodingParams* getCodingParams(void);
+	CodecStats* getStats(void);
+	DecompressContext* getDecompressContext(void);
 
   protected:
 	bool exec(std::vector<PROCEDURE_FUNC>& p_procedure_list);
@@ -150,6 +162,9 @@ class CodeStream
 	std::map<uint32_t, TileProcessor*> m_processors;
 	bool m_multiTile;
 	grk_plugin_tile* current_plugin_tile;
+	CodecStats m_stats;
+	// decompress state shared with other decompressors (reference is held)
+	DecompressContext* m_decompressContext;
 };
 
 /** @name Exported functions */
@@ -54,9 +54,19 @@ static j2k_prog_order j2k_prog_order_list[] = {{GRK_CPRL, "CPRL"}, {GRK_LRCP, "L
 											   {GRK_PCRL, "PCRL"}, {GRK_RLCP, "RLCP"},
 											   {GRK_RPCL, "RPCL"}, {(GRK_PROG_ORDER)-1, ""}};
 
-CodeStreamCompress::CodeStreamCompress(IBufferedStream* stream) : CodeStream(stream) {}
+CodeStreamCompress::CodeStreamCompress(IBufferedStream* stream)
+	: CodeStream(stream), m_stripRows(0), m_stripTileRow(0), m_stripSuccess(true)
+{}
 
-CodeStreamCompress::~CodeStreamCompress() {}
+CodeStreamCompress::~CodeStreamCompress()
+{
+	if(m_stripFuture.valid())
+		m_stripFuture.wait();
+	for(auto tileProcessor : m_stripPending)
+		delete tileProcessor;
+	for(auto tileProcessor : m_stripTiles)
+		delete tileProcessor;
+}
 char* CodeStreamCompress::convertProgressionOrder(GRK_PROG_ORDER prg_order)
 {
 	j2k_prog_order* po;
@@ -107,7 +117,12 @@ bool CodeStreamCompress::startCompress(void)
 		return false;
 
 	/* write header */
-	return exec(m_procedure_list);
+	StageTimer timer(getStats(), GRK_STAGE_MARKERS);
+	uint64_t headerStart = m_stream->tell();
+	bool rc = exec(m_procedure_list);
+	timer.addBytes(m_stream->tell() - headerStart);
+
+	return rc;
 }
 bool CodeStreamCompress::initCompress(grk_cparameters* parameters, GrkImage* image)
 {
@@ -602,23 +617,31 @@ bool CodeStreamCompress::compress(grk_plugin_tile* tile)
 				  numTiles, maxNumTilesJ2K);
 		return false;
 	}
-	auto pool_size = std::min<uint32_t>((uint32_t)ThreadPool::get()->num_threads(), numTiles);
-	ThreadPool pool(pool_size);
-	std::vector<std::future<int>> results;
+	// samples are only optional when they are pushed with compressTile or pushRows
+	for(uint16_t compno = 0; compno < m_headerImage->numcomps; ++compno)
+	{
+		if(!m_headerImage->comps[compno].data)
+		{
+			GRK_ERROR("Image component %u has no data", compno);
+			return false;
+		}
+	}
+	auto numThreads = std::min<uint32_t>(ExecSingleton::numThreads(), numTiles);
+	tf::Taskflow flow;
 	std::atomic<bool> success(true);
 	bool rc = false;
-	if(pool_size > 1)
+	if(numThreads > 1)
 	{
 		for(uint16_t i = 0; i < numTiles; ++i)
 		{
 			uint16_t tileIndex = i;
-			results.emplace_back(pool.enqueue([this, tile, tileIndex, &heap, &success] {
+			flow.emplace([this, tile, tileIndex, &heap, &success] {
 				if(success)
 				{
 					auto tileProcessor = new TileProcessor(this, m_stream, true, false);
 					tileProcessor->m_tileIndex = tileIndex;
 					tileProcessor->current_plugin_tile = tile;
-					if(!tileProcessor->preCompressTile())
+					if(!tileProcessor->preCompressTile(true))
 						success = false;
 					else
 					{
@@ -627,10 +650,12 @@ bool CodeStreamCompress::compress(grk_plugin_tile* tile)
 					}
 					if(success)
 						heap.push(tileProcessor);
+					else
+						delete tileProcessor;
 				}
-				return 0;
-			}));
+			});
 		}
+		ExecSingleton::get()->run(flow).wait();
 	}
 	else
 	{
@@ -639,7 +664,7 @@ bool CodeStreamCompress::compress(grk_plugin_tile* tile)
 			auto tileProcessor = new TileProcessor(this, m_stream, true, false);
 			tileProcessor->m_tileIndex = i;
 			tileProcessor->current_plugin_tile = tile;
-			if(!tileProcessor->preCompressTile())
+			if(!tileProcessor->preCompressTile(true))
 			{
 				delete tileProcessor;
 				goto cleanup;
@@ -655,15 +680,8 @@ bool CodeStreamCompress::compress(grk_plugin_tile* tile)
 				goto cleanup;
 		}
 	}
-	if(pool_size > 1)
-	{
-		for(auto& result : results)
-		{
-			result.get();
-		}
-		if(!success)
-			goto cleanup;
-	}
+	if(numThreads > 1 && !success)
+		goto cleanup;
 	rc = true;
 cleanup:
 	auto completeTileProcessor = heap.pop();
@@ -689,7 +707,7 @@ bool CodeStreamCompress::compressTile(uint16_t tileIndex, uint8_t* p_data,
 	auto currentTileProcessor = new TileProcessor(this, m_stream, true, false);
 	currentTileProcessor->m_tileIndex = tileIndex;
 
-	if(!currentTileProcessor->preCompressTile())
+	if(!currentTileProcessor->preCompressTile(false))
 	{
 		GRK_ERROR("Error while preCompressTile with tile index = %u", tileIndex);
 		goto cleanup;
@@ -713,8 +731,130 @@ cleanup:
 
 	return rc;
 }
+bool CodeStreamCompress::pushRows(const int32_t* const* data, const uint32_t* stride,
+								  uint32_t numRows)
+{
+	if(!data || !stride || !numRows)
+		return false;
+	auto image = m_headerImage;
+	for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		if(comp->dx != 1 || comp->dy != 1)
+		{
+			GRK_ERROR("Strip compression does not support subsampled components");
+			return false;
+		}
+		if(!data[compno] || stride[compno] < comp->w)
+		{
+			GRK_ERROR("Invalid strip buffer for component %u", compno);
+			return false;
+		}
+	}
+	uint32_t height = image->y1 - image->y0;
+	if(numRows > height - m_stripRows)
+	{
+		GRK_ERROR("Strip of %u rows starting at row %u extends beyond image height %u", numRows,
+				  m_stripRows, height);
+		return false;
+	}
+	uint32_t stripY0 = image->y0 + m_stripRows;
+	uint32_t stripY1 = stripY0 + numRows;
+	uint32_t y = stripY0;
+	while(y < stripY1)
+	{
+		if(m_stripTiles.empty() && !startTileRow())
+			return false;
+		uint32_t tileRowY1 = m_stripTiles.front()->tile->y1;
+		for(auto tileProcessor : m_stripTiles)
+			tileProcessor->ingestRows(data, stride, stripY0, numRows);
+		y = std::min<uint32_t>(stripY1, tileRowY1);
+		m_stripRows = y - image->y0;
+		if(y == tileRowY1 && !compressTileRow())
+			return false;
+	}
+
+	return true;
+}
+bool CodeStreamCompress::startTileRow(void)
+{
+	uint16_t tileIndex = (uint16_t)(m_stripTileRow * m_cp.t_grid_width);
+	for(uint16_t i = 0; i < m_cp.t_grid_width; ++i)
+	{
+		auto tileProcessor = new TileProcessor(this, m_stream, true, false);
+		tileProcessor->m_tileIndex = (uint16_t)(tileIndex + i);
+		m_stripTiles.push_back(tileProcessor);
+		if(!tileProcessor->preCompressTile(false))
+		{
+			GRK_ERROR("Error while preCompressTile with tile index = %u",
+					  tileProcessor->m_tileIndex);
+			return false;
+		}
+	}
+	m_stripTileRow++;
+
+	return true;
+}
+bool CodeStreamCompress::compressTileRow(void)
+{
+	// only one tile row is compressed at a time, so that tile parts
+	// are written to the stream in order
+	if(!waitForTileRow())
+		return false;
+	m_stripPending = std::move(m_stripTiles);
+	m_stripTiles.clear();
+	m_stripFuture = ExecSingleton::get()->async([this] { m_stripSuccess = writeTileRow(); });
+
+	return true;
+}
+bool CodeStreamCompress::writeTileRow(void)
+{
+	std::atomic<bool> success(true);
+	ExecSingleton::forkJoin((uint32_t)m_stripPending.size(), [this, &success](uint32_t index) {
+		if(success && !m_stripPending[index]->doCompress())
+			success = false;
+	});
+	if(!success)
+		return false;
+	for(auto tileProcessor : m_stripPending)
+	{
+		if(!writeTileParts(tileProcessor))
+			return false;
+	}
+	for(auto tileProcessor : m_stripPending)
+		delete tileProcessor;
+	m_stripPending.clear();
+
+	return true;
+}
+bool CodeStreamCompress::waitForTileRow(void)
+{
+	if(!m_stripFuture.valid())
+		return true;
+	m_stripFuture.get();
+	for(auto tileProcessor : m_stripPending)
+		delete tileProcessor;
+	m_stripPending.clear();
+
+	return m_stripSuccess;
+}
+void CodeStreamCompress::getCodecStats(grk_codec_stats* stats)
+{
+	m_stats.copyTo(stats);
+}
 bool CodeStreamCompress::endCompress(void)
 {
+	if(m_stripRows)
+	{
+		if(!waitForTileRow())
+			return false;
+		uint32_t height = m_headerImage->y1 - m_headerImage->y0;
+		if(m_stripRows != height)
+		{
+			GRK_ERROR("Only %u of %u image rows were pushed", m_stripRows, height);
+			return false;
+		}
+	}
 	/* customization of the compressing */
 	m_procedure_list.push_back(std::bind(&CodeStreamCompress::write_eoc, this));
 	if(m_cp.m_coding_params.m_enc.writeTLM)
@@ -38,9 +38,15 @@ class CodeStreamCompress : public CodeStream, public ICodeStreamCompress
 	bool initCompress(grk_cparameters* p_param, GrkImage* p_image);
 	bool compress(grk_plugin_tile* tile);
 	bool compressTile(uint16_t tileIndex, uint8_t* p_data, uint64_t data_size);
+	bool pushRows(const int32_t* const* data, const uint32_t* stride, uint32_t numRows);
 	bool endCompress(void);
+	void getCodecStats(grk_codec_stats* stats);
 
   private:
+	bool startTileRow(void);
+	bool compressTileRow(void);
+	bool writeTileRow(void);
+	bool waitForTileRow(void);
 	bool init_header_writing(void);
 	bool get_end_header(void);
 	bool writeTilePart(TileProcessor* tileProcessor);
@@ -313,6 +319,17 @@ class CodeStreamCompress : public CodeStream, public ICodeStreamCompress
 	bool init_mct_encoding(TileCodingParams* p_tcp, GrkImage* p_image);
 
 	CompressorState m_compressorState;
+
+	// strip compression: number of image rows pushed so far
+	uint32_t m_stripRows;
+	// index of next tile row to start
+	uint16_t m_stripTileRow;
+	// tile row currently receiving pushed rows
+	std::vector<TileProcessor*> m_stripTiles;
+	// previous tile row, compressed and written while the current row is filled
+	std::vector<TileProcessor*> m_stripPending;
+	tf::Future<void> m_stripFuture;
+	bool m_stripSuccess;
 };
 
 } // namespace grk
@@ -66,7 +66,7 @@ static const j2k_mct_function j2k_mct_read_functions_to_int32[] = {
 CodeStreamDecompress::CodeStreamDecompress(IBufferedStream* stream)
 	: CodeStream(stream), wholeTileDecompress(true), m_curr_marker(0), m_headerError(false),
 	  m_tile_ind_to_dec(-1), m_marker_scratch(nullptr), m_marker_scratch_size(0),
-	  m_output_image(nullptr), m_tileCache(new TileCache())
+	  m_output_image(nullptr), m_tileCache(new TileCache()), m_decompressWindow(0, 0, 0, 0)
 {
 	m_decompressorState.m_default_tcp = new TileCodingParams();
 	m_decompressorState.lastSotReadPosition = 0;
@@ -154,6 +154,57 @@ GrkImage* CodeStreamDecompress::getCompositeImage()
 {
 	return m_tileCache->getComposite();
 }
+TileCache* CodeStreamDecompress::getTileCache(void)
+{
+	return m_tileCache;
+}
+void CodeStreamDecompress::getTileCacheStats(grk_tile_cache_stats* stats)
+{
+	m_tileCache->getStats(stats);
+}
+void CodeStreamDecompress::getCodecStats(grk_codec_stats* stats)
+{
+	m_stats.copyTo(stats);
+}
+void CodeStreamDecompress::setDecompressContext(DecompressContext* context)
+{
+	if(context)
+		grk_object_ref(context->getWrapper());
+	if(m_decompressContext)
+		grk_object_unref(m_decompressContext->getWrapper());
+	m_decompressContext = context;
+}
+/**
+ * Re-create output image from composite image header, so that it
+ * tracks the current decompress window
+ */
+void CodeStreamDecompress::resetOutputImage(void)
+{
+	if(m_output_image)
+		grk_object_unref(&m_output_image->obj);
+	m_output_image = new GrkImage();
+	getCompositeImage()->copyHeader(m_output_image);
+}
+grkRectU32 CodeStreamDecompress::getUnreducedTileWindow(uint16_t tileIndex)
+{
+	auto compositeImage = getCompositeImage();
+	auto tileBounds = m_cp.getTileBounds(m_headerImage, tileIndex % m_cp.t_grid_width,
+										 tileIndex / m_cp.t_grid_width);
+
+	return grkRectU32(compositeImage->x0, compositeImage->y0, compositeImage->x1,
+					  compositeImage->y1)
+		.intersection(tileBounds);
+}
+bool CodeStreamDecompress::isTileInWindow(uint16_t tileIndex)
+{
+	uint32_t tile_x = tileIndex % m_cp.t_grid_width;
+	uint32_t tile_y = tileIndex / m_cp.t_grid_width;
+
+	return tile_x >= m_decompressorState.m_start_tile_x_index &&
+		   tile_x < m_decompressorState.m_end_tile_x_index &&
+		   tile_y >= m_decompressorState.m_start_tile_y_index &&
+		   tile_y < m_decompressorState.m_end_tile_y_index;
+}
 TileProcessor* CodeStreamDecompress::allocateProcessor(uint16_t tileIndex)
 {
 	auto tileCache = m_tileCache->get(tileIndex);
@@ -201,7 +252,7 @@ DecompressorState* CodeStreamDecompress::getDecompressorState(void)
 GrkImage* CodeStreamDecompress::getImage(uint16_t tileIndex)
 {
 	auto entry = m_tileCache->get(tileIndex);
-	return entry ? entry->processor->getImage() : nullptr;
+	return entry && entry->processor ? entry->processor->getImage() : nullptr;
 }
 std::vector<GrkImage*> CodeStreamDecompress::getAllImages(void)
 {
@@ -235,11 +286,14 @@ bool CodeStreamDecompress::readHeader(grk_header_info* header_info)
 		m_procedure_list.push_back(std::bind(&CodeStreamDecompress::copy_default_tcp, this));
 
 		/* read header */
+		StageTimer timer(getStats(), GRK_STAGE_MARKERS);
+		uint64_t headerStart = m_stream->tell();
 		if(!exec(m_procedure_list))
 		{
 			m_headerError = true;
 			return false;
 		}
+		timer.addBytes(m_stream->tell() - headerStart);
 
 		/* Copy code stream image information to composite image */
 		m_headerImage->copyHeader(getCompositeImage());
@@ -299,7 +353,9 @@ bool CodeStreamDecompress::setDecompressWindow(grkRectU32 window)
 	auto decompressor = &m_decompressorState;
 
 	/* Check if we have read the main header */
-	if(decompressor->getState() != J2K_DEC_STATE_TPH_SOT)
+	// (a caching decompressor may also change the window once all tiles have been read)
+	if(decompressor->getState() != J2K_DEC_STATE_TPH_SOT &&
+	   !(m_tileCache->isCaching() && endOfCodeStream()))
 	{
 		GRK_ERROR("Need to read the main header before setting decompress window");
 		return false;
@@ -311,6 +367,18 @@ bool CodeStreamDecompress::setDecompressWindow(grkRectU32 window)
 		decompressor->m_start_tile_y_index = 0;
 		decompressor->m_end_tile_x_index = cp->t_grid_width;
 		decompressor->m_end_tile_y_index = cp->t_grid_height;
+		m_decompressWindow = grkRectU32(0, 0, 0, 0);
+		if(m_tileCache->isCaching())
+		{
+			// restore full image bounds, in case an earlier window was set
+			wholeTileDecompress = true;
+			compositeImage->x0 = image->x0;
+			compositeImage->y0 = image->y0;
+			compositeImage->x1 = image->x1;
+			compositeImage->y1 = image->y1;
+			if(!compositeImage->subsampleAndReduce(cp->m_coding_params.m_dec.m_reduce))
+				return false;
+		}
 		return true;
 	}
 
@@ -386,6 +454,8 @@ bool CodeStreamDecompress::setDecompressWindow(grkRectU32 window)
 		compositeImage->y1 = end_y;
 	}
 	wholeTileDecompress = false;
+	m_decompressWindow =
+		grkRectU32(compositeImage->x0, compositeImage->y0, compositeImage->x1, compositeImage->y1);
 	if(!compositeImage->subsampleAndReduce(cp->m_coding_params.m_dec.m_reduce))
 		return false;
 
@@ -395,6 +465,70 @@ bool CodeStreamDecompress::setDecompressWindow(grkRectU32 window)
 
 	return true;
 }
+bool CodeStreamDecompress::setInterleavedOutput(uint8_t* buffer, uint64_t stride,
+												 uint8_t bitsPerSample)
+{
+	if(!buffer)
+	{
+		m_interleaved = InterleavedBuffer();
+		return true;
+	}
+	auto image = m_headerImage;
+	if(!image)
+	{
+		GRK_ERROR("Need to read the main header before setting interleaved output");
+		return false;
+	}
+	if(bitsPerSample != 8 && bitsPerSample != 16)
+	{
+		GRK_ERROR("Interleaved output: %u bits per sample is not supported", bitsPerSample);
+		return false;
+	}
+	for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		if(comp->sgnd || comp->prec > bitsPerSample)
+		{
+			GRK_ERROR("Interleaved output: component %u (precision %u, %s) does not fit in "
+					  "%u bit unsigned samples",
+					  compno, comp->prec, comp->sgnd ? "signed" : "unsigned", bitsPerSample);
+			return false;
+		}
+		if(comp->dx != image->comps->dx || comp->dy != image->comps->dy)
+		{
+			GRK_ERROR("Interleaved output: component %u sub-sampling differs from component 0",
+					  compno);
+			return false;
+		}
+	}
+	m_interleaved.data = buffer;
+	m_interleaved.stride = stride;
+	m_interleaved.bitsPerSample = bitsPerSample;
+
+	return true;
+}
+/**
+ * Interleaved output covers the composite image, which is only
+ * known once window and resolution reduction are set
+ */
+bool CodeStreamDecompress::prepareInterleavedOutput(void)
+{
+	if(!m_interleaved.active())
+		return true;
+	auto compositeImage = getCompositeImage();
+	auto comp = compositeImage->comps;
+	m_interleaved.bounds = grkRectU32(comp->x0, comp->y0, comp->x0 + comp->w, comp->y0 + comp->h);
+	uint64_t rowBytes =
+		(uint64_t)comp->w * compositeImage->numcomps * (m_interleaved.bitsPerSample / 8U);
+	if(m_interleaved.stride < rowBytes)
+	{
+		GRK_ERROR("Interleaved output: stride %" PRIu64 " is less than row size %" PRIu64,
+				  m_interleaved.stride, rowBytes);
+		return false;
+	}
+
+	return true;
+}
 void CodeStreamDecompress::initDecompress(grk_dparameters* parameters)
 {
 	if(parameters)
@@ -402,20 +536,68 @@ void CodeStreamDecompress::initDecompress(grk_dparameters* parameters)
 		m_cp.m_coding_params.m_dec.m_layer = parameters->cp_layer;
 		m_cp.m_coding_params.m_dec.m_reduce = parameters->cp_reduce;
 		m_tileCache->setStrategy(parameters->tileCacheStrategy);
+		m_tileCache->setMaxBytes(parameters->tileCacheMaxBytes);
 	}
 }
 bool CodeStreamDecompress::decompress(grk_plugin_tile* tile)
 {
 	/* customization of the decoding */
-	m_procedure_list.push_back(std::bind(&CodeStreamDecompress::decompressTiles, this));
+	m_procedure_list.push_back(std::bind(&CodeStreamDecompress::decompressTiles, this, false));
 	current_plugin_tile = tile;
 
 	return decompressExec();
 }
+bool CodeStreamDecompress::decompressRefine(uint16_t numLayers, uint8_t reduce)
+{
+	if(!endOfCodeStream() || m_tileCache->empty())
+	{
+		GRK_ERROR("Refine: code stream must first be fully decompressed");
+		return false;
+	}
+	// packed packet headers are consumed from the main and tile headers,
+	// so they can't be read again
+	if(m_cp.ppm_marker)
+	{
+		GRK_ERROR("Refine: PPM marker is not supported");
+		return false;
+	}
+	uint16_t numTiles = (uint16_t)(m_cp.t_grid_width * m_cp.t_grid_height);
+	for(uint16_t i = 0; i < numTiles; ++i)
+	{
+		auto tcp = m_cp.tcps + i;
+		if(tcp->ppt)
+		{
+			GRK_ERROR("Refine: PPT marker is not supported");
+			return false;
+		}
+		for(uint16_t compno = 0; compno < getHeaderImage()->numcomps; ++compno)
+		{
+			if(reduce >= tcp->tccps[compno].numresolutions)
+			{
+				GRK_ERROR("Refine: reduce %u must be less than number of resolutions %u", reduce,
+						  tcp->tccps[compno].numresolutions);
+				return false;
+			}
+		}
+	}
+	m_cp.m_coding_params.m_dec.m_layer = numLayers;
+	m_cp.m_coding_params.m_dec.m_reduce = reduce;
+	for(uint16_t i = 0; i < numTiles; ++i)
+	{
+		auto tcp = m_cp.tcps + i;
+		tcp->numLayersToDecompress =
+			numLayers ? std::min<uint16_t>(numLayers, tcp->numlayers) : tcp->numlayers;
+	}
+	if(!getCompositeImage()->subsampleAndReduce(reduce))
+		return false;
+	m_procedure_list.push_back(std::bind(&CodeStreamDecompress::decompressTiles, this, true));
+
+	return decompressExec();
+}
 bool CodeStreamDecompress::decompressTile(uint16_t tileIndex)
 {
 	auto entry = m_tileCache->get(tileIndex);
-	if(entry && entry->processor && entry->processor->getImage())
+	if(!m_tileCache->isCaching() && entry && entry->processor && entry->processor->getImage())
 		return true;
 
 	// another tile has already been decoded
@@ -423,6 +605,15 @@ bool CodeStreamDecompress::decompressTile(uint16_t tileIndex)
 	{
 		/* Copy code stream image information to composite image */
 		m_headerImage->copyHeader(getCompositeImage());
+		// a caching decompressor keeps the window across tiles
+		if(m_tileCache->isCaching() && m_decompressWindow.non_empty())
+		{
+			auto compositeImage = getCompositeImage();
+			compositeImage->x0 = m_decompressWindow.x0;
+			compositeImage->y0 = m_decompressWindow.y0;
+			compositeImage->x1 = m_decompressWindow.x1;
+			compositeImage->y1 = m_decompressWindow.y1;
+		}
 	}
 
 	uint16_t numTilesToDecompress = (uint16_t)(m_cp.t_grid_width * m_cp.t_grid_height);
@@ -495,10 +686,20 @@ bool CodeStreamDecompress::endOfCodeStream(void)
 	return m_decompressorState.getState() == J2K_DEC_STATE_EOC ||
 		   m_decompressorState.getState() == J2K_DEC_STATE_NO_EOC || m_stream->numBytesLeft() == 0;
 }
-bool CodeStreamDecompress::decompressTiles(void)
+bool CodeStreamDecompress::decompressTiles(bool refine)
 {
 	uint16_t numTilesToDecompress = (uint16_t)(m_cp.t_grid_height * m_cp.t_grid_width);
-	m_multiTile = numTilesToDecompress > 1;
+	// cached tiles are always composited from their own images
+	m_multiTile = numTilesToDecompress > 1 || m_tileCache->isCaching();
+	std::vector<uint16_t> tilesInWindow;
+	for(uint16_t i = 0; i < numTilesToDecompress; ++i)
+	{
+		if(isTileInWindow(i))
+			tilesInWindow.push_back(i);
+	}
+	m_tileCache->beginDecompress(tilesInWindow);
+	if(m_output_image)
+		resetOutputImage();
 	if(codeStreamInfo)
 	{
 		if(!codeStreamInfo->allocTileInfo(numTilesToDecompress))
@@ -507,13 +708,97 @@ bool CodeStreamDecompress::decompressTiles(void)
 			return false;
 		}
 	}
-	std::vector<std::future<int>> results;
 	std::atomic<bool> success(true);
 	std::atomic<uint32_t> numTilesDecompressed(0);
-	ThreadPool pool(
-		std::min<uint32_t>((uint32_t)ThreadPool::get()->num_threads(), numTilesToDecompress));
 	bool breakAfterT1 = false;
 	bool canDecompress = true;
+	// each tile is decompressed as an independent task graph on the shared executor,
+	// while the semaphore bounds the number of tiles in flight, and hence memory usage
+	uint32_t numThreads = ExecSingleton::numThreads();
+	tf::Semaphore tileLimit((int)numThreads);
+	std::list<tf::Taskflow> flows;
+	std::vector<tf::Future<void>> results;
+	auto reduce = m_cp.m_coding_params.m_dec.m_reduce;
+	auto layers = m_cp.m_coding_params.m_dec.m_layer;
+	auto exec = [this, numTilesToDecompress, numThreads, reduce, layers, refine,
+				 &numTilesDecompressed, &success, &tileLimit, &flows,
+				 &results](TileProcessor* processor, bool reuse) {
+		if(!isTileInWindow(processor->m_tileIndex))
+			return;
+		// cached images are not written to interleaved output
+		if(!m_interleaved.active() &&
+		   m_tileCache->lookup(processor->m_tileIndex,
+							   getUnreducedTileWindow(processor->m_tileIndex), reduce, layers))
+		{
+			numTilesDecompressed++;
+			return;
+		}
+		processor->refining = refine;
+		if(reuse && !(refine ? refineProcessor(processor) : reuseProcessor(processor)))
+		{
+			success = false;
+			return;
+		}
+		auto tcp = m_cp.tcps + processor->m_tileIndex;
+		if(!tcp->m_compressedTileData)
+		{
+			GRK_ERROR("Decompress: Tile %d has no compressed data", processor->m_tileIndex);
+			GRK_ERROR("Failed to decompress tile %u/%u", processor->m_tileIndex,
+					  numTilesToDecompress);
+			success = false;
+			return;
+		}
+		bool doPost =
+			!current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_POST_T1);
+		processor->interleavedOutput = m_interleaved.active() ? &m_interleaved : nullptr;
+		flows.emplace_back();
+		auto& flow = flows.back();
+		auto decompress = flow.emplace([this, processor, tcp, doPost, &success](tf::Subflow& sf) {
+			if(success)
+				processor->emplaceDecompressT2T1(sf, tcp, m_output_image, m_multiTile, doPost);
+		});
+		decompress.acquire(tileLimit);
+		decompress.release(tileLimit);
+		auto complete = flow.emplace(
+			[this, processor, numTilesToDecompress, reduce, layers, &numTilesDecompressed,
+			 &success] {
+				if(!success)
+					return;
+				if(!processor->getDecompressResult())
+				{
+					m_decompressorState.orState(J2K_DEC_STATE_ERR);
+					GRK_ERROR("Failed to decompress tile %u/%u", processor->m_tileIndex,
+							  numTilesToDecompress);
+					success = false;
+				}
+				else
+				{
+					m_tileCache->add(processor->m_tileIndex, processor->getUnreducedTileWindow(),
+									 reduce, layers);
+					numTilesDecompressed++;
+				}
+			});
+		decompress.precede(complete);
+		// inside an executor task (e.g. batch decompression), tiles are run
+		// cooperatively, one at a time
+		if(ExecSingleton::threadId() < numThreads)
+		{
+			ExecSingleton::run(flow);
+			return;
+		}
+		results.push_back(ExecSingleton::get()->run(flow));
+		if(numThreads == 1)
+			results.back().wait();
+	};
+	if(m_tileCache->isCaching())
+	{
+		// tiles read by an earlier decompress are skipped when parsing,
+		// as their data is still held
+		m_tile_ind_to_dec = -1;
+		m_tileDataRead.assign(numTilesToDecompress, false);
+		for(uint16_t i = 0; i < numTilesToDecompress; ++i)
+			m_tileDataRead[i] = m_cp.tcps[i].m_compressedTileData != nullptr;
+	}
 	if(endOfCodeStream())
 	{
 		if(m_tileCache->empty())
@@ -521,47 +806,45 @@ bool CodeStreamDecompress::decompressTiles(void)
 			GRK_ERROR("No tiles were decompressed.");
 			return false;
 		}
+		// tiles outside of earlier windows, or evicted from the cache,
+		// must be read again from the code stream
+		bool reread = false;
 		for(uint16_t i = 0; i < numTilesToDecompress; ++i)
 		{
+			if(!isTileInWindow(i))
+				continue;
 			auto entry = m_tileCache->get(i);
-			if(!entry || !entry->processor)
+			if(!entry || !entry->processor || !m_cp.tcps[i].m_compressedTileData)
+			{
+				reread = true;
 				continue;
-			auto processor = entry->processor;
-			auto exec = [this, processor, numTilesToDecompress, &numTilesDecompressed, &success] {
-				if(success)
-				{
-					if(!decompressT2T1(processor))
-					{
-						GRK_ERROR("Failed to decompress tile %u/%u", processor->m_tileIndex,
-								  numTilesToDecompress);
-						success = false;
-					}
-					else
-					{
-						numTilesDecompressed++;
-					}
-				}
-				return 0;
-			};
-			if(pool.num_threads() > 1)
-				results.emplace_back(pool.enqueue(exec));
-			else
+			}
+			exec(entry->processor, true);
+			if(numThreads == 1 && !success)
+				goto cleanup;
+		}
+		if(!reread)
+		{
+			for(auto& result : results)
 			{
-				exec();
-				if(!success)
-					goto cleanup;
+				result.wait();
 			}
+			results.clear();
+			if(!success)
+				return false;
+
+			return true;
 		}
-		for(auto& result : results)
+		if(!rewindToFirstTilePart())
 		{
-			result.get();
+			success = false;
+			goto cleanup;
 		}
-		results.clear();
-		if(!success)
-			return false;
-
-		return true;
 	}
+	// tile data is read ahead while earlier tiles are decompressed;
+	// stream is positioned just after the SOT marker id of the next tile part
+	if(m_stream->tell() >= 2)
+		prefetchTileParts(m_stream->tell() - 2);
 	while(!endOfCodeStream() && !breakAfterT1)
 	{
 		// 1. read header
@@ -606,36 +889,13 @@ bool CodeStreamDecompress::decompressTiles(void)
 			breakAfterT1 = true;
 		}
 		// 3. T2 + T1 decompress
-		// once we schedule a processor for T1 compression, we will destroy it
-		// regardless of success or not
-		auto exec = [this, processor, numTilesToDecompress, &numTilesDecompressed, &success] {
-			if(success)
-			{
-				if(!decompressT2T1(processor))
-				{
-					GRK_ERROR("Failed to decompress tile %u/%u", processor->m_tileIndex,
-							  numTilesToDecompress);
-					success = false;
-				}
-				else
-				{
-					numTilesDecompressed++;
-				}
-			}
-			return 0;
-		};
-		if(pool.num_threads() > 1)
-			results.emplace_back(pool.enqueue(exec));
-		else
-		{
-			exec();
-			if(!success)
-				goto cleanup;
-		}
+		exec(processor, false);
+		if(numThreads == 1 && !success)
+			goto cleanup;
 	}
 	for(auto& result : results)
 	{
-		result.get();
+		result.wait();
 	}
 	results.clear();
 	if(!success)
@@ -681,10 +941,47 @@ bool CodeStreamDecompress::decompressTiles(void)
 cleanup:
 	for(auto& result : results)
 	{
-		result.get();
+		result.wait();
 	}
 	return success;
 }
+/**
+ * Rewind stream to first SOT marker, once end of code stream has been reached,
+ * so that tiles can be read again
+ */
+bool CodeStreamDecompress::rewindToFirstTilePart(void)
+{
+	uint16_t numTiles = (uint16_t)(m_cp.t_grid_width * m_cp.t_grid_height);
+	for(uint16_t i = 0; i < numTiles; ++i)
+		m_cp.tcps[i].m_tilePartIndex = -1;
+	m_currentTileProcessor = nullptr;
+	if(!m_stream->seek(codeStreamInfo->getMainHeaderEnd()))
+	{
+		GRK_ERROR("Problem with seek function");
+		return false;
+	}
+	m_decompressorState.setState(J2K_DEC_STATE_TPH_SOT);
+	m_decompressorState.lastTilePartInCodeStream = false;
+	m_decompressorState.lastTilePartWasRead = false;
+	m_decompressorState.skipTileData = false;
+	try
+	{
+		if(!readMarker())
+			return false;
+	}
+	catch(InvalidMarkerException& ime)
+	{
+		GRK_ERROR("Found invalid marker : 0x%x", ime.m_marker);
+		return false;
+	}
+	if(m_curr_marker != J2K_MS_SOT)
+	{
+		GRK_ERROR("Expected SOT marker at end of main header, but found 0x%x", m_curr_marker);
+		return false;
+	}
+
+	return true;
+}
 bool CodeStreamDecompress::copy_default_tcp(void)
 {
 	auto image = m_headerImage;
@@ -720,6 +1017,10 @@ int32_t CodeStreamDecompress::tileIndexToDecode()
 {
 	return m_tile_ind_to_dec;
 }
+bool CodeStreamDecompress::tileDataWasRead(uint16_t tileIndex)
+{
+	return tileIndex < m_tileDataRead.size() && m_tileDataRead[tileIndex];
+}
 bool CodeStreamDecompress::readHeaderProcedure(void)
 {
 	bool rc = false;
@@ -854,17 +1155,29 @@ bool CodeStreamDecompress::readHeaderProcedureImpl(void)
 }
 bool CodeStreamDecompress::decompressExec(void)
 {
+	if(!prepareInterleavedOutput())
+	{
+		m_procedure_list.clear();
+		return false;
+	}
 	if(!exec(m_procedure_list))
 		return false;
-	if(m_multiTile)
+	// images of current decompress are pinned, so only tiles
+	// left over from earlier decompresses are evicted
+	m_currentTileProcessor = nullptr;
+	m_tileCache->evict(!m_cp.ppm_marker);
+	// tiles have already been written to interleaved output
+	if(m_multiTile && !m_interleaved.active())
 	{
 		if(!m_output_image->allocData())
 			return false;
+		StageTimer timer(getStats(), GRK_STAGE_COMPOSITE);
 		auto images = m_tileCache->getTileImages();
 		for(auto& img : images)
 		{
 			if(!m_output_image->compositeFrom(img))
 				return false;
+			timer.addBytes(img->dataBytes());
 		}
 	}
 	m_output_image->transferDataTo(getCompositeImage());
@@ -876,17 +1189,37 @@ bool CodeStreamDecompress::decompressExec(void)
  */
 bool CodeStreamDecompress::decompressTile()
 {
-	m_multiTile = false;
+	// cached tile is composited from its own image
+	m_multiTile = m_tileCache->isCaching();
 	if(tileIndexToDecode() == -1)
 	{
 		GRK_ERROR("j2k_decompress_tile: Unable to decompress tile "
 				  "since first tile SOT has not been detected");
 		return false;
 	}
-	auto tileCache = m_tileCache->get((uint16_t)tileIndexToDecode());
+	auto tileIndex = (uint16_t)tileIndexToDecode();
+	auto tileCache = m_tileCache->get(tileIndex);
 	auto tileProcessor = tileCache ? tileCache->processor : nullptr;
 	bool rc = false;
-	if(!tileCache || !tileCache->processor->getImage())
+	if(m_tileCache->isCaching())
+	{
+		m_tileCache->beginDecompress({tileIndex});
+		resetOutputImage();
+		auto window = getUnreducedTileWindow(tileIndex);
+		auto reduce = m_cp.m_coding_params.m_dec.m_reduce;
+		auto layers = m_cp.m_coding_params.m_dec.m_layer;
+		if(!m_interleaved.active() && m_tileCache->lookup(tileIndex, window, reduce, layers))
+			return true;
+		// tile data has already been read by an earlier decompress
+		if(tileProcessor && m_cp.tcps[tileIndex].m_compressedTileData)
+		{
+			if(!reuseProcessor(tileProcessor) || !decompressT2T1(tileProcessor))
+				return false;
+			m_tileCache->add(tileIndex, tileProcessor->getUnreducedTileWindow(), reduce, layers);
+			return true;
+		}
+	}
+	if(m_tileCache->isCaching() || !tileCache || !tileCache->processor->getImage())
 	{
 		// if we have a TLM marker, then we can skip tiles until
 		// we get to desired tile
@@ -894,8 +1227,11 @@ bool CodeStreamDecompress::decompressTile()
 		{
 			// for first SOT position, we add two to skip SOC marker
 			if(!m_cp.tlm_markers->skipTo((uint16_t)m_tile_ind_to_dec, m_stream,
-										 codeStreamInfo->getMainHeaderEnd() + 2))
+										 codeStreamInfo->getMainHeaderEnd() + 2,
+										 m_cp.plm_markers))
 				return false;
+			// skipTo seeks to just after the SOT marker id of the tile's first tile part
+			prefetchTileParts(m_stream->tell() - 2);
 		}
 		else
 		{
@@ -935,12 +1271,49 @@ bool CodeStreamDecompress::decompressTile()
 		}
 		if(!decompressT2T1(tileProcessor))
 			goto cleanup;
+		m_tileCache->add(tileIndex, tileProcessor->getUnreducedTileWindow(),
+						 m_cp.m_coding_params.m_dec.m_reduce, m_cp.m_coding_params.m_dec.m_layer);
 	}
 	rc = true;
 cleanup:
 
 	return rc;
 }
+/**
+ * Prepare processor, whose tile data was read by an earlier decompress,
+ * for decompression with the current window and resolution reduction
+ */
+bool CodeStreamDecompress::reuseProcessor(TileProcessor* tileProcessor)
+{
+	tileProcessor->wholeTileDecompress = wholeTileDecompress;
+	if(!tileProcessor->init())
+	{
+		GRK_ERROR("Cannot decompress tile %u", tileProcessor->m_tileIndex);
+		return false;
+	}
+
+	return true;
+}
+/**
+ * Prepare processor, decompressed earlier with the current window,
+ * for decompression of additional layers and/or resolutions.
+ * Falls back to a full re-initialization if the window has changed,
+ * or if the earlier decompress skipped data of packets that are now needed.
+ */
+bool CodeStreamDecompress::refineProcessor(TileProcessor* tileProcessor)
+{
+	auto window = getUnreducedTileWindow(tileProcessor->m_tileIndex);
+	if(!(tileProcessor->getUnreducedTileWindow() == window) || tileProcessor->skippedPacketData)
+		return reuseProcessor(tileProcessor);
+	tileProcessor->wholeTileDecompress = wholeTileDecompress;
+	if(!tileProcessor->initRefine())
+	{
+		GRK_ERROR("Cannot refine tile %u", tileProcessor->m_tileIndex);
+		return false;
+	}
+
+	return true;
+}
 bool CodeStreamDecompress::decompressT2T1(TileProcessor* tileProcessor)
 {
 	auto tcp = m_cp.tcps + tileProcessor->m_tileIndex;
@@ -951,6 +1324,7 @@ bool CodeStreamDecompress::decompressT2T1(TileProcessor* tileProcessor)
 	}
 	bool doPost =
 		!current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_POST_T1);
+	tileProcessor->interleavedOutput = m_interleaved.active() ? &m_interleaved : nullptr;
 	if(!tileProcessor->decompressT2T1(tcp, m_output_image, m_multiTile, doPost))
 	{
 		m_decompressorState.orState(J2K_DEC_STATE_ERR);
@@ -984,6 +1358,45 @@ bool CodeStreamDecompress::findNextTile(TileProcessor* tileProcessor)
 	}
 	return rc;
 }
+/**
+ * Use TLM markers to read ahead all tile parts that will be parsed from the
+ * given SOT marker on: whole tile parts for tiles to be decompressed, and just
+ * the SOT marker segment for tile parts that will be skipped.
+ *
+ * @param currentSotPos	position of SOT marker of next tile part to be parsed
+ */
+void CodeStreamDecompress::prefetchTileParts(uint64_t currentSotPos)
+{
+	if(!m_cp.tlm_markers || !codeStreamInfo || !m_stream->supportsRangeRead())
+		return;
+	std::vector<TilePartPosition> tileParts;
+	m_cp.tlm_markers->getTilePartPositions(codeStreamInfo->getMainHeaderEnd(), tileParts);
+	uint32_t numTiles = m_cp.t_grid_width * m_cp.t_grid_height;
+	auto tileIndex = tileIndexToDecode();
+	std::vector<ByteRange> ranges;
+	uint64_t end = 0;
+	for(auto& tp : tileParts)
+	{
+		if(tp.tileIndex >= numTiles)
+		{
+			GRK_WARN("TLM marker has invalid tile index %u: tile parts will not be prefetched",
+					 tp.tileIndex);
+			return;
+		}
+		end = tp.position + tp.length;
+		if(tp.position < currentSotPos)
+			continue;
+		bool decompress = tileIndex == -1 ? isTileInWindow(tp.tileIndex) &&
+												!tileDataWasRead(tp.tileIndex)
+										  : tp.tileIndex == (uint16_t)tileIndex;
+		ranges.emplace_back(tp.position, decompress ? tp.length : sot_marker_segment_len);
+	}
+	if(ranges.empty())
+		return;
+	// EOC marker
+	ranges.emplace_back(end, 2);
+	m_stream->prefetch(ranges);
+}
 bool CodeStreamDecompress::decompressValidation(void)
 {
 	bool is_valid = true;
@@ -2325,6 +2738,7 @@ bool CodeStreamDecompress::endDecompress(void)
 }
 bool CodeStreamDecompress::parseTileHeaderMarkers(bool* canDecompress)
 {
+	StageTimer timer(getStats(), GRK_STAGE_MARKERS);
 	if(m_decompressorState.getState() == J2K_DEC_STATE_EOC)
 	{
 		m_curr_marker = J2K_MS_EOC;
@@ -2399,8 +2813,13 @@ bool CodeStreamDecompress::parseTileHeaderMarkers(bool* canDecompress)
 				uint64_t sot_pos = m_stream->tell() - marker_size - grk_marker_length;
 				if(sot_pos > m_decompressorState.lastSotReadPosition)
 					m_decompressorState.lastSotReadPosition = sot_pos;
+				m_currentTileProcessor->tilePartSotPosition = sot_pos;
 				if(m_decompressorState.skipTileData)
 				{
+					// keep PLM packet lengths in step with the tile parts
+					if(m_cp.plm_markers)
+						m_cp.plm_markers->skipTilePart(sot_pos,
+													   m_currentTileProcessor->tilePartDataLength);
 					if(!m_stream->skip(m_currentTileProcessor->tilePartDataLength))
 					{
 						GRK_ERROR("Stream too short");
@@ -48,16 +48,29 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	GrkImage* getImage(void);
 	std::vector<GrkImage*> getAllImages(void);
 	bool setDecompressWindow(grkRectU32 window);
+	bool setInterleavedOutput(uint8_t* buffer, uint64_t stride, uint8_t bitsPerSample);
 	bool decompress(grk_plugin_tile* tile);
 	bool decompressTile(uint16_t tileIndex);
+	bool decompressRefine(uint16_t numLayers, uint8_t reduce);
+	void getTileCacheStats(grk_tile_cache_stats* stats);
+	void getCodecStats(grk_codec_stats* stats);
+	void setDecompressContext(DecompressContext* context);
 	bool endDecompress(void);
 	void initDecompress(grk_dparameters* p_param);
 	CodeStreamInfo* getCodeStreamInfo(void);
 	GrkImage* getCompositeImage();
+	TileCache* getTileCache(void);
 	bool readMarker(void);
 	GrkImage* getHeaderImage(void);
 	uint16_t getCurrentMarker();
 	int32_t tileIndexToDecode();
+	/**
+	 * Check if tile data was read by an earlier decompress, so that the
+	 * tile can be skipped when the code stream is parsed again
+	 *
+	 * @param tileIndex tile index
+	 */
+	bool tileDataWasRead(uint16_t tileIndex);
 	bool isWholeTileDecompress();
 	void dump(uint32_t flag, FILE* outputFileStream);
 
@@ -91,9 +104,17 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	bool readHeaderProcedureImpl(void);
 	bool decompressExec();
 	bool decompressT2T1(TileProcessor* tileProcessor);
+	bool reuseProcessor(TileProcessor* tileProcessor);
+	bool refineProcessor(TileProcessor* tileProcessor);
+	void resetOutputImage(void);
+	bool prepareInterleavedOutput(void);
+	grkRectU32 getUnreducedTileWindow(uint16_t tileIndex);
+	bool isTileInWindow(uint16_t tileIndex);
 	bool decompressTile();
 	bool findNextTile(TileProcessor* tileProcessor);
-	bool decompressTiles(void);
+	void prefetchTileParts(uint64_t currentSotPos);
+	bool decompressTiles(bool refine);
+	bool rewindToFirstTilePart(void);
 	bool decompressValidation(void);
 	bool copy_default_tcp(void);
 	bool read_unk(uint16_t* output_marker);
@@ -319,10 +340,16 @@ class CodeStreamDecompress : public CodeStream, public ICodeStreamDecompress
 	/** index of single tile to decompress;
 	 *  !!! initialized to -1 !!! */
 	int32_t m_tile_ind_to_dec;
+	// tiles whose data was read before the code stream was rewound
+	std::vector<bool> m_tileDataRead;
 	uint8_t* m_marker_scratch;
 	uint16_t m_marker_scratch_size;
 	GrkImage* m_output_image;
 	TileCache* m_tileCache;
+	// decompress window in canvas coordinates; empty if whole image is decompressed
+	grkRectU32 m_decompressWindow;
+	// caller-supplied interleaved output; inactive if composite image holds the samples
+	InterleavedBuffer m_interleaved;
 };
 
 } // namespace grk
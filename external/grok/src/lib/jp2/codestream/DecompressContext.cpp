@@ -0,0 +1,84 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_includes.h"
+
+namespace grk
+{
+DecompressContext::DecompressContext(void) : coders_(ExecSingleton::numThreads() + 1)
+{
+	obj.wrapper = new GrkObjectWrapperImpl<DecompressContext>(this);
+}
+DecompressContext::~DecompressContext()
+{
+	for(auto& threadCoders : coders_)
+	{
+		for(auto& c : threadCoders)
+			delete c.coder;
+	}
+	for(auto& b : blocks_)
+		delete b;
+}
+DecompressContext* DecompressContext::getImpl(grk_decompress_context* context)
+{
+	return ((GrkObjectWrapperImpl<DecompressContext>*)context->wrapper)->getWrappee();
+}
+grk_decompress_context* DecompressContext::getWrapper(void)
+{
+	return &obj;
+}
+T1Interface* DecompressContext::getCoder(TileCodingParams* tcp, uint16_t blockw, uint16_t blockh)
+{
+	auto threadId = ExecSingleton::threadId();
+	// executor was re-initialized with more threads since context was created
+	if(threadId >= coders_.size())
+		return nullptr;
+	// each slot is only ever accessed by its own thread
+	auto& threadCoders = coders_[threadId];
+	bool isHT = tcp->isHT();
+	for(auto& c : threadCoders)
+	{
+		if(c.isHT == isHT && c.blockw == blockw && c.blockh == blockh)
+			return c.coder;
+	}
+	auto coder = T1Factory::makeT1(false, tcp, blockw, blockh);
+	threadCoders.push_back({isHT, blockw, blockh, coder});
+
+	return coder;
+}
+std::vector<DecompressBlockExec>* DecompressContext::acquireBlocks(void)
+{
+	std::lock_guard<std::mutex> lock(blocksMutex_);
+	if(blocks_.empty())
+		return new std::vector<DecompressBlockExec>();
+	auto blocks = blocks_.back();
+	blocks_.pop_back();
+
+	return blocks;
+}
+void DecompressContext::releaseBlocks(std::vector<DecompressBlockExec>* blocks)
+{
+	blocks->clear();
+	std::lock_guard<std::mutex> lock(blocksMutex_);
+	blocks_.push_back(blocks);
+}
+BufferPool* DecompressContext::getBufferPool(void)
+{
+	return &bufferPool_;
+}
+
+} // namespace grk
@@ -0,0 +1,79 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+namespace grk
+{
+struct DecompressBlockExec;
+class T1Interface;
+
+/**
+ * Decompression state that outlives a single decompressor, so that a run of
+ * (typically small) images can be decompressed without per-image setup.
+ *
+ * T1 coders, code block job lists and tile window sample buffers are
+ * recycled rather than freed when a tile or image completes. Coders are
+ * kept per executor thread, so one context may be shared by decompressors
+ * that run concurrently on the executor (see grk_decompress_batch).
+ */
+class DecompressContext
+{
+  public:
+	DecompressContext(void);
+	~DecompressContext();
+
+	static DecompressContext* getImpl(grk_decompress_context* context);
+	grk_decompress_context* getWrapper(void);
+
+	/**
+	 * Get T1 coder for calling thread
+	 *
+	 * @param tcp tile coding parameters
+	 * @param blockw maximum code block width
+	 * @param blockh maximum code block height
+	 *
+	 * @return coder, owned by context
+	 */
+	T1Interface* getCoder(TileCodingParams* tcp, uint16_t blockw, uint16_t blockh);
+	/**
+	 * Get an empty code block job list, with capacity left over from earlier use
+	 */
+	std::vector<DecompressBlockExec>* acquireBlocks(void);
+	/**
+	 * Return job list to context
+	 */
+	void releaseBlocks(std::vector<DecompressBlockExec>* blocks);
+	BufferPool* getBufferPool(void);
+
+  private:
+	struct PooledCoder
+	{
+		bool isHT;
+		uint16_t blockw;
+		uint16_t blockh;
+		T1Interface* coder;
+	};
+	grk_object obj;
+	// coders for each executor thread, plus the calling thread
+	std::vector<std::vector<PooledCoder>> coders_;
+	std::mutex blocksMutex_;
+	std::vector<std::vector<DecompressBlockExec>*> blocks_;
+	BufferPool bufferPool_;
+};
+
+} // namespace grk
@@ -915,6 +915,15 @@ bool FileFormatCompress::compressTile(uint16_t tileIndex, uint8_t* p_data, uint6
 {
 	return codeStream->compressTile(tileIndex, p_data, data_size);
 }
+bool FileFormatCompress::pushRows(const int32_t* const* data, const uint32_t* stride,
+								  uint32_t numRows)
+{
+	return codeStream->pushRows(data, stride, numRows);
+}
+void FileFormatCompress::getCodecStats(grk_codec_stats* stats)
+{
+	codeStream->getCodecStats(stats);
+}
 bool FileFormatCompress::endCompress(void)
 {
 	/* customization of the end compressing */
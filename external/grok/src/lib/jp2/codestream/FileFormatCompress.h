@@ -32,6 +32,8 @@ class FileFormatCompress : public FileFormat, public ICodeStreamCompress
 	bool startCompress(void);
 	bool compress(grk_plugin_tile* tile);
 	bool compressTile(uint16_t tileIndex, uint8_t* p_data, uint64_t data_size);
+	bool pushRows(const int32_t* const* data, const uint32_t* stride, uint32_t numRows);
+	void getCodecStats(grk_codec_stats* stats);
 	bool endCompress(void);
 
   private:
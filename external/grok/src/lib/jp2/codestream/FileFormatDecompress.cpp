@@ -325,6 +325,18 @@ bool FileFormatDecompress::setDecompressWindow(grkRectU32 window)
 {
 	return codeStream->setDecompressWindow(window);
 }
+bool FileFormatDecompress::setInterleavedOutput(uint8_t* buffer, uint64_t stride,
+												uint8_t bitsPerSample)
+{
+	// palette expands components after decompression, so it needs planar output
+	if(buffer && color.palette)
+	{
+		GRK_ERROR("Interleaved output is not supported for images with a palette");
+		return false;
+	}
+
+	return codeStream->setInterleavedOutput(buffer, stride, bitsPerSample);
+}
 /** Set up decompressor function handler */
 void FileFormatDecompress::initDecompress(grk_dparameters* parameters)
 {
@@ -354,6 +366,28 @@ bool FileFormatDecompress::decompressTile(uint16_t tileIndex)
 
 	return applyColour();
 }
+bool FileFormatDecompress::decompressRefine(uint16_t numLayers, uint8_t reduce)
+{
+	if(!codeStream->decompressRefine(numLayers, reduce))
+	{
+		GRK_ERROR("Failed to refine JP2 file");
+		return false;
+	}
+
+	return applyColour();
+}
+void FileFormatDecompress::getTileCacheStats(grk_tile_cache_stats* stats)
+{
+	codeStream->getTileCacheStats(stats);
+}
+void FileFormatDecompress::getCodecStats(grk_codec_stats* stats)
+{
+	codeStream->getCodecStats(stats);
+}
+void FileFormatDecompress::setDecompressContext(DecompressContext* context)
+{
+	codeStream->setDecompressContext(context);
+}
 /** Reading function used after code stream if necessary */
 bool FileFormatDecompress::endDecompress(void)
 {
@@ -393,7 +427,9 @@ bool FileFormatDecompress::applyColour(GrkImage* img)
 	/* Apply channel definitions if needed */
 	if(color.channel_definition)
 		apply_channel_definition(img, &color);
-	img->color_applied = true;
+	// only flag images that were actually transformed, so that untransformed
+	// tile images can still be re-used by the tile cache
+	img->color_applied = color.palette || color.channel_definition;
 
 	return true;
 }
@@ -38,8 +38,13 @@ class FileFormatDecompress : public FileFormat, public ICodeStreamDecompress
 	GrkImage* getImage(void);
 	void initDecompress(grk_dparameters* p_param);
 	bool setDecompressWindow(grkRectU32 window);
+	bool setInterleavedOutput(uint8_t* buffer, uint64_t stride, uint8_t bitsPerSample);
 	bool decompress(grk_plugin_tile* tile);
 	bool decompressTile(uint16_t tileIndex);
+	bool decompressRefine(uint16_t numLayers, uint8_t reduce);
+	void getTileCacheStats(grk_tile_cache_stats* stats);
+	void getCodecStats(grk_codec_stats* stats);
+	void setDecompressContext(DecompressContext* context);
 	bool endDecompress(void);
 	void dump(uint32_t flag, FILE* outputFileStream);
 
@@ -238,11 +238,13 @@ bool SOTMarker::read(CodeStreamDecompress* codeStream, uint8_t* headerData, uint
 	 *  to decompress or not, corresponding to the tile index*/
 	if(codeStream->tileIndexToDecode() == -1)
 	{
+		// a caching decompressor also skips tiles whose data it still holds
 		codeStream->getDecompressorState()->skipTileData =
 			(tile_x < codeStream->getDecompressorState()->m_start_tile_x_index) ||
 			(tile_x >= codeStream->getDecompressorState()->m_end_tile_x_index) ||
 			(tile_y < codeStream->getDecompressorState()->m_start_tile_y_index) ||
-			(tile_y >= codeStream->getDecompressorState()->m_end_tile_y_index);
+			(tile_y >= codeStream->getDecompressorState()->m_end_tile_y_index) ||
+			codeStream->tileDataWasRead(tileIndex);
 	}
 	else
 	{
@@ -103,7 +103,9 @@
 #include "GrkObjectWrapper.h"
 #include "logger.h"
 #include "testing.h"
-#include "ThreadPool.hpp"
+#include "ExecSingleton.h"
+#include "CodecStats.h"
+#include "StreamPrefetcher.h"
 #include "MemStream.h"
 #include "GrkMappedFile.h"
 #include "GrkMatrix.h"
@@ -152,4 +154,5 @@
 #include "RateInfo.h"
 #include "T1Factory.h"
 #include "T1DecompressScheduler.h"
+#include "DecompressContext.h"
 #include "T1CompressScheduler.h"
@@ -66,13 +66,14 @@ GrkCodec::~GrkCodec()
 	delete m_decompressor;
 }
 
-ThreadPool* ThreadPool::singleton = nullptr;
-std::mutex ThreadPool::singleton_mutex;
+tf::Executor* ExecSingleton::singleton = nullptr;
+tf::Executor* ExecSingleton::ioSingleton = nullptr;
+std::mutex ExecSingleton::singleton_mutex;
 
 static bool is_plugin_initialized = false;
 bool GRK_CALLCONV grk_initialize(const char* pluginPath, uint32_t numthreads)
 {
-	ThreadPool::instance(numthreads);
+	ExecSingleton::instance(numthreads);
 	if(!is_plugin_initialized)
 	{
 		grk_plugin_load_info info;
@@ -86,7 +87,7 @@ bool GRK_CALLCONV grk_initialize(const char* pluginPath, uint32_t numthreads)
 GRK_API void GRK_CALLCONV grk_deinitialize()
 {
 	grk_plugin_cleanup();
-	ThreadPool::release();
+	ExecSingleton::release();
 }
 
 GRK_API void GRK_CALLCONV grk_object_ref(grk_object* obj)
@@ -282,6 +283,18 @@ bool GRK_CALLCONV grk_decompress_set_window(grk_codec* codecWrapper, uint32_t st
 	}
 	return false;
 }
+bool GRK_CALLCONV grk_decompress_set_interleaved_output(grk_codec* codecWrapper, uint8_t* buffer,
+														uint64_t stride, uint8_t bitsPerSample)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		return codec->m_decompressor ? codec->m_decompressor->setInterleavedOutput(
+										   buffer, stride, bitsPerSample)
+									 : false;
+	}
+	return false;
+}
 bool GRK_CALLCONV grk_decompress(grk_codec* codecWrapper, grk_plugin_tile* tile)
 {
 	if(codecWrapper)
@@ -304,6 +317,30 @@ bool GRK_CALLCONV grk_decompress_tile(grk_codec* codecWrapper, uint16_t tileInde
 	}
 	return false;
 }
+bool GRK_CALLCONV grk_decompress_refine(grk_codec* codecWrapper, uint16_t numLayers,
+										 uint8_t reduce)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		return codec->m_decompressor ? codec->m_decompressor->decompressRefine(numLayers, reduce)
+									 : false;
+	}
+	return false;
+}
+bool GRK_CALLCONV grk_decompress_get_tile_cache_stats(grk_codec* codecWrapper,
+													   grk_tile_cache_stats* stats)
+{
+	if(codecWrapper && stats)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		if(!codec->m_decompressor)
+			return false;
+		codec->m_decompressor->getTileCacheStats(stats);
+		return true;
+	}
+	return false;
+}
 bool GRK_CALLCONV grk_decompress_end(grk_codec* codecWrapper)
 {
 	if(codecWrapper)
@@ -314,6 +351,87 @@ bool GRK_CALLCONV grk_decompress_end(grk_codec* codecWrapper)
 	return false;
 }
 
+grk_decompress_context* GRK_CALLCONV grk_decompress_context_create(void)
+{
+	auto context = new DecompressContext();
+
+	return context->getWrapper();
+}
+bool GRK_CALLCONV grk_decompress_set_context(grk_codec* codecWrapper,
+											 grk_decompress_context* context)
+{
+	if(codecWrapper)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		if(!codec->m_decompressor)
+			return false;
+		codec->m_decompressor->setDecompressContext(context ? DecompressContext::getImpl(context)
+															: nullptr);
+		return true;
+	}
+	return false;
+}
+static GRK_CODEC_FORMAT grk_get_codec_format(const uint8_t* data, size_t len)
+{
+	static const uint8_t jp2Signature[] = {0x00, 0x00, 0x00, 0x0c, 0x6a, 0x50,
+										   0x20, 0x20, 0x0d, 0x0a, 0x87, 0x0a};
+	static const uint8_t j2kSignature[] = {0xff, 0x4f, 0xff, 0x51};
+	if(len >= sizeof(jp2Signature) && !memcmp(data, jp2Signature, sizeof(jp2Signature)))
+		return GRK_CODEC_JP2;
+	if(len >= sizeof(j2kSignature) && !memcmp(data, j2kSignature, sizeof(j2kSignature)))
+		return GRK_CODEC_J2K;
+
+	return GRK_CODEC_UNKNOWN;
+}
+static bool grk_decompress_batch_item_exec(grk_decompress_context* context,
+										   grk_dparameters* parameters,
+										   grk_decompress_batch_item* item)
+{
+	item->image = nullptr;
+	item->success = false;
+	auto format = item->data ? grk_get_codec_format(item->data, item->len) : GRK_CODEC_UNKNOWN;
+	if(format == GRK_CODEC_UNKNOWN)
+	{
+		GRK_ERROR("Batch decompress: unknown code stream format");
+		return false;
+	}
+	// read stream over caller's buffer, which it neither owns nor modifies
+	auto stream = create_mem_stream((uint8_t*)item->data, item->len, false, true);
+	if(!stream)
+		return false;
+	auto codec = grk_decompress_create(format, stream);
+	bool rc = codec && grk_decompress_set_context(codec, context) &&
+			  grk_decompress_init(codec, parameters) && grk_decompress_read_header(codec, nullptr) &&
+			  grk_decompress(codec, nullptr);
+	if(rc)
+	{
+		// image outlives codec
+		auto image = grk_decompress_get_composited_image(codec);
+		grk_object_ref(&image->obj);
+		item->image = image;
+		item->success = true;
+	}
+	grk_object_unref(codec);
+	grk_object_unref(stream);
+
+	return rc;
+}
+bool GRK_CALLCONV grk_decompress_batch(grk_decompress_context* context,
+									   grk_dparameters* parameters,
+									   grk_decompress_batch_item* items, uint32_t numItems)
+{
+	if(!parameters || (!items && numItems))
+		return false;
+	// each code stream is decompressed as an executor job; its tile graphs
+	// are then run cooperatively by the worker that decompresses it
+	std::atomic_bool success(true);
+	ExecSingleton::forkJoin(numItems, [context, parameters, items, &success](uint32_t index) {
+		if(!grk_decompress_batch_item_exec(context, parameters, items + index))
+			success = false;
+	});
+
+	return success;
+}
 void GRK_CALLCONV grk_dump_codec(grk_codec* codecWrapper, uint32_t info_flag, FILE* output_stream)
 {
 	assert(codecWrapper);
@@ -426,7 +544,7 @@ void GRK_CALLCONV grk_compress_set_default_params(grk_cparameters* parameters)
 		parameters->writePLT = false;
 		parameters->writeTLM = false;
 		if(!parameters->numThreads)
-			parameters->numThreads = ThreadPool::hardware_concurrency();
+			parameters->numThreads = ExecSingleton::hardware_concurrency();
 		parameters->deviceId = 0;
 		parameters->repeats = 1;
 	}
@@ -485,6 +603,38 @@ bool GRK_CALLCONV grk_compress_tile(grk_codec* codecWrapper, uint16_t tileIndex,
 	}
 	return false;
 }
+bool GRK_CALLCONV grk_compress_push_rows(grk_codec* codecWrapper, const int32_t* const* data,
+										 const uint32_t* stride, uint32_t numRows)
+{
+	if(codecWrapper && data && stride)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		return codec->m_compressor ? codec->m_compressor->pushRows(data, stride, numRows) : false;
+	}
+	return false;
+}
+bool GRK_CALLCONV grk_codec_get_stats(grk_codec* codecWrapper, grk_codec_stats* stats)
+{
+	if(codecWrapper && stats)
+	{
+		auto codec = GrkCodec::getImpl(codecWrapper);
+		if(codec->m_decompressor)
+			codec->m_decompressor->getCodecStats(stats);
+		else if(codec->m_compressor)
+			codec->m_compressor->getCodecStats(stats);
+		else
+			return false;
+		return true;
+	}
+	return false;
+}
+const char* GRK_CALLCONV grk_codec_stage_name(GRK_STAGE stage)
+{
+	static const char* names[GRK_NUM_STAGES] = {
+		"markers", "t2", "t1", "t1_ht", "dwt", "mct", "composite", "io", "rate_control"};
+
+	return stage < GRK_NUM_STAGES ? names[stage] : nullptr;
+}
 
 static void grkFree_file(void* p_user_data)
 {
@@ -547,6 +697,11 @@ grk_stream* GRK_CALLCONV grk_stream_create_mapped_file_stream(const char* fname,
 	else
 		return create_mapped_file_write_stream(fname);
 }
+grk_stream* GRK_CALLCONV grk_stream_create_mapped_file_range_stream(const char* fname,
+																	size_t buffer_size)
+{
+	return create_mapped_file_range_read_stream(fname, buffer_size);
+}
 /* ---------------------------------------------------------------------- */
 
 /**********************************************************************
@@ -843,6 +998,14 @@ void GRK_CALLCONV grk_stream_set_seek_function(grk_stream* stream, grk_stream_se
 	if(streamImpl)
 		streamImpl->setSeekFunction(p_function);
 }
+void GRK_CALLCONV grk_stream_set_read_ranges_function(grk_stream* stream,
+													  grk_stream_read_ranges_fn p_function)
+{
+	auto streamImpl = BufferedStream::getImpl(stream);
+	if((!streamImpl) || (!(streamImpl->getStatus() & GROK_STREAM_STATUS_INPUT)))
+		return;
+	streamImpl->setReadRangesFunction(p_function);
+}
 void GRK_CALLCONV grk_stream_set_write_function(grk_stream* stream, grk_stream_write_fn p_function)
 {
 	auto streamImpl = BufferedStream::getImpl(stream);
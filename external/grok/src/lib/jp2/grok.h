@@ -365,10 +365,72 @@ typedef enum _GRK_CODEC_FORMAT
 
 typedef enum GRK_TILE_CACHE_STRATEGY
 {
-	GRK_TILE_CACHE_NONE,
-	GRK_TILE_CACHE_ALL,
+	GRK_TILE_CACHE_NONE, /**< tile images are not reused between decompress calls */
+	GRK_TILE_CACHE_ALL, /**< all decompressed tile images are kept */
+	GRK_TILE_CACHE_LRU /**< least recently used tile images are evicted beyond tileCacheMaxBytes */
 } GRK_TILE_CACHE_STRATEGY;
 
+/**
+ * Tile cache statistics, accumulated over the lifetime of a decompress codec
+ */
+typedef struct _grk_tile_cache_stats
+{
+	/** number of tiles served from the cache */
+	uint64_t hits;
+	/** number of tiles that had to be decompressed */
+	uint64_t misses;
+	/** number of tile images evicted from the cache */
+	uint64_t evictions;
+	/** number of bytes currently held by cached tiles: tile images, plus the code block
+	 * state and compressed data kept to decompress them again */
+	uint64_t bytes;
+} grk_tile_cache_stats;
+
+/**
+ * Codec stages that are profiled
+ */
+typedef enum GRK_STAGE
+{
+	GRK_STAGE_MARKERS, /**< marker parsing / writing */
+	GRK_STAGE_T2, /**< packet parsing / writing */
+	GRK_STAGE_T1, /**< Part 1 code block coding */
+	GRK_STAGE_T1_HT, /**< high throughput code block coding */
+	GRK_STAGE_DWT, /**< wavelet transform */
+	GRK_STAGE_MCT, /**< multiple component transform and DC level shift */
+	GRK_STAGE_COMPOSITE, /**< copying tiles into the output image */
+	GRK_STAGE_IO, /**< stream callbacks */
+	GRK_STAGE_RATE_CONTROL, /**< rate control */
+	GRK_NUM_STAGES
+} GRK_STAGE;
+
+/**
+ * Profile of a single codec stage
+ *
+ * Stage invocations may run concurrently on different threads, so that
+ * wall time may exceed the elapsed time of the decompress or compress call.
+ * CPU time is measured on the thread that invokes the stage.
+ */
+typedef struct _grk_stage_stats
+{
+	/** number of stage invocations */
+	uint64_t count;
+	/** wall time summed over all invocations, in nanoseconds */
+	uint64_t wallNs;
+	/** thread CPU time summed over all invocations, in nanoseconds */
+	uint64_t cpuNs;
+	/** number of bytes processed: compressed bytes for markers, T2, T1, I/O and rate control,
+	 *  and sample bytes for the remaining stages */
+	uint64_t bytes;
+} grk_stage_stats;
+
+/**
+ * Stage profile, accumulated over the lifetime of a codec
+ */
+typedef struct _grk_codec_stats
+{
+	grk_stage_stats stages[GRK_NUM_STAGES];
+} grk_codec_stats;
+
 /**
  * Callback function prototype for logging
  *
@@ -754,6 +816,12 @@ typedef struct _grk_dparameters
 	uint32_t nb_tile_to_decompress;
 	uint32_t flags;
 	GRK_TILE_CACHE_STRATEGY tileCacheStrategy;
+	/**
+	 Maximum number of bytes held by the tile cache, for the GRK_TILE_CACHE_LRU strategy,
+	 counting tile images as well as the code block state and compressed data kept to
+	 decompress them again. If equal to zero, the cache is unbounded
+	 */
+	uint64_t tileCacheMaxBytes;
 } grk_dparameters;
 
 /**
@@ -831,6 +899,12 @@ typedef struct _grk_decompress_params
 
 typedef grk_object grk_codec;
 
+/*
+ * Decompression state that is recycled across decompressors
+ * (see grk_decompress_context_create)
+ */
+typedef grk_object grk_decompress_context;
+
 /*
  ==========================================================
  I/O stream typedef definitions
@@ -851,6 +925,26 @@ typedef size_t (*grk_stream_write_fn)(void* buffer, size_t numBytes, void* user_
  * Callback function prototype for (absolute) seek function.
  */
 typedef bool (*grk_stream_seek_fn)(uint64_t numBytes, void* user_data);
+/*
+ * Byte range to be read by a range read function
+ */
+typedef struct _grk_stream_range
+{
+	uint64_t offset; // offset from beginning of stream
+	size_t length; // number of bytes to read
+	uint8_t* buffer; // destination, of at least length bytes
+} grk_stream_range;
+/*
+ * Callback function prototype for range read function : reads each range
+ * into its buffer, independently of the current stream position, and
+ * returns true if all ranges were read in full.
+ *
+ * The library calls this function from its own I/O threads, and from its worker
+ * threads, with several calls in flight at once, so it must be thread-safe. A remote stream
+ * would typically issue all ranges of a call as concurrent requests.
+ */
+typedef bool (*grk_stream_read_ranges_fn)(grk_stream_range* ranges, uint32_t numRanges,
+										  void* user_data);
 /*
  * Callback function prototype for free user data function
  */
@@ -985,6 +1079,17 @@ typedef struct _grk_image_comptparm
 	bool sgnd;
 } grk_image_cmptparm;
 
+/**
+ * In-memory code stream to be decompressed by grk_decompress_batch
+ */
+typedef struct _grk_decompress_batch_item
+{
+	const uint8_t* data; // J2K or JP2 code stream
+	size_t len; // length of code stream in bytes
+	grk_image* image; // decompressed image : caller releases it with grk_object_unref
+	bool success; // true if code stream was successfully decompressed
+} grk_decompress_batch_item;
+
 ////////////////////////////////////////////////
 // Structs to pass data between grok and plugin
 /////////////////////////////////////////////////
@@ -1195,6 +1300,20 @@ GRK_API void GRK_CALLCONV grk_stream_set_write_function(grk_stream* stream,
 GRK_API void GRK_CALLCONV grk_stream_set_seek_function(grk_stream* stream,
 													   grk_stream_seek_fn p_function);
 
+/**
+ * Set the given function to be used as a range read function, for a seekable
+ * read stream.
+ *
+ * When a code stream has TLM markers, the decompressor uses the tile part lengths
+ * to read all tile parts that it will parse ahead of time, in batches of coalesced
+ * ranges, so that tiles are decompressed while later tiles are still being read.
+ *
+ * @param		stream	the stream to modify
+ * @param		p_function	the function to use as range read function.
+ */
+GRK_API void GRK_CALLCONV grk_stream_set_read_ranges_function(grk_stream* stream,
+															  grk_stream_read_ranges_fn p_function);
+
 /**
  * Set the given data to be used as a user data for the stream.
  *
@@ -1250,6 +1369,16 @@ GRK_API size_t GRK_CALLCONV grk_stream_get_write_mem_stream_length(grk_stream* s
 GRK_API grk_stream* GRK_CALLCONV grk_stream_create_mapped_file_stream(const char* fname,
 																	  bool read_stream);
 
+/**
+ * Create buffered read stream over memory mapped file, with a range read function
+ * (see grk_stream_set_read_ranges_function)
+ *
+ * @param fname			file name
+ * @param buffer_size	size of the chunk used to stream
+ */
+GRK_API grk_stream* GRK_CALLCONV grk_stream_create_mapped_file_range_stream(const char* fname,
+																			size_t buffer_size);
+
 /**
  * Create J2K/JP2 decompression structure
  *
@@ -1326,6 +1455,26 @@ GRK_API bool GRK_CALLCONV grk_decompress_set_window(grk_codec* codec, uint32_t s
 													uint32_t start_y, uint32_t end_x,
 													uint32_t end_y);
 
+/**
+ * Decompress directly into a caller-supplied interleaved buffer, instead of into
+ * the planar 32 bit components of the composite image. Each tile is written to the
+ * buffer as soon as it is decompressed, with components interleaved in code stream order.
+ * The buffer covers the composite image, i.e. the decompress window at the current
+ * resolution reduction. All components must be unsigned, with the same sub-sampling,
+ * and with precision no greater than bitsPerSample. This function should be called
+ * after grk_decompress_read_header; the composite image will have no sample data.
+ *
+ * @param	codec			JPEG 2000 code stream
+ * @param	buffer			interleaved buffer, or nullptr to decompress into the composite image
+ * @param	stride			number of bytes between the start of two consecutive rows of buffer
+ * @param	bitsPerSample	bits per sample of buffer : either 8 or 16
+ *
+ * @return	true			if the buffer could be set.
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_set_interleaved_output(grk_codec* codec, uint8_t* buffer,
+																uint64_t stride,
+																uint8_t bitsPerSample);
+
 /**
  * Decompress image from a JPEG 2000 code stream
  *
@@ -1345,6 +1494,32 @@ GRK_API bool GRK_CALLCONV grk_decompress(grk_codec* p_decompressor, grk_plugin_t
  */
 GRK_API bool GRK_CALLCONV grk_decompress_tile(grk_codec* codec, uint16_t tileIndex);
 
+/**
+ * Refine a completed decompress of the whole code stream with more quality layers
+ * and/or less resolution reduction, keeping the decompress window.
+ * Packets and code block coding passes already processed by the earlier decompress
+ * are re-used, so that only new packets and passes need to be processed.
+ *
+ * @param	codec			JPEG 2000 code stream
+ * @param	numLayers		number of quality layers to decompress (0 for all layers)
+ * @param	reduce			number of highest resolutions to discard
+ *
+ * @return					true if successful, otherwise false
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_refine(grk_codec* codec, uint16_t numLayers,
+												 uint8_t reduce);
+
+/**
+ * Get tile cache statistics
+ *
+ * @param	codec			JPEG 2000 code stream
+ * @param	stats			tile cache statistics
+ *
+ * @return					true if successful, otherwise false
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_get_tile_cache_stats(grk_codec* codec,
+															  grk_tile_cache_stats* stats);
+
 /**
  * End decompression
  *
@@ -1352,6 +1527,48 @@ GRK_API bool GRK_CALLCONV grk_decompress_tile(grk_codec* codec, uint16_t tileInd
  */
 GRK_API bool GRK_CALLCONV grk_decompress_end(grk_codec* codec);
 
+/**
+ * Create a decompress context, to be shared by a run of decompressors.
+ * T1 coders, code block job lists and tile sample buffers are kept in the context
+ * when a decompressor is done with them, and re-used by the next decompressor,
+ * which removes most per-image setup when decompressing many small images.
+ * The context must be released with grk_object_unref before grk_deinitialize is called.
+ *
+ * @return a handle to a decompress context
+ */
+GRK_API grk_decompress_context* GRK_CALLCONV grk_decompress_context_create(void);
+
+/**
+ * Attach decompress context to decompressor. This function should be called
+ * before grk_decompress. The decompressor holds a reference to the context, and
+ * tiles created while it is attached keep their own reference until they are released,
+ * so the context may safely be replaced or detached at any time.
+ *
+ * @param	codec			JPEG 2000 code stream
+ * @param	context			decompress context, or nullptr to detach current context
+ *
+ * @return					true if successful, otherwise false
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_set_context(grk_codec* codec,
+													 grk_decompress_context* context);
+
+/**
+ * Decompress a batch of in-memory code streams concurrently, on the library's
+ * thread pool. Each code stream is decompressed in full with the same parameters;
+ * J2K and JP2 formats are detected from the stream signature.
+ *
+ * @param	context			decompress context, or nullptr
+ * @param	parameters		decompression parameters
+ * @param	items			code streams; on return, each holds its image and status
+ * @param	numItems		number of code streams
+ *
+ * @return					true if all code streams were successfully decompressed
+ */
+GRK_API bool GRK_CALLCONV grk_decompress_batch(grk_decompress_context* context,
+											   grk_dparameters* parameters,
+											   grk_decompress_batch_item* items,
+											   uint32_t numItems);
+
 /* COMPRESSION FUNCTIONS*/
 
 /**
@@ -1435,6 +1652,27 @@ GRK_API bool GRK_CALLCONV grk_compress(grk_codec* codec);
 GRK_API bool GRK_CALLCONV grk_compress_tile(grk_codec* codec, uint16_t tileIndex, uint8_t* data,
 											uint64_t data_size);
 
+/**
+ * Compress a horizontal strip of image rows.
+ *
+ * Strips are pushed from top to bottom, right after grk_compress_start and before
+ * grk_compress_end, until all image rows have been pushed. The image passed to
+ * grk_compress_init need not have any component data allocated. Once the last row of
+ * a tile row has been pushed, its tiles are compressed and written to the stream while
+ * the next tile row is filled, so memory use is bounded by tile height rather than
+ * image height. Strips may be of any height. Subsampled components are not supported.
+ *
+ * @param	codec		compressor handle
+ * @param	data		array of planar component buffers, one per component, holding
+ * 						numRows rows of component width samples each
+ * @param	stride		array of component buffer strides, in samples
+ * @param	numRows		number of rows in strip
+ *
+ * @return	true if successful
+ */
+GRK_API bool GRK_CALLCONV grk_compress_push_rows(grk_codec* codec, const int32_t* const* data,
+												 const uint32_t* stride, uint32_t numRows);
+
 /**
  * Encode an image into a JPEG 2000 code stream using plugin
  * @param codec 		compressor handle
@@ -1460,6 +1698,25 @@ GRK_API bool GRK_CALLCONV grk_compress_end(grk_codec* codec);
  */
 GRK_API void GRK_CALLCONV grk_dump_codec(grk_codec* codec, uint32_t info_flag, FILE* output_stream);
 
+/**
+ * Get stage profile of a compress or decompress codec
+ *
+ * @param	codec			JPEG 2000 code stream
+ * @param	stats			stage profile
+ *
+ * @return					true if successful, otherwise false
+ */
+GRK_API bool GRK_CALLCONV grk_codec_get_stats(grk_codec* codec, grk_codec_stats* stats);
+
+/**
+ * Get name of codec stage
+ *
+ * @param	stage			codec stage
+ *
+ * @return					stage name, or nullptr if stage is invalid
+ */
+GRK_API const char* GRK_CALLCONV grk_codec_stage_name(GRK_STAGE stage);
+
 /**
  * Set the MCT matrix to use.
  *
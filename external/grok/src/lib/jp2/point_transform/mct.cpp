@@ -414,35 +414,278 @@ namespace HWY_NAMESPACE
 		const float cr = 0.5f / (1.0f - a_r);
 	};
 
+	/**
+	 * Interleave planar 16 bit samples
+	 */
+	void interleave(const uint16_t* planes, size_t planeStride, size_t numcomps, size_t n,
+					uint16_t* dest)
+	{
+		for(size_t c = 0; c < numcomps; ++c)
+		{
+			auto src = planes + c * planeStride;
+			for(size_t i = 0; i < n; ++i)
+				dest[i * numcomps + c] = src[i];
+		}
+	}
+
+	/**
+	 * Interleave planar 8 bit samples
+	 * (three and four component interleaved stores are vectorized)
+	 */
+	void interleave(const uint8_t* planes, size_t planeStride, size_t numcomps, size_t n,
+					uint8_t* dest)
+	{
+		const HWY_FULL(uint8_t) d8;
+		size_t i = 0;
+		if(numcomps == 3)
+		{
+			for(; i + Lanes(d8) <= n; i += Lanes(d8))
+				StoreInterleaved3(LoadU(d8, planes + i), LoadU(d8, planes + planeStride + i),
+								  LoadU(d8, planes + 2 * planeStride + i), d8, dest + i * 3);
+		}
+		else if(numcomps == 4)
+		{
+			for(; i + Lanes(d8) <= n; i += Lanes(d8))
+				StoreInterleaved4(LoadU(d8, planes + i), LoadU(d8, planes + planeStride + i),
+								  LoadU(d8, planes + 2 * planeStride + i),
+								  LoadU(d8, planes + 3 * planeStride + i), d8, dest + i * 4);
+		}
+		for(size_t c = 0; c < numcomps; ++c)
+		{
+			auto src = planes + c * planeStride;
+			for(size_t j = i; j < n; ++j)
+				dest[j * numcomps + c] = src[j];
+		}
+	}
+
+	/**
+	 * Apply inverse MCT and dc shift to rows of tile samples, clamp them,
+	 * and pack them into interleaved 8 or 16 bit output.
+	 *
+	 * Each row is processed in chunks : samples are transformed and narrowed into
+	 * small planar buffers that stay in L1 cache, which are then interleaved into the output.
+	 */
+	template<typename T>
+	class DecompressInterleaved
+	{
+	  public:
+		DecompressInterleaved(const InterleaveInfo* info)
+			: info_(info), src_(info->channels.size()), planes_(info->channels.size() * chunkSize)
+		{}
+		void rows(uint32_t yBegin, uint32_t yEnd)
+		{
+			auto numcomps = info_->channels.size();
+			for(uint32_t y = yBegin; y < yEnd; ++y)
+			{
+				auto dest = (T*)(info_->dest + y * info_->destStride);
+				for(uint32_t x = 0; x < info_->width; x += chunkSize)
+				{
+					auto n = std::min<uint32_t>(chunkSize, info_->width - x);
+					for(size_t compno = 0; compno < numcomps; ++compno)
+						src_[compno] =
+							info_->channels[compno] + (uint64_t)y * info_->srcStride[compno] + x;
+					// a single component is written directly to output
+					T* planes = numcomps == 1 ? dest + x : planes_.data();
+					size_t compno = 0;
+					if(info_->mct == 1)
+					{
+						rev(n, planes);
+						compno = 3;
+					}
+					else if(info_->mct == 2)
+					{
+						irrev(n, planes);
+						compno = 3;
+					}
+					for(; compno < numcomps; ++compno)
+					{
+						if(info_->irreversible[compno])
+							shiftIrrev(compno, n, planes + compno * chunkSize);
+						else
+							shiftRev(compno, n, planes + compno * chunkSize);
+					}
+					if(numcomps > 1)
+						interleave(planes, chunkSize, numcomps, n, dest + x * numcomps);
+				}
+			}
+		}
+
+	  private:
+		void shiftRev(size_t compno, uint32_t n, T* GRK_RESTRICT out)
+		{
+			const int32_t* GRK_RESTRICT src = src_[compno];
+			auto shiftInfo = info_->shiftInfo[compno];
+			const HWY_FULL(int32_t) di;
+			const Rebind<T, decltype(di)> dn;
+			auto vshift = Set(di, shiftInfo._shift);
+			auto vmin = Set(di, shiftInfo._min);
+			auto vmax = Set(di, shiftInfo._max);
+			size_t i = 0;
+			for(; i + Lanes(di) <= n; i += Lanes(di))
+				StoreU(DemoteTo(dn, Clamp(LoadU(di, src + i) + vshift, vmin, vmax)), dn, out + i);
+			for(; i < n; ++i)
+				out[i] = (T)std::clamp<int32_t>(src[i] + shiftInfo._shift, shiftInfo._min,
+												shiftInfo._max);
+		}
+		void shiftIrrev(size_t compno, uint32_t n, T* GRK_RESTRICT out)
+		{
+			const float* GRK_RESTRICT src = (const float*)src_[compno];
+			auto shiftInfo = info_->shiftInfo[compno];
+			const HWY_FULL(int32_t) di;
+			const HWY_FULL(float) df;
+			const Rebind<T, decltype(di)> dn;
+			auto vshift = Set(di, shiftInfo._shift);
+			auto vmin = Set(di, shiftInfo._min);
+			auto vmax = Set(di, shiftInfo._max);
+			size_t i = 0;
+			for(; i + Lanes(di) <= n; i += Lanes(di))
+				StoreU(DemoteTo(dn, Clamp(NearestInt(LoadU(df, src + i)) + vshift, vmin, vmax)),
+					   dn, out + i);
+			for(; i < n; ++i)
+				out[i] = (T)std::clamp<int32_t>((int32_t)grk_lrintf(src[i]) + shiftInfo._shift,
+												shiftInfo._min, shiftInfo._max);
+		}
+		void rev(uint32_t n, T* GRK_RESTRICT out)
+		{
+			const int32_t* GRK_RESTRICT chan0 = src_[0];
+			const int32_t* GRK_RESTRICT chan1 = src_[1];
+			const int32_t* GRK_RESTRICT chan2 = src_[2];
+			auto& shiftInfo = info_->shiftInfo;
+			T* GRK_RESTRICT outr = out;
+			T* GRK_RESTRICT outg = out + chunkSize;
+			T* GRK_RESTRICT outb = out + 2 * chunkSize;
+
+			const HWY_FULL(int32_t) di;
+			const Rebind<T, decltype(di)> dn;
+			auto vdcr = Set(di, shiftInfo[0]._shift);
+			auto vdcg = Set(di, shiftInfo[1]._shift);
+			auto vdcb = Set(di, shiftInfo[2]._shift);
+			auto minr = Set(di, shiftInfo[0]._min);
+			auto ming = Set(di, shiftInfo[1]._min);
+			auto minb = Set(di, shiftInfo[2]._min);
+			auto maxr = Set(di, shiftInfo[0]._max);
+			auto maxg = Set(di, shiftInfo[1]._max);
+			auto maxb = Set(di, shiftInfo[2]._max);
+			size_t i = 0;
+			for(; i + Lanes(di) <= n; i += Lanes(di))
+			{
+				auto y = LoadU(di, chan0 + i);
+				auto u = LoadU(di, chan1 + i);
+				auto v = LoadU(di, chan2 + i);
+				auto g = y - ShiftRight<2>(u + v);
+				auto r = v + g;
+				auto b = u + g;
+				StoreU(DemoteTo(dn, Clamp(r + vdcr, minr, maxr)), dn, outr + i);
+				StoreU(DemoteTo(dn, Clamp(g + vdcg, ming, maxg)), dn, outg + i);
+				StoreU(DemoteTo(dn, Clamp(b + vdcb, minb, maxb)), dn, outb + i);
+			}
+			for(; i < n; ++i)
+			{
+				int32_t y = chan0[i];
+				int32_t u = chan1[i];
+				int32_t v = chan2[i];
+				int32_t g = y - ((u + v) >> 2);
+				int32_t r = v + g;
+				int32_t b = u + g;
+				outr[i] = (T)std::clamp<int32_t>(r + shiftInfo[0]._shift, shiftInfo[0]._min,
+												 shiftInfo[0]._max);
+				outg[i] = (T)std::clamp<int32_t>(g + shiftInfo[1]._shift, shiftInfo[1]._min,
+												 shiftInfo[1]._max);
+				outb[i] = (T)std::clamp<int32_t>(b + shiftInfo[2]._shift, shiftInfo[2]._min,
+												 shiftInfo[2]._max);
+			}
+		}
+		void irrev(uint32_t n, T* GRK_RESTRICT out)
+		{
+			const float* GRK_RESTRICT chan0 = (const float*)src_[0];
+			const float* GRK_RESTRICT chan1 = (const float*)src_[1];
+			const float* GRK_RESTRICT chan2 = (const float*)src_[2];
+			auto& shiftInfo = info_->shiftInfo;
+			T* GRK_RESTRICT outr = out;
+			T* GRK_RESTRICT outg = out + chunkSize;
+			T* GRK_RESTRICT outb = out + 2 * chunkSize;
+
+			const HWY_FULL(float) df;
+			const HWY_FULL(int32_t) di;
+			const Rebind<T, decltype(di)> dn;
+			auto vdcr = Set(di, shiftInfo[0]._shift);
+			auto vdcg = Set(di, shiftInfo[1]._shift);
+			auto vdcb = Set(di, shiftInfo[2]._shift);
+			auto minr = Set(di, shiftInfo[0]._min);
+			auto ming = Set(di, shiftInfo[1]._min);
+			auto minb = Set(di, shiftInfo[2]._min);
+			auto maxr = Set(di, shiftInfo[0]._max);
+			auto maxg = Set(di, shiftInfo[1]._max);
+			auto maxb = Set(di, shiftInfo[2]._max);
+			auto vrv = Set(df, 1.402f);
+			auto vgu = Set(df, 0.34413f);
+			auto vgv = Set(df, 0.71414f);
+			auto vbu = Set(df, 1.772f);
+			size_t i = 0;
+			for(; i + Lanes(di) <= n; i += Lanes(di))
+			{
+				auto vy = LoadU(df, chan0 + i);
+				auto vu = LoadU(df, chan1 + i);
+				auto vv = LoadU(df, chan2 + i);
+				auto vr = vy + vv * vrv;
+				auto vg = vy - vu * vgu - vv * vgv;
+				auto vb = vy + vu * vbu;
+				StoreU(DemoteTo(dn, Clamp(NearestInt(vr) + vdcr, minr, maxr)), dn, outr + i);
+				StoreU(DemoteTo(dn, Clamp(NearestInt(vg) + vdcg, ming, maxg)), dn, outg + i);
+				StoreU(DemoteTo(dn, Clamp(NearestInt(vb) + vdcb, minb, maxb)), dn, outb + i);
+			}
+			for(; i < n; ++i)
+			{
+				float y = chan0[i];
+				float u = chan1[i];
+				float v = chan2[i];
+				float r = y + (v * 1.402f);
+				float g = y - (u * 0.34413f) - (v * (0.71414f));
+				float b = y + (u * 1.772f);
+				outr[i] = (T)std::clamp<int32_t>((int32_t)grk_lrintf(r) + shiftInfo[0]._shift,
+												 shiftInfo[0]._min, shiftInfo[0]._max);
+				outg[i] = (T)std::clamp<int32_t>((int32_t)grk_lrintf(g) + shiftInfo[1]._shift,
+												 shiftInfo[1]._min, shiftInfo[1]._max);
+				outb[i] = (T)std::clamp<int32_t>((int32_t)grk_lrintf(b) + shiftInfo[2]._shift,
+												 shiftInfo[2]._min, shiftInfo[2]._max);
+			}
+		}
+		// samples per chunk : a multiple of all vector widths
+		static const uint32_t chunkSize = 256;
+		const InterleaveInfo* info_;
+		// current chunk of each component
+		std::vector<const int32_t*> src_;
+		std::vector<T> planes_;
+	};
+
+	template<typename T>
+	void interleavedScheduler(const InterleaveInfo* info)
+	{
+		uint32_t numJobs = std::min<uint32_t>(ExecSingleton::numThreads(), info->height);
+		uint32_t rowsPerJob = (info->height + numJobs - 1) / numJobs;
+		ExecSingleton::forkJoin(numJobs, [info, rowsPerJob](uint32_t index) {
+			DecompressInterleaved<T> transform(info);
+			uint32_t yBegin = index * rowsPerJob;
+			transform.rows(yBegin, std::min<uint32_t>(yBegin + rowsPerJob, info->height));
+		});
+	}
+
 	template<class T>
 	size_t vscheduler(std::vector<int32_t*> channels, std::vector<ShiftInfo> shiftInfo, size_t numSamples)
 	{
 		size_t i = 0;
-		size_t num_threads = ThreadPool::get()->num_threads();
+		size_t num_threads = ExecSingleton::numThreads();
 		size_t chunkSize = numSamples / num_threads;
 		const HWY_FULL(int32_t) di;
 		auto numLanes = Lanes(di);
 		chunkSize = (chunkSize / numLanes) * numLanes;
 		if(chunkSize > numLanes)
 		{
-			std::vector<std::future<int>> results;
-			for(size_t tr = 0; tr < num_threads; ++tr)
-			{
-				size_t index = tr;
-				auto compressor = [index, chunkSize, channels, shiftInfo]() {
-					T transform;
-					transform.vtrans(channels, shiftInfo, index, chunkSize);
-					return 0;
-				};
-				if(num_threads > 1)
-					results.emplace_back(ThreadPool::get()->enqueue(compressor));
-				else
-					compressor();
-			}
-			for(auto& result : results)
-			{
-				result.get();
-			}
+			ExecSingleton::forkJoin((uint32_t)num_threads,
+									[chunkSize, &channels, &shiftInfo](uint32_t index) {
+										T transform;
+										transform.vtrans(channels, shiftInfo, index, chunkSize);
+									});
 			i = chunkSize * num_threads;
 		}
 		T transform;
@@ -486,6 +729,16 @@ namespace HWY_NAMESPACE
 	{
 		return vscheduler<DecompressDcShiftRev>(channels, shiftInfo, n);
 	}
+
+	void hwy_decompress_interleaved_8(const InterleaveInfo* info)
+	{
+		interleavedScheduler<uint8_t>(info);
+	}
+
+	void hwy_decompress_interleaved_16(const InterleaveInfo* info)
+	{
+		interleavedScheduler<uint16_t>(info);
+	}
 } // namespace HWY_NAMESPACE
 } // namespace grk
 HWY_AFTER_NAMESPACE();
@@ -499,6 +752,8 @@ HWY_EXPORT(hwy_decompress_rev);
 HWY_EXPORT(hwy_decompress_irrev);
 HWY_EXPORT(hwy_decompress_dc_shift_irrev);
 HWY_EXPORT(hwy_decompress_dc_shift_rev);
+HWY_EXPORT(hwy_decompress_interleaved_8);
+HWY_EXPORT(hwy_decompress_interleaved_16);
 
 void mct::decompress_dc_shift_irrev(Tile* tile, GrkImage* image,
 									TileComponentCodingParams* tccps,
@@ -610,6 +865,51 @@ void mct::compress_irrev(Tile* tile, GrkImage* image, TileComponentCodingParams*
 	 n);
 }
 
+bool mct::decompress_interleaved(Tile* tile, GrkImage* image, TileComponentCodingParams* tccps,
+								 bool doMct, bool shifted, const InterleavedBuffer* dest)
+{
+	// all components share the same bounds, as they have the same sub-sampling
+	auto src = tile->comps->getBuffer()->bounds();
+	auto win = src.intersection(dest->bounds);
+	if(!win.non_empty())
+		return true;
+	uint32_t bytesPerSample = dest->bitsPerSample / 8U;
+	InterleaveInfo info;
+	info.width = win.width();
+	info.height = win.height();
+	info.dest = dest->data + (uint64_t)(win.y0 - dest->bounds.y0) * dest->stride +
+				(uint64_t)(win.x0 - dest->bounds.x0) * tile->numcomps * bytesPerSample;
+	info.destStride = dest->stride;
+	for(uint16_t compno = 0; compno < tile->numcomps; ++compno)
+	{
+		auto buf = tile->comps[compno].getBuffer();
+		auto samples = buf->getHighestBufferResWindowREL();
+		if(!samples->getBuffer() || !(buf->bounds() == src))
+			return false;
+		info.channels.push_back(samples->getBuffer() +
+								(uint64_t)(win.y0 - src.y0) * samples->stride + (win.x0 - src.x0));
+		info.srcStride.push_back(samples->stride);
+		genShift(compno, image, tccps, 1, info.shiftInfo);
+		// samples transformed in place are already shifted
+		if(shifted)
+			info.shiftInfo.back()._shift = 0;
+		info.irreversible.push_back(!shifted && tccps[compno].qmfbid == 0);
+	}
+	if(doMct)
+	{
+		info.mct = tccps->qmfbid == 1 ? 1 : 2;
+		// match rounding of inverse irreversible MCT, whose vector routines are disabled
+		if(info.mct == 2)
+			hwy::DisableTargets(uint32_t(~HWY_SCALAR));
+	}
+	if(dest->bitsPerSample == 8)
+		HWY_DYNAMIC_DISPATCH(hwy_decompress_interleaved_8)(&info);
+	else
+		HWY_DYNAMIC_DISPATCH(hwy_decompress_interleaved_16)(&info);
+
+	return true;
+}
+
 void mct::genShift(uint16_t compno,
 					GrkImage* image,
 					TileComponentCodingParams* tccps,
@@ -33,6 +33,29 @@ struct ShiftInfo
 	int32_t _shift;
 };
 
+/**
+ * Rows of tile samples to be transformed and packed into interleaved output
+ */
+struct InterleaveInfo
+{
+	InterleaveInfo() : mct(0), width(0), height(0), dest(nullptr), destStride(0) {}
+	// first sample of each component
+	std::vector<int32_t*> channels;
+	// stride of each component, in samples
+	std::vector<uint32_t> srcStride;
+	std::vector<ShiftInfo> shiftInfo;
+	// non-zero if component holds floating point samples
+	std::vector<uint8_t> irreversible;
+	// inverse MCT applied to first three components: 0 none, 1 reversible, 2 irreversible
+	uint8_t mct;
+	uint32_t width;
+	uint32_t height;
+	// first interleaved sample of dest
+	uint8_t* dest;
+	// dest stride, in bytes
+	uint64_t destStride;
+};
+
 class mct
 {
   public:
@@ -123,6 +146,20 @@ class mct
 	 */
 	static void decompress_dc_shift_irrev(Tile* tile, GrkImage* image,
 										  TileComponentCodingParams* tccps, uint32_t compno);
+	/**
+	 Apply inverse MCT and dc shift to a tile, clamp to component precision,
+	 and pack into interleaved 8 or 16 bit output
+	 @param tile tile
+	 @param image image
+	 @param tccps tile component coding parameters
+	 @param doMct true if inverse reversible or irreversible MCT is to be applied
+	 @param shifted true if samples have already been transformed and shifted in place
+	 @param dest interleaved output
+	 @return false if tile samples are not available
+	 */
+	static bool decompress_interleaved(Tile* tile, GrkImage* image,
+									   TileComponentCodingParams* tccps, bool doMct, bool shifted,
+									   const InterleavedBuffer* dest);
 private:
 	static void genShift(uint16_t compno,
 						GrkImage* image,
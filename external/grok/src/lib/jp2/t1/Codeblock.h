@@ -41,6 +41,23 @@ struct Segment
 	uint32_t numBytesInPacket; // number of bytes contributed by current packet
 };
 
+// state of code block segments once packets up to and including a layer have been read
+struct CodeblockLayerState
+{
+	CodeblockLayerState() : numLayers(0), numSegments(0), numPasses(0), len(0), numSegBuffers(0) {}
+	// true if both states select the same coding passes (number of layers is ignored)
+	bool sameSegments(const CodeblockLayerState& rhs) const
+	{
+		return numSegments == rhs.numSegments && numPasses == rhs.numPasses && len == rhs.len &&
+			   numSegBuffers == rhs.numSegBuffers;
+	}
+	uint16_t numLayers; // number of layers read
+	uint16_t numSegments; // number of segments
+	uint32_t numPasses; // number of passes in last segment
+	uint32_t len; // length of last segment
+	uint32_t numSegBuffers; // number of segment buffers
+};
+
 // compressing/decoding pass
 struct CodePass
 {
@@ -236,6 +253,74 @@ struct DecompressCodeblock : public Codeblock
 			delete b;
 		seg_buffers.clear();
 		numSegments = 0;
+		layerStates.clear();
+	}
+	/**
+	 * Record segment state once all packet data for a layer has been read
+	 *
+	 * @param layno layer number
+	 */
+	void readLayer(uint16_t layno)
+	{
+		auto state = getSegmentState();
+		state.numLayers = (uint16_t)(layno + 1);
+		if(!layerStates.empty() && layerStates.back().numLayers == state.numLayers)
+			layerStates.back() = state;
+		else
+			layerStates.push_back(state);
+	}
+	/**
+	 * Select coding passes for next decompress of this block. Packets beyond the
+	 * requested layers may already have been read, to support later refinement.
+	 * An open block is closed, and must be decompressed again, if the selection
+	 * differs from the one it was last decompressed with.
+	 *
+	 * @param numLayers number of layers to decompress
+	 */
+	void setNumLayersToDecompress(uint16_t numLayers)
+	{
+		auto state = getSegmentState();
+		if(!layerStates.empty() && layerStates.back().numLayers > numLayers)
+		{
+			state = CodeblockLayerState();
+			for(auto& s : layerStates)
+			{
+				if(s.numLayers > numLayers)
+					break;
+				state = s;
+			}
+		}
+		if(!state.sameSegments(decompressState) && !isClosed())
+			setCacheState(GRK_CACHE_STATE_CLOSED);
+		decompressState = state;
+	}
+	uint32_t getNumDecompressSegments(void)
+	{
+		return decompressState.numSegments;
+	}
+	/**
+	 * Get segment selected for decompress: last segment may be truncated
+	 * to fewer passes than have been read
+	 */
+	Segment getDecompressSegment(uint32_t segmentIndex)
+	{
+		auto seg = *getSegment(segmentIndex);
+		if(segmentIndex + 1 == decompressState.numSegments)
+		{
+			seg.numpasses = decompressState.numPasses;
+			seg.len = decompressState.len;
+		}
+		return seg;
+	}
+	uint32_t getNumDecompressSegBuffers(void)
+	{
+		return decompressState.numSegBuffers;
+	}
+	size_t getDecompressSegBuffersLen()
+	{
+		return std::accumulate(seg_buffers.begin(),
+							   seg_buffers.begin() + decompressState.numSegBuffers, (size_t)0,
+							   [](const size_t s, grkBufferU8* a) { return (s + a->len); });
 	}
 	size_t getSegBuffersLen()
 	{
@@ -260,6 +345,24 @@ struct DecompressCodeblock : public Codeblock
 	std::vector<grkBufferU8*> seg_buffers;
 
   private:
+	CodeblockLayerState getSegmentState(void)
+	{
+		CodeblockLayerState state;
+		state.numSegments = numSegments;
+		if(numSegments)
+		{
+			auto seg = getSegment(numSegments - 1U);
+			state.numPasses = seg->numpasses;
+			state.len = seg->len;
+		}
+		state.numSegBuffers = (uint32_t)seg_buffers.size();
+
+		return state;
+	}
+	// segment state after each layer read, in increasing layer order
+	std::vector<CodeblockLayerState> layerStates;
+	// segment state selected for decompress
+	CodeblockLayerState decompressState;
 	Segment* segs; /* information on segments */
 	uint16_t numSegments; /* number of segment in block*/
 	uint16_t numSegmentsAllocated; // number of segments allocated for segs array
@@ -128,10 +128,10 @@ namespace ojph
 		if(!cblk->area())
 			return true;
 		uint16_t stride = (uint16_t)cblk->width();
-		if(!cblk->seg_buffers.empty())
+		if(cblk->getNumDecompressSegBuffers())
 		{
 			size_t total_seg_len =
-				2 * grk_cblk_dec_compressed_data_pad_ht + cblk->getSegBuffersLen();
+				2 * grk_cblk_dec_compressed_data_pad_ht + cblk->getDecompressSegBuffersLen();
 			if(coded_data_size < total_seg_len)
 			{
 				delete[] coded_data;
@@ -139,22 +139,21 @@ namespace ojph
 				coded_data_size = (uint32_t)total_seg_len;
 				memset(coded_data, 0, grk_cblk_dec_compressed_data_pad_ht);
 			}
-			memset(coded_data + grk_cblk_dec_compressed_data_pad_ht + cblk->getSegBuffersLen(), 0,
-				   grk_cblk_dec_compressed_data_pad_ht);
+			memset(coded_data + grk_cblk_dec_compressed_data_pad_ht +
+					   cblk->getDecompressSegBuffersLen(),
+				   0, grk_cblk_dec_compressed_data_pad_ht);
 			uint8_t* actual_coded_data = coded_data + grk_cblk_dec_compressed_data_pad_ht;
 			size_t offset = 0;
-			for(auto& b : cblk->seg_buffers)
+			for(uint32_t i = 0; i < cblk->getNumDecompressSegBuffers(); ++i)
 			{
+				auto b = cblk->seg_buffers[i];
 				memcpy(actual_coded_data + offset, b->buf, b->len);
 				offset += b->len;
 			}
 
 			size_t num_passes = 0;
-			for(uint32_t i = 0; i < cblk->getNumSegments(); ++i)
-			{
-				auto sgrk = cblk->getSegment(i);
-				num_passes += sgrk->numpasses;
-			}
+			for(uint32_t i = 0; i < cblk->getNumDecompressSegments(); ++i)
+				num_passes += cblk->getDecompressSegment(i).numpasses;
 
 			bool rc = false;
 			if(num_passes && offset)
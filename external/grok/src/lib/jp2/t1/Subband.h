@@ -67,11 +67,12 @@ struct Subband : public grkRectU32
 	}
 	Precinct* getPrecinct(uint64_t precinctIndex)
 	{
-		if(precinctMap.find(precinctIndex) == precinctMap.end())
+		// lookup only, as packets of different precincts may be read concurrently
+		auto iter = precinctMap.find(precinctIndex);
+		if(iter == precinctMap.end())
 			return nullptr;
-		uint64_t index = precinctMap[precinctIndex];
 
-		return precincts[index];
+		return precincts[iter->second];
 	}
 	grkRectU32 generatePrecinctBounds(uint64_t precinctIndex, grkPointU32 precinctRegionStart,
 									  grkPointU32 precinct_expn, uint32_t precinctGridWidth)
@@ -19,8 +19,10 @@
 
 namespace grk
 {
-T1CompressScheduler::T1CompressScheduler(Tile* tile, bool needsRateControl)
-	: tile(tile), needsRateControl(needsRateControl), encodeBlocks(nullptr), blockCount(-1)
+T1CompressScheduler::T1CompressScheduler(Tile* tile, bool needsRateControl,
+										 StageStats* stats)
+	: tile(tile), needsRateControl(needsRateControl), tcp_(nullptr), maxCblkW(0), maxCblkH(0),
+	  t1Implementations(ExecSingleton::numThreads() + 1, nullptr), stats_(stats)
 {}
 T1CompressScheduler::~T1CompressScheduler()
 {
@@ -35,8 +37,9 @@ void T1CompressScheduler::scheduleCompress(TileCodingParams* tcp, const double*
 	uint8_t resno, bandIndex;
 	tile->distortion = 0;
 	std::vector<CompressBlockExec*> blocks;
-	uint32_t maxCblkW = 0;
-	uint32_t maxCblkH = 0;
+	tcp_ = tcp;
+	maxCblkW = 0;
+	maxCblkH = 0;
 
 	for(compno = 0; compno < tile->numcomps; ++compno)
 	{
@@ -88,62 +91,48 @@ void T1CompressScheduler::scheduleCompress(TileCodingParams* tcp, const double*
 			}
 		}
 	}
-	for(auto i = 0U; i < ThreadPool::get()->num_threads(); ++i)
-		t1Implementations.push_back(T1Factory::makeT1(true, tcp, maxCblkW, maxCblkH));
 	compress(&blocks);
 }
+T1Interface* T1CompressScheduler::getImplementation(void)
+{
+	auto threadId = ExecSingleton::threadId();
+	assert(threadId < t1Implementations.size());
+	// each slot is only ever accessed by its own thread
+	auto impl = t1Implementations[threadId];
+	if(!impl)
+	{
+		impl = T1Factory::makeT1(true, tcp_, maxCblkW, maxCblkH);
+		t1Implementations[threadId] = impl;
+	}
 
+	return impl;
+}
 void T1CompressScheduler::compress(std::vector<CompressBlockExec*>* blocks)
 {
 	if(!blocks || blocks->size() == 0)
 		return;
-
-	size_t num_threads = ThreadPool::get()->num_threads();
-	if(num_threads == 1)
-	{
-		auto impl = t1Implementations[0];
-		for(auto iter = blocks->begin(); iter != blocks->end(); ++iter)
+	std::atomic<uint32_t> next(0);
+	auto numBlocks = (uint32_t)blocks->size();
+	// one task per thread claims blocks until none are left; tasks are timed as a whole,
+	// so that clocks and shared stage counters are not touched for every block
+	uint32_t numTasks = (std::min<uint32_t>)(numBlocks, ExecSingleton::numThreads());
+	ExecSingleton::forkJoin(numTasks, [this, blocks, numBlocks, &next](uint32_t) {
+		StageTimer timer(stats_);
+		auto impl = getImplementation();
+		uint64_t numCompressed = 0;
+		uint32_t index;
+		while((index = next++) < numBlocks)
 		{
-			compress(impl, *iter);
-			delete *iter;
+			auto block = blocks->operator[](index);
+			timer.addBytes(compress(impl, block));
+			delete block;
+			numCompressed++;
 		}
-		return;
-	}
-	auto maxBlocks = blocks->size();
-	encodeBlocks = new CompressBlockExec*[maxBlocks];
-	for(uint64_t i = 0; i < maxBlocks; ++i)
-		encodeBlocks[i] = blocks->operator[](i);
+		timer.setCount(numCompressed);
+	});
 	blocks->clear();
-	std::vector<std::future<int>> results;
-	for(size_t i = 0; i < num_threads; ++i)
-	{
-		results.emplace_back(ThreadPool::get()->enqueue([this, maxBlocks] {
-			auto threadnum = ThreadPool::get()->thread_number(std::this_thread::get_id());
-			while(compress((size_t)threadnum, maxBlocks))
-			{
-			}
-			return 0;
-		}));
-	}
-	for(auto& result : results)
-	{
-		result.get();
-	}
-	delete[] encodeBlocks;
 }
-bool T1CompressScheduler::compress(size_t threadId, uint64_t maxBlocks)
-{
-	auto impl = t1Implementations[threadId];
-	uint64_t index = (uint64_t)++blockCount;
-	if(index >= maxBlocks)
-		return false;
-	auto block = encodeBlocks[index];
-	compress(impl, block);
-	delete block;
-
-	return true;
-}
-void T1CompressScheduler::compress(T1Interface* impl, CompressBlockExec* block)
+uint64_t T1CompressScheduler::compress(T1Interface* impl, CompressBlockExec* block)
 {
 	block->open(impl);
 	if(needsRateControl)
@@ -151,6 +140,9 @@ void T1CompressScheduler::compress(T1Interface* impl, CompressBlockExec* block)
 		std::unique_lock<std::mutex> lk(distortion_mutex);
 		tile->distortion += block->distortion;
 	}
+	auto cblk = block->cblk;
+
+	return cblk->numPassesTotal ? cblk->passes[cblk->numPassesTotal - 1].rate : 0;
 }
 
 } // namespace grk
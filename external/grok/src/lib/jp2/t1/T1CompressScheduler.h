@@ -24,23 +24,26 @@ namespace grk
 class T1CompressScheduler
 {
   public:
-	T1CompressScheduler(Tile* tile, bool needsRateControl);
+	T1CompressScheduler(Tile* tile, bool needsRateControl, StageStats* stats);
 	~T1CompressScheduler();
 	void compress(std::vector<CompressBlockExec*>* blocks);
 
 	void scheduleCompress(TileCodingParams* tcp, const double* mct_norms, uint16_t mct_numcomps);
 
   private:
-	bool compress(size_t threadId, uint64_t maxBlocks);
-	void compress(T1Interface* impl, CompressBlockExec* block);
+	T1Interface* getImplementation(void);
+	// returns number of compressed bytes of block
+	uint64_t compress(T1Interface* impl, CompressBlockExec* block);
 
 	Tile* tile;
-	std::vector<T1Interface*> t1Implementations;
 	mutable std::mutex distortion_mutex;
 	bool needsRateControl;
-	mutable std::mutex block_mutex;
-	CompressBlockExec** encodeBlocks;
-	std::atomic<int64_t> blockCount;
+	TileCodingParams* tcp_;
+	uint32_t maxCblkW;
+	uint32_t maxCblkH;
+	// one coder per executor thread, plus one for the calling thread
+	std::vector<T1Interface*> t1Implementations;
+	StageStats* stats_;
 };
 
 } // namespace grk
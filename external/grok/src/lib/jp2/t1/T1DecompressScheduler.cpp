@@ -18,152 +18,135 @@
 
 namespace grk
 {
-T1DecompressScheduler::T1DecompressScheduler() : success(true), decodeBlocks(nullptr) {}
+T1DecompressScheduler::T1DecompressScheduler(TileCodingParams* tcp, uint16_t blockw,
+											 uint16_t blockh, StageStats* stats,
+											 DecompressContext* context)
+	: tcp_(tcp),
+	  // nominal code block dimensions
+	  codeblock_width((uint16_t)(blockw ? (uint32_t)1 << blockw : 0)),
+	  codeblock_height((uint16_t)(blockh ? (uint32_t)1 << blockh : 0)),
+	  t1Implementations(ExecSingleton::numThreads() + 1, nullptr), stats_(stats), context_(context)
+{}
 T1DecompressScheduler::~T1DecompressScheduler()
 {
 	for(auto& t : t1Implementations)
 		delete t;
 }
-bool T1DecompressScheduler::prepareScheduleDecompress(TileComponent* tilec,
-													  TileComponentCodingParams* tccp,
-													  std::vector<DecompressBlockExec*>* blocks)
+T1Interface* T1DecompressScheduler::getImplementation(void)
 {
-	if(!tilec->getBuffer()->alloc())
+	if(context_)
 	{
-		GRK_ERROR("Not enough memory for tile data");
-		return false;
+		auto impl = context_->getCoder(tcp_, codeblock_width, codeblock_height);
+		if(impl)
+			return impl;
+	}
+	auto threadId = ExecSingleton::threadId();
+	assert(threadId < t1Implementations.size());
+	// each slot is only ever accessed by its own thread
+	auto impl = t1Implementations[threadId];
+	if(!impl)
+	{
+		impl = T1Factory::makeT1(false, tcp_, codeblock_width, codeblock_height);
+		t1Implementations[threadId] = impl;
 	}
+
+	return impl;
+}
+std::vector<DecompressBlockExec>* T1DecompressScheduler::acquireBlocks(void)
+{
+	return context_ ? context_->acquireBlocks() : new std::vector<DecompressBlockExec>();
+}
+void T1DecompressScheduler::releaseBlocks(std::vector<DecompressBlockExec>* blocks)
+{
+	if(context_)
+		context_->releaseBlocks(blocks);
+	else
+		delete blocks;
+}
+bool T1DecompressScheduler::prepareScheduleDecompress(TileComponent* tilec,
+													  TileComponentCodingParams* tccp,
+													  uint8_t resno,
+													  std::vector<DecompressBlockExec>* blocks)
+{
 	bool wholeTileDecoding = tilec->isWholeTileDecoding();
-	for(uint8_t resno = 0; resno < tilec->resolutions_to_decompress; ++resno)
+	assert(resno < tilec->resolutions_to_decompress);
+	auto res = &tilec->tileCompResolution[resno];
+	for(uint8_t bandIndex = 0; bandIndex < res->numTileBandWindows; ++bandIndex)
 	{
-		auto res = &tilec->tileCompResolution[resno];
-		for(uint8_t bandIndex = 0; bandIndex < res->numTileBandWindows; ++bandIndex)
+		auto band = res->tileBand + bandIndex;
+		auto paddedBandWindow =
+			tilec->getBuffer()->getPaddedBandWindow(resno, band->orientation);
+		for(auto precinct : band->precincts)
 		{
-			auto band = res->tileBand + bandIndex;
-			auto paddedBandWindow =
-				tilec->getBuffer()->getPaddedBandWindow(resno, band->orientation);
-			for(auto precinct : band->precincts)
+			if(!wholeTileDecoding && !paddedBandWindow->non_empty_intersection(precinct))
+				continue;
+			for(uint64_t cblkno = 0; cblkno < precinct->getNumCblks(); ++cblkno)
 			{
-				if(!wholeTileDecoding && !paddedBandWindow->non_empty_intersection(precinct))
-					continue;
-				for(uint64_t cblkno = 0; cblkno < precinct->getNumCblks(); ++cblkno)
+				auto cblkBounds = precinct->getCodeBlockBounds(cblkno);
+				if(wholeTileDecoding || paddedBandWindow->non_empty_intersection(&cblkBounds))
 				{
-					auto cblkBounds = precinct->getCodeBlockBounds(cblkno);
-					if(wholeTileDecoding || paddedBandWindow->non_empty_intersection(&cblkBounds))
-					{
-						auto cblk = precinct->getDecompressedBlockPtr(cblkno);
-						auto block = new DecompressBlockExec();
-						block->x = cblk->x0;
-						block->y = cblk->y0;
-						block->tilec = tilec;
-						block->bandIndex = bandIndex;
-						block->bandNumbps = band->numbps;
-						block->bandOrientation = band->orientation;
-						block->cblk = cblk;
-						block->cblk_sty = tccp->cblk_sty;
-						block->qmfbid = tccp->qmfbid;
-						block->resno = resno;
-						block->roishift = tccp->roishift;
-						block->stepsize = band->stepsize;
-						block->k_msbs = (uint8_t)(band->numbps - cblk->numbps);
-						blocks->push_back(block);
-					}
+					auto cblk = precinct->getDecompressedBlockPtr(cblkno);
+					cblk->setNumLayersToDecompress(tcp_->numLayersToDecompress);
+					blocks->emplace_back();
+					auto block = &blocks->back();
+					block->x = cblk->x0;
+					block->y = cblk->y0;
+					block->tilec = tilec;
+					block->bandIndex = bandIndex;
+					block->bandNumbps = band->numbps;
+					block->bandOrientation = band->orientation;
+					block->cblk = cblk;
+					block->cblk_sty = tccp->cblk_sty;
+					block->qmfbid = tccp->qmfbid;
+					block->resno = resno;
+					block->roishift = tccp->roishift;
+					block->stepsize = band->stepsize;
+					block->k_msbs = (uint8_t)(band->numbps - cblk->numbps);
 				}
 			}
 		}
 	}
 	return true;
 }
-bool T1DecompressScheduler::scheduleDecompress(TileCodingParams* tcp, uint16_t blockw,
-											   uint16_t blockh,
-											   std::vector<DecompressBlockExec*>* blocks)
-{
-	// nominal code block dimensions
-	uint16_t codeblock_width = (uint16_t)(blockw ? (uint32_t)1 << blockw : 0);
-	uint16_t codeblock_height = (uint16_t)(blockh ? (uint32_t)1 << blockh : 0);
-	for(auto i = 0U; i < ThreadPool::get()->num_threads(); ++i)
-		t1Implementations.push_back(
-			T1Factory::makeT1(false, tcp, codeblock_width, codeblock_height));
-
-	return decompress(blocks);
-}
 bool T1DecompressScheduler::decompressBlock(T1Interface* impl, DecompressBlockExec* block)
 {
 	try
 	{
-		bool rc = block->open(impl);
-		delete block;
-		return rc;
+		return block->open(impl);
 	}
 	catch(std::runtime_error& rerr)
 	{
-		delete block;
 		GRK_ERROR(rerr.what());
 		return false;
 	}
 
 	return true;
 }
-bool T1DecompressScheduler::decompress(std::vector<DecompressBlockExec*>* blocks)
+bool T1DecompressScheduler::decompress(std::vector<DecompressBlockExec>* blocks)
 {
 	if(!blocks || !blocks->size())
 		return true;
-	size_t num_threads = ThreadPool::get()->num_threads();
-	success = true;
-	if(num_threads == 1)
-	{
-		for(size_t i = 0; i < blocks->size(); ++i)
+	std::atomic_bool success(true);
+	std::atomic<uint32_t> next(0);
+	auto numBlocks = (uint32_t)blocks->size();
+	// one task per thread claims blocks until none are left; tasks are timed as a whole,
+	// so that clocks and shared stage counters are not touched for every block
+	uint32_t numTasks = (std::min<uint32_t>)(numBlocks, ExecSingleton::numThreads());
+	ExecSingleton::forkJoin(numTasks, [this, blocks, numBlocks, &next, &success](uint32_t) {
+		StageTimer timer(stats_);
+		auto impl = getImplementation();
+		uint64_t numDecompressed = 0;
+		uint32_t index;
+		while(success && (index = next++) < numBlocks)
 		{
-			auto block = blocks->operator[](i);
-			if(!success)
-			{
-				delete block;
-			}
-			else
-			{
-				auto impl = t1Implementations[(size_t)0];
-				if(!decompressBlock(impl, block))
-					success = false;
-			}
+			auto block = &blocks->operator[](index);
+			timer.addBytes(block->cblk->getDecompressSegBuffersLen());
+			if(!decompressBlock(impl, block))
+				success = false;
+			numDecompressed++;
 		}
-		return success;
-	}
-	auto maxBlocks = blocks->size();
-	decodeBlocks = new DecompressBlockExec*[maxBlocks];
-	for(uint64_t i = 0; i < maxBlocks; ++i)
-		decodeBlocks[i] = blocks->operator[](i);
-	std::atomic<int> blockCount(-1);
-	std::vector<std::future<int>> results;
-	for(size_t i = 0; i < num_threads; ++i)
-	{
-		results.emplace_back(ThreadPool::get()->enqueue([this, maxBlocks, &blockCount] {
-			auto threadnum = ThreadPool::get()->thread_number(std::this_thread::get_id());
-			assert(threadnum >= 0);
-			while(true)
-			{
-				uint64_t index = (uint64_t)++blockCount;
-				// note: even after failure, we continue to read and delete
-				// blocks until index is out of bounds. Otherwise, we leak blocks.
-				if(index >= maxBlocks)
-					return 0;
-				auto block = decodeBlocks[index];
-				if(!success)
-				{
-					delete block;
-					continue;
-				}
-				auto impl = t1Implementations[(size_t)threadnum];
-				if(!decompressBlock(impl, block))
-					success = false;
-			}
-			return 0;
-		}));
-	}
-	for(auto& result : results)
-	{
-		result.get();
-	}
-	delete[] decodeBlocks;
+		timer.setCount(numDecompressed);
+	});
 
 	return success;
 }
@@ -23,26 +23,40 @@ namespace grk
 {
 struct DecompressBlockExec;
 class T1Interface;
+class DecompressContext;
 
+/**
+ * Schedules code block decompression for a tile.
+ *
+ * A single scheduler is shared by all per-resolution T1 tasks of a tile.
+ * Coder state is kept per executor thread, so tasks for different
+ * resolutions and components may run concurrently. If a decompress
+ * context is present, coders and block lists are taken from the context
+ * and survive the scheduler.
+ */
 class T1DecompressScheduler
 {
   public:
-	T1DecompressScheduler(void);
+	T1DecompressScheduler(TileCodingParams* tcp, uint16_t blockw, uint16_t blockh,
+						  StageStats* stats, DecompressContext* context);
 	~T1DecompressScheduler();
-	bool decompress(std::vector<DecompressBlockExec*>* blocks);
+	bool decompress(std::vector<DecompressBlockExec>* blocks);
 
 	bool prepareScheduleDecompress(TileComponent* tilec, TileComponentCodingParams* tccp,
-								   std::vector<DecompressBlockExec*>* blocks);
-
-	bool scheduleDecompress(TileCodingParams* tcp, uint16_t blockw, uint16_t blockh,
-							std::vector<DecompressBlockExec*>* blocks);
+								   uint8_t resno, std::vector<DecompressBlockExec>* blocks);
+	std::vector<DecompressBlockExec>* acquireBlocks(void);
+	void releaseBlocks(std::vector<DecompressBlockExec>* blocks);
 
   private:
+	T1Interface* getImplementation(void);
 	bool decompressBlock(T1Interface* impl, DecompressBlockExec* block);
+	TileCodingParams* tcp_;
+	uint16_t codeblock_width;
+	uint16_t codeblock_height;
+	// one coder per executor thread, plus one for the calling thread
 	std::vector<T1Interface*> t1Implementations;
-	std::atomic_bool success;
-
-	DecompressBlockExec** decodeBlocks;
+	StageStats* stats_;
+	DecompressContext* context_;
 };
 
 } // namespace grk
@@ -134,19 +134,26 @@ namespace t1_part1
 	bool T1Part1::decompress(DecompressBlockExec* block)
 	{
 		auto cblk = block->cblk;
+		// a closed block may still hold samples from an earlier decompress
+		bool stale = cblk->getBuffer() != nullptr;
 		cblk->alloc2d(true);
 		t1->attachUncompressedData(cblk->getBuffer(), cblk->width(), cblk->height());
 		if(cblk->isClosed())
 		{
-			if(!cblk->seg_buffers.empty())
+			uint32_t numSegBuffers = cblk->getNumDecompressSegBuffers();
+			if(stale && cblk->getBuffer())
+				memset(cblk->getBuffer(), 0,
+					   (size_t)cblk->stride * cblk->height() * sizeof(int32_t));
+			if(numSegBuffers)
 			{
 				size_t totalSegLen =
-					cblk->getSegBuffersLen() + grk_cblk_dec_compressed_data_pad_right;
+					cblk->getDecompressSegBuffersLen() + grk_cblk_dec_compressed_data_pad_right;
 				t1->allocCompressedData(totalSegLen);
 				size_t offset = 0;
 				auto compressedData = t1->getCompressedDataBuffer();
-				for(auto& b : cblk->seg_buffers)
+				for(uint32_t i = 0; i < numSegBuffers; ++i)
 				{
+					auto b = cblk->seg_buffers[i];
 					memcpy(compressedData + offset, b->buf, b->len);
 					offset += b->len;
 				}
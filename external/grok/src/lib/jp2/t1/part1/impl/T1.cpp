@@ -1378,9 +1378,9 @@ bool T1::decompress_cblk(DecompressCodeblock* cblk, uint8_t* compressedData, uin
 	uint32_t passtype = 2;
 	mqc_resetstates(mqc);
 
-	for(uint32_t segno = 0; segno < cblk->getNumSegments(); ++segno)
+	for(uint32_t segno = 0; segno < cblk->getNumDecompressSegments(); ++segno)
 	{
-		auto seg = cblk->getSegment(segno);
+		auto seg = cblk->getDecompressSegment(segno);
 		/* BYPASS mode */
 		uint8_t type = ((bpno_plus_one <= ((int32_t)(cblk->numbps)) - 4) && (passtype < 2) &&
 						(cblksty & GRK_CBLKSTY_LAZY))
@@ -1389,14 +1389,14 @@ bool T1::decompress_cblk(DecompressCodeblock* cblk, uint8_t* compressedData, uin
 
 		if(type == T1_TYPE_RAW)
 		{
-			mqc_raw_init_dec(mqc, compressedData + cblkdataindex, seg->len);
+			mqc_raw_init_dec(mqc, compressedData + cblkdataindex, seg.len);
 		}
 		else
 		{
-			mqc_init_dec(mqc, compressedData + cblkdataindex, seg->len);
+			mqc_init_dec(mqc, compressedData + cblkdataindex, seg.len);
 		}
-		cblkdataindex += seg->len;
-		for(uint32_t passno = 0; (passno < seg->numpasses) && (bpno_plus_one >= 1); ++passno)
+		cblkdataindex += seg.len;
+		for(uint32_t passno = 0; (passno < seg.numpasses) && (bpno_plus_one >= 1); ++passno)
 		{
 			switch(passtype)
 			{
@@ -19,6 +19,9 @@
  *
  */
 #include "grk_includes.h"
+#include <atomic>
+#include <map>
+#include <tuple>
 
 //#define DEBUG_DECOMPRESS_PACKETS
 
@@ -52,16 +55,19 @@ void T2Decompress::initSegment(DecompressCodeblock* cblk, uint32_t index, uint8_
 		seg->maxpasses = maxPassesPerSegmentJ2K;
 	}
 }
-bool T2Decompress::processPacket(TileCodingParams* tcp, PacketIter* currPi, SparseBuffer* srcBuf)
+bool T2Decompress::processPacket(TileCodingParams* tcp, PacketIter* currPi, SparseBuffer* srcBuf,
+								 bool* truncated)
 {
-	auto tilec = tileProcessor->tile->comps + currPi->compno;
+	auto tile = tileProcessor->tile;
+	auto tilec = tile->comps + currPi->compno;
 	auto tilecBuffer = tilec->getBuffer();
 	auto packetInfo = tileProcessor->packetLengthCache.next();
 	if(!packetInfo)
 		return false;
 	auto res = tilec->tileCompResolution + currPi->resno;
-	auto skipPacket = currPi->layno >= tcp->numLayersToDecompress ||
-					  currPi->resno >= tilec->resolutions_to_decompress;
+	bool beyondRequest = currPi->layno >= tcp->numLayersToDecompress ||
+						 currPi->resno >= tilec->resolutions_to_decompress;
+	auto skipPacket = beyondRequest;
 	if(!skipPacket)
 	{
 		if(!tilec->isWholeTileDecoding())
@@ -96,30 +102,129 @@ bool T2Decompress::processPacket(TileCodingParams* tcp, PacketIter* currPi, Spar
 				return false;
 		}
 	}
-	if(!skipPacket)
+	PacketId id(currPi, tile->numProcessedPackets);
+	auto packetLength = packetInfo->packetLength;
+	// packet lies within the current chunk, so it can be located
+	// without parsing its header
+	bool indexPacket = packetLength && packetLength <= srcBuf->getCurrentChunkLength() &&
+					   !tileProcessor->m_cp->ppm_marker && !tcp->ppt;
+	if(!skipPacket && indexPacket)
 	{
-		if(!decompressPacket(tcp, currPi, srcBuf, packetInfo, false))
-			return false;
-		tilec->resolutions_decompressed =
-			std::max<uint8_t>(currPi->resno, tilec->resolutions_decompressed);
-		tileProcessor->tile->numDecompressedPackets++;
+		indexedPackets.push_back(IndexedPacket(id, srcBuf->getCurrentChunkPtr(), packetInfo));
+		srcBuf->incrementCurrentChunkOffset(packetLength);
+	}
+	else if(skipPacket && packetLength)
+	{
+		srcBuf->incrementCurrentChunkOffset(packetLength);
 	}
 	else
 	{
-		if(packetInfo->packetLength)
-			srcBuf->incrementCurrentChunkOffset(packetInfo->packetLength);
-		else if(!decompressPacket(tcp, currPi, srcBuf, packetInfo, true))
+		// packet must be parsed in sequence, so indexed packets that precede it are parsed first
+		if(!decompressIndexedPackets(tcp, truncated))
+			return false;
+		if(*truncated)
+			return true;
+		// if skipped, header must be read to find the packet length; when refining, its data
+		// is read as well, so that code block state stays consistent for a later refine
+		bool skipData = skipPacket && !tileProcessor->refining;
+		if(!decompressPacket(tcp, &id, srcBuf, packetInfo, skipData))
 			return false;
+		if(skipData && beyondRequest)
+			tileProcessor->skippedPacketData = true;
+		if(!skipPacket)
+		{
+			tilec->resolutions_decompressed =
+				std::max<uint8_t>(currPi->resno, tilec->resolutions_decompressed);
+			tile->numDecompressedPackets++;
+		}
 	}
-	tileProcessor->tile->numProcessedPackets++;
+	tile->numProcessedPackets++;
 
 	return true;
 }
+bool T2Decompress::decompressIndexedPackets(TileCodingParams* tcp, bool* truncated)
+{
+	if(indexedPackets.empty())
+		return true;
+	// group packets by precinct, preserving layer order within each precinct
+	std::map<std::tuple<uint16_t, uint8_t, uint64_t>, size_t> precinctRun;
+	std::vector<std::vector<IndexedPacket*>> runs;
+	for(auto& packet : indexedPackets)
+	{
+		auto key = std::make_tuple(packet.id.compno, packet.id.resno, packet.id.precinctIndex);
+		auto iter = precinctRun.find(key);
+		if(iter == precinctRun.end())
+		{
+			iter = precinctRun.emplace(key, runs.size()).first;
+			runs.emplace_back();
+		}
+		runs[iter->second].push_back(&packet);
+	}
+	std::vector<size_t> numParsed(runs.size(), 0);
+	std::atomic<bool> error(false);
+	std::atomic<bool> stop(false);
+	uint16_t tileIndex = tileProcessor->m_tileIndex;
+	ExecSingleton::forkJoin((uint32_t)runs.size(), [&](uint32_t runIndex) {
+		for(auto packet : runs[runIndex])
+		{
+			if(error)
+				return;
+			auto id = &packet->id;
+			SparseBuffer packetBuf;
+			packetBuf.pushBack(packet->data, packet->packetInfo->packetLength, false);
+			try
+			{
+				if(!decompressPacket(tcp, id, &packetBuf, packet->packetInfo, false))
+				{
+					error = true;
+					return;
+				}
+			}
+			catch(TruncatedPacketHeaderException& tex)
+			{
+				GRK_UNUSED(tex);
+				GRK_WARN("Truncated packet: tile=%d component=%02d resolution=%02d precinct=%03d "
+						 "layer=%02d",
+						 tileIndex, id->compno, id->resno, id->precinctIndex, id->layno);
+				stop = true;
+				return;
+			}
+			catch(CorruptPacketHeaderException& cex)
+			{
+				GRK_UNUSED(cex);
+				GRK_WARN("Corrupt packet: tile=%d component=%02d resolution=%02d precinct=%03d "
+						 "layer=%02d",
+						 tileIndex, id->compno, id->resno, id->precinctIndex, id->layno);
+				stop = true;
+				return;
+			}
+			numParsed[runIndex]++;
+		}
+	});
+	auto tile = tileProcessor->tile;
+	for(size_t i = 0; i < runs.size(); ++i)
+	{
+		for(size_t j = 0; j < numParsed[i]; ++j)
+		{
+			auto id = &runs[i][j]->id;
+			auto tilec = tile->comps + id->compno;
+			tilec->resolutions_decompressed =
+				std::max<uint8_t>(id->resno, tilec->resolutions_decompressed);
+			tile->numDecompressedPackets++;
+		}
+	}
+	indexedPackets.clear();
+	if(stop)
+		*truncated = true;
+
+	return !error;
+}
 bool T2Decompress::decompressPackets(uint16_t tile_no, SparseBuffer* srcBuf, bool* stopProcessionPackets)
 {
 	auto cp = tileProcessor->m_cp;
 	auto tcp = cp->tcps + tile_no;
 	*stopProcessionPackets = false;
+	indexedPackets.clear();
 	PacketManager packetManager(false, tileProcessor->headerImage, cp, tile_no, FINAL_PASS,
 								tileProcessor);
 	tileProcessor->packetLengthCache.rewind();
@@ -141,8 +246,10 @@ bool T2Decompress::decompressPackets(uint16_t tile_no, SparseBuffer* srcBuf, boo
 			}
 			try
 			{
-				if(!processPacket(tcp, currPi, srcBuf))
+				if(!processPacket(tcp, currPi, srcBuf, stopProcessionPackets))
 					return false;
+				if(*stopProcessionPackets)
+					break;
 			}
 			catch(TruncatedPacketHeaderException& tex)
 			{
@@ -169,16 +276,22 @@ bool T2Decompress::decompressPackets(uint16_t tile_no, SparseBuffer* srcBuf, boo
 		if(*stopProcessionPackets)
 			break;
 	}
+	// packets that were indexed before the end of the tile, or before it was truncated
+	bool truncated = false;
+	if(!decompressIndexedPackets(tcp, &truncated))
+		return false;
+	if(truncated)
+		*stopProcessionPackets = true;
 	if(tileProcessor->tile->numDecompressedPackets == 0)
 		GRK_WARN("T2Decompress: no packets for tile %d were successfully read", tile_no);
 
 	return tileProcessor->tile->numDecompressedPackets > 0;
 }
-bool T2Decompress::decompressPacket(TileCodingParams* tcp, const PacketIter* pi,
+bool T2Decompress::decompressPacket(TileCodingParams* tcp, const PacketId* id,
 									SparseBuffer* srcBuf, PacketInfo* packetInfo, bool skipData)
 {
 	auto tile = tileProcessor->tile;
-	auto res = tile->comps[pi->compno].tileCompResolution + pi->resno;
+	auto res = tile->comps[id->compno].tileCompResolution + id->resno;
 	bool dataPresent;
 	uint32_t packetDataBytes = 0;
 	uint32_t packetBytes = 0;
@@ -191,7 +304,7 @@ bool T2Decompress::decompressPacket(TileCodingParams* tcp, const PacketIter* pi,
 	}
 	else
 	{
-		if(!readPacketHeader(tcp, pi, &dataPresent, srcBuf, &packetBytes, &packetDataBytes))
+		if(!readPacketHeader(tcp, id, &dataPresent, srcBuf, &packetBytes, &packetDataBytes))
 			return false;
 		packetInfo->headerLength = packetBytes;
 		packetInfo->packetLength = packetBytes + packetDataBytes;
@@ -205,7 +318,7 @@ bool T2Decompress::decompressPacket(TileCodingParams* tcp, const PacketIter* pi,
 		}
 		else
 		{
-			if(!readPacketData(res, pi, srcBuf))
+			if(!readPacketData(res, id, srcBuf))
 				return false;
 			packetInfo->parsedData = true;
 		}
@@ -213,12 +326,12 @@ bool T2Decompress::decompressPacket(TileCodingParams* tcp, const PacketIter* pi,
 
 	return true;
 }
-bool T2Decompress::readPacketHeader(TileCodingParams* p_tcp, const PacketIter* p_pi,
+bool T2Decompress::readPacketHeader(TileCodingParams* p_tcp, const PacketId* id,
 									bool* p_is_data_present, SparseBuffer* srcBuf,
 									uint32_t* dataRead, uint32_t* packetDataBytes)
 {
 	auto tilePtr = tileProcessor->tile;
-	auto res = tilePtr->comps[p_pi->compno].tileCompResolution + p_pi->resno;
+	auto res = tilePtr->comps[id->compno].tileCompResolution + id->resno;
 	auto p_src_data = srcBuf->getCurrentChunkPtr();
 	size_t available_bytes = srcBuf->getCurrentChunkLength();
 	auto active_src = p_src_data;
@@ -238,10 +351,11 @@ bool T2Decompress::readPacketHeader(TileCodingParams* p_tcp, const PacketIter* p
 		{
 			uint16_t numIteratedPackets =
 				(uint16_t)(((uint16_t)active_src[4] << 8) | active_src[5]);
-			if(numIteratedPackets != (tilePtr->numProcessedPackets % 0x10000))
+			auto expectedPackets = (uint16_t)(id->sequence % 0x10000);
+			if(numIteratedPackets != expectedPackets)
 			{
 				GRK_ERROR("SOP marker packet counter %u does not match expected counter %u",
-						  numIteratedPackets, tilePtr->numProcessedPackets);
+						  numIteratedPackets, expectedPackets);
 				throw CorruptPacketHeaderException();
 			}
 			active_src += 6;
@@ -274,7 +388,7 @@ bool T2Decompress::readPacketHeader(TileCodingParams* p_tcp, const PacketIter* p
 	auto header_data = *header_data_start;
 	uint32_t present = 0;
 	std::unique_ptr<BitIO> bio(new BitIO(header_data, *remaining_length, false));
-	auto tccp = p_tcp->tccps + p_pi->compno;
+	auto tccp = p_tcp->tccps + id->compno;
 	try
 	{
 		bio->read(&present, 1);
@@ -286,7 +400,7 @@ bool T2Decompress::readPacketHeader(TileCodingParams* p_tcp, const PacketIter* p
 				auto band = res->tileBand + bandIndex;
 				if(band->isEmpty())
 					continue;
-				auto prc = band->getPrecinct(p_pi->precinctIndex);
+				auto prc = band->getPrecinct(id->precinctIndex);
 				if(!prc)
 					continue;
 				for(uint64_t cblkno = 0; cblkno < prc->getNumCblks(); cblkno++)
@@ -299,9 +413,9 @@ bool T2Decompress::readPacketHeader(TileCodingParams* p_tcp, const PacketIter* p
 					if(!cblk || !cblk->numlenbits)
 					{
 						uint16_t value;
-						prc->getInclTree()->decodeValue(bio.get(), cblkno, p_pi->layno + 1, &value);
+						prc->getInclTree()->decodeValue(bio.get(), cblkno, id->layno + 1, &value);
 						if(value != prc->getInclTree()->getUninitializedValue() &&
-						   value != p_pi->layno)
+						   value != id->layno)
 						{
 							GRK_WARN("Tile number: %u", tileProcessor->m_tileIndex + 1);
 							std::string msg =
@@ -320,7 +434,7 @@ bool T2Decompress::readPacketHeader(TileCodingParams* p_tcp, const PacketIter* p
 							GRK_WARN("%s", msg.c_str());
 							tileProcessor->setCorruptPacket();
 						}
-						included = (value <= p_pi->layno) ? 1 : 0;
+						included = (value <= id->layno) ? 1 : 0;
 					}
 					/* else one bit */
 					else
@@ -499,14 +613,14 @@ bool T2Decompress::readPacketHeader(TileCodingParams* p_tcp, const PacketIter* p
 
 	return true;
 }
-bool T2Decompress::readPacketData(Resolution* res, const PacketIter* p_pi, SparseBuffer* srcBuf)
+bool T2Decompress::readPacketData(Resolution* res, const PacketId* id, SparseBuffer* srcBuf)
 {
 	for(uint32_t bandIndex = 0; bandIndex < res->numTileBandWindows; ++bandIndex)
 	{
 		auto band = res->tileBand + bandIndex;
 		if(band->isEmpty())
 			continue;
-		auto prc = band->getPrecinct(p_pi->precinctIndex);
+		auto prc = band->getPrecinct(id->precinctIndex);
 		if(!prc)
 			continue;
 		for(uint64_t cblkno = 0; cblkno < prc->getNumCblks(); ++cblkno)
@@ -559,6 +673,7 @@ bool T2Decompress::readPacketData(Resolution* res, const PacketIter* p_pi, Spars
 				if(numPassesInPacket > 0)
 					seg = cblk->nextSegment();
 			} while(numPassesInPacket > 0);
+			cblk->readLayer(id->layno);
 		} /* next code_block */
 	}
 
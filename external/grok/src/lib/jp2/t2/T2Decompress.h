@@ -18,10 +18,43 @@
 
 #pragma once
 
+#include <vector>
+
 namespace grk
 {
 struct TileProcessor;
 
+/**
+ Packet identity, and its position in the tile's packet sequence
+ */
+struct PacketId
+{
+	PacketId(const PacketIter* pi, uint64_t seq)
+		: compno(pi->compno), resno(pi->resno), precinctIndex(pi->precinctIndex), layno(pi->layno),
+		  sequence(seq)
+	{}
+	uint16_t compno;
+	uint8_t resno;
+	uint64_t precinctIndex;
+	uint16_t layno;
+	// checked against SOP marker packet counter
+	uint64_t sequence;
+};
+
+/**
+ Packet of known length, whose parsing is deferred until the packets
+ of its tile have been indexed
+ */
+struct IndexedPacket
+{
+	IndexedPacket(PacketId packetId, uint8_t* packetData, PacketInfo* info)
+		: id(packetId), data(packetData), packetInfo(info)
+	{}
+	PacketId id;
+	uint8_t* data;
+	PacketInfo* packetInfo;
+};
+
 /**
  Tier-2 decoding
  */
@@ -39,19 +72,37 @@ struct T2Decompress
 
   private:
 	TileProcessor* tileProcessor;
+	/**
+	 Packets whose lengths are known from PLT/PLM markers, or from an earlier
+	 decompress, are indexed rather than parsed as they are iterated.
+	 Packet header state belongs to a precinct, so indexed packets
+	 are parsed in parallel, one precinct per job.
+	 */
+	std::vector<IndexedPacket> indexedPackets;
+	/**
+	 Parse all indexed packets
+	 @param tcp 		Tile coding parameters
+	 @param truncated set to true if a packet is truncated or corrupt
+	 @return false if an error occurred
+	 */
+	bool decompressIndexedPackets(TileCodingParams* tcp, bool* truncated);
 	/**
 	 Decompress a packet of a tile from a source buffer
 	 @param tcp 		Tile coding parameters
-	 @param pi 			Packet iterator
+	 @param id 			packet id
 	 @param srcBuf 	source buffer
+	 @param packetInfo packet info: header and data that were read by
+	 an earlier decompress of the tile are skipped
+	 @param skipData true if only the packet header is read
 	 @return  true if packet was successfully decompressed
 	 */
-	bool decompressPacket(TileCodingParams* tcp, const PacketIter* pi, SparseBuffer* srcBuf,
+	bool decompressPacket(TileCodingParams* tcp, const PacketId* id, SparseBuffer* srcBuf,
 						  PacketInfo* packetInfo, bool skipData);
-	bool processPacket(TileCodingParams* tcp, PacketIter* pi, SparseBuffer* srcBuf);
-	bool readPacketHeader(TileCodingParams* p_tcp, const PacketIter* p_pi, bool* dataPresent,
+	bool processPacket(TileCodingParams* tcp, PacketIter* pi, SparseBuffer* srcBuf,
+					   bool* truncated);
+	bool readPacketHeader(TileCodingParams* p_tcp, const PacketId* id, bool* dataPresent,
 						  SparseBuffer* srcBuf, uint32_t* dataRead, uint32_t* packetDataBytes);
-	bool readPacketData(Resolution* l_res, const PacketIter* p_pi, SparseBuffer* srcBuf);
+	bool readPacketData(Resolution* l_res, const PacketId* id, SparseBuffer* srcBuf);
 	void initSegment(DecompressCodeblock* cblk, uint32_t index, uint8_t cblk_sty, bool first);
 };
 
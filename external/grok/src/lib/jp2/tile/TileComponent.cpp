@@ -37,6 +37,11 @@ TileComponent::TileComponent()
 {}
 
 TileComponent::~TileComponent()
+{
+	deallocResolutions();
+	deallocBuffers();
+}
+void TileComponent::deallocResolutions(void)
 {
 	if(tileCompResolution)
 	{
@@ -52,8 +57,8 @@ TileComponent::~TileComponent()
 			}
 		}
 		delete[] tileCompResolution;
+		tileCompResolution = nullptr;
 	}
-	deallocBuffers();
 }
 void TileComponent::deallocBuffers(void)
 {
@@ -71,6 +76,8 @@ bool TileComponent::init(bool isCompressor, bool whole_tile, grkRectU32 unreduce
 						 uint8_t prec, CodingParams* cp,
 						 TileComponentCodingParams* tccp, grk_plugin_tile* current_plugin_tile)
 {
+	// component may be re-initialized for a new decompress
+	deallocResolutions();
 	m_is_encoder = isCompressor;
 	wholeTileDecompress = whole_tile;
 	m_tccp = tccp;
@@ -78,10 +85,6 @@ bool TileComponent::init(bool isCompressor, bool whole_tile, grkRectU32 unreduce
 	// 1. calculate resolution bounds, precinct bounds and precinct grid
 	// all in canvas coordinates (with subsampling)
 	numresolutions = m_tccp->numresolutions;
-	if(numresolutions < cp->m_coding_params.m_dec.m_reduce)
-		resolutions_to_decompress = 1;
-	else
-		resolutions_to_decompress = (uint8_t)(numresolutions - cp->m_coding_params.m_dec.m_reduce);
 	tileCompResolution = new Resolution[numresolutions];
 	for(uint8_t resno = 0; resno < numresolutions; ++resno)
 	{
@@ -125,9 +128,7 @@ bool TileComponent::init(bool isCompressor, bool whole_tile, grkRectU32 unreduce
 	}
 
 	// 2. set tile component and band bounds
-	auto highestNumberOfResolutions = (!m_is_encoder) ? resolutions_to_decompress : numresolutions;
-	auto hightestResolution = tileCompResolution + highestNumberOfResolutions - 1;
-	set(hightestResolution);
+	setResolutionsToDecompress(cp->m_coding_params.m_dec.m_reduce);
 	for(uint8_t resno = 0; resno < numresolutions; ++resno)
 	{
 		auto res = tileCompResolution + resno;
@@ -184,6 +185,17 @@ bool TileComponent::init(bool isCompressor, bool whole_tile, grkRectU32 unreduce
 
 	return true;
 }
+void TileComponent::setResolutionsToDecompress(uint8_t reduce)
+{
+	if(numresolutions < reduce)
+		resolutions_to_decompress = 1;
+	else
+		resolutions_to_decompress = (uint8_t)(numresolutions - reduce);
+	resolutions_decompressed = 0;
+	auto highestNumberOfResolutions = (!m_is_encoder) ? resolutions_to_decompress : numresolutions;
+	auto hightestResolution = tileCompResolution + highestNumberOfResolutions - 1;
+	set(hightestResolution);
+}
 bool TileComponent::subbandIntersectsAOI(uint8_t resno, eBandOrientation orient,
 										 const grkRectU32* aoi) const
 {
@@ -317,7 +329,8 @@ bool TileComponent::allocSparseCanvas(uint32_t numres, bool truncatedTile)
 
 	return true;
 }
-bool TileComponent::allocWindowBuffer(grkRectU32 unreducedTileCompOrImageCompWindow)
+bool TileComponent::allocWindowBuffer(grkRectU32 unreducedTileCompOrImageCompWindow,
+									  BufferPool* pool)
 {
 	deallocBuffers();
 	auto highestNumberOfResolutions = (!m_is_encoder) ? resolutions_to_decompress : numresolutions;
@@ -333,7 +346,7 @@ bool TileComponent::allocWindowBuffer(grkRectU32 unreducedTileCompOrImageCompWin
 	buf = new TileComponentWindowBuffer<int32_t>(
 		m_is_encoder, m_tccp->qmfbid == 1, wholeTileDecompress, *(grkRectU32*)maxResolution,
 		*(grkRectU32*)this, unreducedTileCompOrImageCompWindow, tileCompResolution, numresolutions,
-		highestNumberOfResolutions);
+		highestNumberOfResolutions, pool);
 
 	return true;
 }
@@ -426,10 +439,13 @@ bool TileComponent::postDecompressImpl(int32_t* srcData, DecompressBlockExec* bl
 		dest = buf->getCodeBlockDestWindowREL(block->resno, block->bandOrientation);
 	}
 
-	if(!cblk->seg_buffers.empty())
+	if(cblk->getNumDecompressSegBuffers())
 	{
 		F f(block);
 		dest.copy<F>(src, f);
+		// samples were filtered in place, so block can't be re-used by a later decompress
+		if(m_sa)
+			cblk->setCacheState(GRK_CACHE_STATE_CLOSED);
 	}
 	else
 	{
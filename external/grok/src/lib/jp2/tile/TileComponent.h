@@ -29,11 +29,18 @@ struct TileComponent : public grkRectU32
 	TileComponent();
 	~TileComponent();
 	bool allocSparseCanvas(uint32_t numres, bool truncatedTile);
-	bool allocWindowBuffer(grkRectU32 unreducedTileCompOrImageCompWindow);
+	bool allocWindowBuffer(grkRectU32 unreducedTileCompOrImageCompWindow, BufferPool* pool);
 	void deallocBuffers(void);
 	bool init(bool isCompressor, bool whole_tile, grkRectU32 unreducedTileComp, uint8_t prec,
 			  CodingParams* cp, TileComponentCodingParams* tccp,
 			  grk_plugin_tile* current_plugin_tile);
+	/**
+	 * Set number of resolutions to decompress, and hence tile component bounds,
+	 * for a given resolution reduction. Precincts and code blocks are not affected.
+	 *
+	 * @param reduce number of highest resolutions to discard
+	 */
+	void setResolutionsToDecompress(uint8_t reduce);
 	bool subbandIntersectsAOI(uint8_t resno, eBandOrientation orient, const grkRectU32* aoi) const;
 
 	TileComponentWindowBuffer<int32_t>* getBuffer() const;
@@ -50,6 +57,7 @@ struct TileComponent : public grkRectU32
 	Resolution* round_trip_resolutions; /* round trip resolution information */
 #endif
   private:
+	void deallocResolutions(void);
 	template<typename F>
 	bool postDecompressImpl(int32_t* srcData, DecompressBlockExec* block, uint16_t stride);
 	ISparseCanvas* m_sa;
@@ -57,7 +57,7 @@ struct BufferResWindow
 					grkBuffer2d<T, AllocatorAligned>* resWindowTopLevelREL,
 					Resolution* tileCompAtRes, Resolution* tileCompAtLowerRes,
 					grkRectU32 tileCompWindow, grkRectU32 tileCompWindowUnreduced,
-					grkRectU32 tileCompUnreduced, uint32_t FILTER_WIDTH)
+					grkRectU32 tileCompUnreduced, uint32_t FILTER_WIDTH, BufferPool* pool)
 		: m_allocated(false), m_tileCompRes(tileCompAtRes), m_tileCompResLower(tileCompAtLowerRes),
 		  m_bufferResWindowBufferREL(new grkBuffer2d<T, AllocatorAligned>(tileCompWindow.width(),
 																		  tileCompWindow.height())),
@@ -149,6 +149,10 @@ struct BufferResWindow
 						tileCompWindow.width(), tileCompWindow.height() / 2);
 			}
 		}
+		// only these buffers may own memory: all others attach to them
+		m_bufferResWindowBufferREL->setPool(pool);
+		for(auto& b : m_paddedBandWindowBufferREL)
+			b->setPool(pool);
 	}
 	~BufferResWindow()
 	{
@@ -337,7 +341,7 @@ struct TileComponentWindowBuffer
 							  grkRectU32 tileCompUnreduced, grkRectU32 tileCompReduced,
 							  grkRectU32 unreducedTileCompOrImageCompWindow,
 							  Resolution* tileCompResolution, uint8_t numresolutions,
-							  uint8_t reducedNumResolutions)
+							  uint8_t reducedNumResolutions, BufferPool* pool)
 		: m_unreducedBounds(tileCompUnreduced), m_bounds(tileCompReduced),
 		  m_numResolutions(numresolutions), m_compress(isCompressor),
 		  m_wholeTileDecompress(wholeTileDecompress)
@@ -365,7 +369,7 @@ struct TileComponentWindowBuffer
 		auto topLevel = new BufferResWindow<T>(
 			numresolutions, (uint8_t)(reducedNumResolutions - 1U), nullptr, tileCompAtRes,
 			tileCompAtLowerRes, m_bounds, m_unreducedBounds, tileCompUnreduced,
-			wholeTileDecompress ? 0 : getFilterPad<uint32_t>(lossless));
+			wholeTileDecompress ? 0 : getFilterPad<uint32_t>(lossless), pool);
 		// setting top level prevents allocation of tileCompBandWindows buffers
 		if(!useBandWindows())
 			topLevel->m_bufferResWindowTopLevelBufferREL = topLevel->m_bufferResWindowBufferREL;
@@ -380,7 +384,7 @@ struct TileComponentWindowBuffer
 				useBandWindows() ? nullptr : topLevel->m_bufferResWindowBufferREL,
 				tileCompResolution + resno, resno > 0 ? tileCompResolution + resno - 1 : nullptr,
 				resDims, m_unreducedBounds, tileCompUnreduced,
-				wholeTileDecompress ? 0 : getFilterPad<uint32_t>(lossless)));
+				wholeTileDecompress ? 0 : getFilterPad<uint32_t>(lossless), pool));
 		}
 		m_bufferResWindowREL.push_back(topLevel);
 	}
@@ -24,13 +24,22 @@ namespace grk
 TileProcessor::TileProcessor(CodeStream* codeStream, IBufferedStream* stream, bool isCompressor,
 							 bool isWholeTileDecompress)
 	: m_tileIndex(0), m_first_poc_tile_part(true), m_tilePartIndex(0), tilePartDataLength(0),
+	  tilePartSotPosition(0),
 	  numTilePartsTotal(0), pino(0), tile(nullptr), headerImage(codeStream->getHeaderImage()),
 	  current_plugin_tile(codeStream->getCurrentPluginTile()),
 	  wholeTileDecompress(isWholeTileDecompress), m_cp(codeStream->getCodingParams()),
-	  packetLengthCache(PacketLengthCache(m_cp)), m_stream(stream), m_corrupt_packet(false),
-	  newTilePartProgressionPosition(0), m_tcp(nullptr), truncated(false), m_image(nullptr),
-	  m_isCompressor(isCompressor), preCalculatedTileLen(0)
+	  packetLengthCache(PacketLengthCache(m_cp)), interleavedOutput(nullptr), refining(false),
+	  skippedPacketData(false), m_stream(stream),
+	  m_corrupt_packet(false), newTilePartProgressionPosition(0), m_tcp(nullptr),
+	  decompressSuccess(true),
+	  decompressActive(false), truncated(false), m_image(nullptr),
+	  m_isCompressor(isCompressor), preCalculatedTileLen(0), stats(codeStream->getStats()),
+	  context(codeStream->getDecompressContext())
 {
+	// the context may be detached from the code stream while this processor
+	// is alive, and it owns the pool that tile buffers are released to
+	if(context)
+		grk_object_ref(context->getWrapper());
 	tile = new Tile();
 	tile->comps = new TileComponent[headerImage->numcomps];
 	tile->numcomps = headerImage->numcomps;
@@ -42,6 +51,8 @@ TileProcessor::~TileProcessor()
 	delete tile;
 	if(m_image)
 		grk_object_unref(&m_image->obj);
+	if(context)
+		grk_object_unref(context->getWrapper());
 }
 IBufferedStream* TileProcessor::getStream(void)
 {
@@ -65,6 +76,12 @@ GrkImage* TileProcessor::getImage(void)
 {
 	return m_image;
 }
+void TileProcessor::releaseImage(void)
+{
+	if(m_image)
+		grk_object_unref(&m_image->obj);
+	m_image = nullptr;
+}
 void TileProcessor::setCorruptPacket(void)
 {
 	m_corrupt_packet = true;
@@ -77,6 +94,30 @@ TileCodingParams* TileProcessor::getTileCodingParams(void)
 {
 	return m_cp->tcps + m_tileIndex;
 }
+uint64_t TileProcessor::getRetainedBytes(void)
+{
+	uint64_t bytes = 0;
+	for(uint16_t compno = 0; compno < tile->numcomps; ++compno)
+	{
+		auto tilec = tile->comps + compno;
+		if(!tilec->tileCompResolution)
+			continue;
+		for(uint8_t resno = 0; resno < tilec->numresolutions; ++resno)
+		{
+			auto res = tilec->tileCompResolution + resno;
+			for(uint8_t bandIndex = 0; bandIndex < res->numTileBandWindows; ++bandIndex)
+			{
+				for(auto prc : res->tileBand[bandIndex].precincts)
+					bytes += sizeof(Precinct) + prc->getNumCblks() * sizeof(DecompressCodeblock);
+			}
+		}
+	}
+	auto tcp = getTileCodingParams();
+	if(tcp->m_compressedTileData)
+		bytes += tcp->m_compressedTileData->getOwnedLength();
+
+	return bytes;
+}
 uint8_t TileProcessor::getMaxNumDecompressResolutions(void)
 {
 	uint8_t rc = 0;
@@ -101,6 +142,9 @@ bool TileProcessor::init(void)
 
 	if(tcp->m_compressedTileData)
 		tcp->m_compressedTileData->rewind();
+	// code blocks are re-created below, so packet headers must be read again
+	packetLengthCache.clearPacketInfo();
+	skippedPacketData = false;
 
 	// generate tile bounds from tile grid coordinates
 	uint32_t tile_x = m_tileIndex % m_cp->t_grid_width;
@@ -160,6 +204,21 @@ bool TileProcessor::init(void)
 
 	return true;
 }
+bool TileProcessor::initRefine(void)
+{
+	auto tcp = m_cp->tcps + m_tileIndex;
+	if(!tcp->m_compressedTileData)
+		return false;
+	tcp->m_compressedTileData->rewind();
+	// packet info cache is rewound together with the compressed data,
+	// so known packets are skipped and their code blocks are kept
+	for(uint16_t compno = 0; compno < tile->numcomps; ++compno)
+		(tile->comps + compno)->setResolutionsToDecompress(m_cp->m_coding_params.m_dec.m_reduce);
+	tile->numProcessedPackets = 0;
+	tile->numDecompressedPackets = 0;
+
+	return true;
+}
 bool TileProcessor::allocWindowBuffers(const GrkImage* outputImage)
 {
 	for(uint16_t compno = 0; compno < tile->numcomps; ++compno)
@@ -179,7 +238,9 @@ bool TileProcessor::allocWindowBuffers(const GrkImage* outputImage)
 		}
 		grkRectU32 unreducedTileCompOrImageCompWindow =
 			rct.rectceildiv(imageComp->dx, imageComp->dy);
-		if(!(tile->comps + compno)->allocWindowBuffer(unreducedTileCompOrImageCompWindow))
+		if(!(tile->comps + compno)
+				->allocWindowBuffer(unreducedTileCompOrImageCompWindow,
+									context ? context->getBufferPool() : nullptr))
 			return false;
 	}
 
@@ -218,6 +279,8 @@ bool TileProcessor::doCompress(void)
 	{
 		if(!debugEncode)
 		{
+			StageTimer timer(stats, GRK_STAGE_MCT);
+			timer.addBytes(sampleBytes());
 			if(!dcLevelShiftCompress())
 				return false;
 			if(!mct_encode())
@@ -225,6 +288,8 @@ bool TileProcessor::doCompress(void)
 		}
 		if(!debugEncode || debugMCT)
 		{
+			StageTimer timer(stats, GRK_STAGE_DWT);
+			timer.addBytes(sampleBytes());
 			if(!dwt_encode())
 				return false;
 		}
@@ -236,8 +301,12 @@ bool TileProcessor::doCompress(void)
 		packetLengthCache.createMarkers(m_stream);
 	// 2. rate control
 	uint32_t allPacketBytes = 0;
-	if(!rateAllocate(&allPacketBytes))
-		return false;
+	{
+		StageTimer timer(stats, GRK_STAGE_RATE_CONTROL);
+		if(!rateAllocate(&allPacketBytes))
+			return false;
+		timer.addBytes(allPacketBytes);
+	}
 	m_packetTracker.clear();
 
 	if(canPreCalculateTileLen())
@@ -277,7 +346,12 @@ bool TileProcessor::writeTilePartT2(uint32_t* tileBytesWritten)
 	*tileBytesWritten += 2;
 
 	// write tile packets
-	return encodeT2(tileBytesWritten);
+	StageTimer timer(stats, GRK_STAGE_T2);
+	uint32_t bytesBefore = *tileBytesWritten;
+	bool rc = encodeT2(tileBytesWritten);
+	timer.addBytes(*tileBytesWritten - bytesBefore);
+
+	return rc;
 }
 /** Returns whether a tile component should be fully decompressed,
  * taking into account win_* members.
@@ -320,6 +394,8 @@ bool TileProcessor::decompressT2(SparseBuffer* srcBuf)
 
 	if(doT2)
 	{
+		StageTimer timer(stats, GRK_STAGE_T2);
+		timer.addBytes(srcBuf ? srcBuf->getLength() : 0);
 		auto t2 = new T2Decompress(this);
 		bool rc = t2->decompressPackets(m_tileIndex, srcBuf, &truncated);
 		delete t2;
@@ -331,80 +407,194 @@ bool TileProcessor::decompressT2(SparseBuffer* srcBuf)
 
 	return true;
 }
-bool TileProcessor::decompressT1(void)
+void TileProcessor::failDecompress(void)
+{
+	decompressSuccess = false;
+	decompressActive = false;
+}
+void TileProcessor::emplaceDecompressT1(tf::Subflow& flow)
 {
+	if(!decompressActive)
+		return;
 	bool doT1 = !current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_T1);
 	bool doPostT1 =
 		!current_plugin_tile || (current_plugin_tile->decompress_flags & GRK_DECODE_POST_T1);
-	if(doT1)
-	{
-		for(uint16_t compno = 0; compno < tile->numcomps; ++compno)
+	auto mct = flow.emplace([this, doPostT1] {
+		if(!doPostT1 || !decompressActive)
+			return;
+		StageTimer timer(stats, GRK_STAGE_MCT);
+		timer.addBytes(sampleBytes());
+		if(interleavedOutput)
 		{
-			auto tilec = tile->comps + compno;
-			auto tccp = m_tcp->tccps + compno;
+			if(!interleaveDecompress())
+				failDecompress();
+		}
+		else if(!mctDecompress() || !dcLevelShiftDecompress())
+			failDecompress();
+	});
+	if(!doT1)
+		return;
 
-			if(!wholeTileDecompress)
+	// code block coders are shared by all components, so size them for the largest
+	// nominal code block
+	uint32_t cblkw = 0, cblkh = 0;
+	for(uint16_t compno = 0; compno < tile->numcomps; ++compno)
+	{
+		cblkw = std::max<uint32_t>(cblkw, m_tcp->tccps[compno].cblkw);
+		cblkh = std::max<uint32_t>(cblkh, m_tcp->tccps[compno].cblkh);
+	}
+	// the scheduler must outlive this subflow's body, so it is owned by its tasks
+	auto scheduler = std::make_shared<T1DecompressScheduler>(
+		m_tcp, (uint16_t)cblkw, (uint16_t)cblkh,
+		stats->get(m_tcp->isHT() ? GRK_STAGE_T1_HT : GRK_STAGE_T1), context);
+	for(uint16_t compno = 0; compno < tile->numcomps; ++compno)
+	{
+		auto tilec = tile->comps + compno;
+		auto tccp = m_tcp->tccps + compno;
+
+		if(!wholeTileDecompress)
+		{
+			try
 			{
-				try
-				{
-					tilec->allocSparseCanvas(tilec->resolutions_decompressed + 1U, truncated);
-				}
-				catch(std::runtime_error& ex)
-				{
-					GRK_UNUSED(ex);
-					continue;
-				}
+				tilec->allocSparseCanvas(tilec->resolutions_decompressed + 1U, truncated);
 			}
-			std::vector<DecompressBlockExec*> blocks;
-			auto scheduler = std::unique_ptr<T1DecompressScheduler>(new T1DecompressScheduler());
-			if(!scheduler->prepareScheduleDecompress(tilec, tccp, &blocks))
-				return false;
-			if(!scheduler->scheduleDecompress(m_tcp, (uint16_t)tccp->cblkw, (uint16_t)tccp->cblkh,
-											  &blocks))
-				return false;
-
-			if(doPostT1)
+			catch(std::runtime_error& ex)
 			{
+				GRK_UNUSED(ex);
+				continue;
+			}
+		}
+		auto alloc = flow.emplace([this, tilec] {
+			if(!decompressActive)
+				return;
+			if(!tilec->getBuffer()->alloc())
+			{
+				GRK_ERROR("Not enough memory for tile data");
+				failDecompress();
+			}
+		});
+		// T1 : one task per resolution
+		std::vector<tf::Task> t1(tilec->resolutions_to_decompress);
+		for(uint8_t resno = 0; resno < tilec->resolutions_to_decompress; ++resno)
+		{
+			t1[resno] = flow.emplace([this, scheduler, tilec, tccp, resno] {
+				if(!decompressActive)
+					return;
+				auto blocks = scheduler->acquireBlocks();
+				if(!scheduler->prepareScheduleDecompress(tilec, tccp, resno, blocks) ||
+				   !scheduler->decompress(blocks))
+					failDecompress();
+				scheduler->releaseBlocks(blocks);
+			});
+			alloc.precede(t1[resno]);
+		}
+		if(!doPostT1)
+		{
+			for(auto& t : t1)
+				t.precede(mct);
+			continue;
+		}
+		// DWT
+		uint8_t numres = (uint8_t)(tilec->resolutions_decompressed + 1U);
+		if(wholeTileDecompress)
+		{
+			// synthesis of resolution r only depends on resolution r - 1 and on
+			// the T1 output of resolution r, so lower resolutions are transformed
+			// while higher resolutions are still in T1
+			auto prev = t1[0];
+			for(uint8_t resno = 1; resno < numres; ++resno)
+			{
+				auto dwt = flow.emplace([this, tilec, tccp, resno] {
+					if(!decompressActive)
+						return;
+					StageTimer timer(stats, GRK_STAGE_DWT);
+					timer.addBytes((tilec->tileCompResolution + resno)->area() * sizeof(int32_t));
+					WaveletReverse w;
+					if(!w.decompressResolution(tilec, resno, tccp->qmfbid))
+						failDecompress();
+				});
+				prev.precede(dwt);
+				if(resno < t1.size())
+					t1[resno].precede(dwt);
+				prev = dwt;
+			}
+			prev.precede(mct);
+			for(size_t resno = numres; resno < t1.size(); ++resno)
+				t1[resno].precede(mct);
+		}
+		else
+		{
+			// windowed synthesis reads all resolutions from the sparse canvas
+			auto dwt = flow.emplace([this, tilec, tccp, compno, numres] {
+				if(!decompressActive)
+					return;
+				StageTimer timer(stats, GRK_STAGE_DWT);
+				timer.addBytes(tilec->getBuffer()->stridedArea() * sizeof(int32_t));
 				WaveletReverse w;
 				if(!w.decompress(this, tilec, compno, tilec->getBuffer()->unreducedBounds(),
-								 tilec->resolutions_decompressed + 1U, tccp->qmfbid))
-					return false;
-			}
+								 numres, tccp->qmfbid))
+					failDecompress();
+			});
+			for(auto& t : t1)
+				t.precede(dwt);
+			dwt.precede(mct);
 		}
 	}
-	if(doPostT1)
-	{
-		if(!mctDecompress())
-			return false;
-		if(!dcLevelShiftDecompress())
-			return false;
-	}
-	return true;
 }
-bool TileProcessor::decompressT2T1(TileCodingParams* tcp, GrkImage* outputImage, bool multiTile,
-								   bool doPost)
+void TileProcessor::emplaceDecompressT2T1(tf::FlowBuilder& flow, TileCodingParams* tcp,
+										  GrkImage* outputImage, bool multiTile, bool doPost)
 {
-	if(!allocWindowBuffers(outputImage))
-		return false;
-	if(!decompressT2(tcp->m_compressedTileData) || m_corrupt_packet)
-	{
-		GRK_WARN("Tile %d was not decompressed", m_tileIndex);
-		return multiTile;
-	}
-	if(!decompressT1())
-	{
-		return false;
-	}
-	if(doPost)
-	{
+	decompressSuccess = true;
+	decompressActive = true;
+	auto t2 = flow.emplace([this, tcp, outputImage, multiTile] {
+		if(!allocWindowBuffers(outputImage))
+		{
+			failDecompress();
+			return;
+		}
+		if(!decompressT2(tcp->m_compressedTileData) || m_corrupt_packet)
+		{
+			GRK_WARN("Tile %d was not decompressed", m_tileIndex);
+			decompressSuccess = multiTile;
+			decompressActive = false;
+		}
+	});
+	// T1 and DWT graph can only be built once T2 has determined
+	// how many resolutions were actually decompressed
+	auto t1 = flow.emplace([this](tf::Subflow& subflow) { emplaceDecompressT1(subflow); });
+	auto post = flow.emplace([this, outputImage, multiTile, doPost] {
+		if(!decompressActive || !doPost)
+			return;
+		if(interleavedOutput)
+		{
+			// an image left over from an earlier decompress is now stale
+			releaseImage();
+			deallocBuffers();
+			return;
+		}
+		StageTimer timer(stats, GRK_STAGE_COMPOSITE);
+		timer.addBytes(sampleBytes());
 		if(multiTile)
 			generateImage(outputImage, tile);
 		else
 			outputImage->transferDataFrom(tile);
 		deallocBuffers();
-	}
+	});
+	t2.precede(t1);
+	t1.precede(post);
+}
+bool TileProcessor::decompressT2T1(TileCodingParams* tcp, GrkImage* outputImage, bool multiTile,
+								   bool doPost)
+{
+	tf::Taskflow flow;
+	emplaceDecompressT2T1(flow, tcp, outputImage, multiTile, doPost);
+	ExecSingleton::run(flow);
 
-	return true;
+	return decompressSuccess;
+}
+bool TileProcessor::getDecompressResult(void)
+{
+	return decompressSuccess;
 }
 
 void TileProcessor::ingestImage()
@@ -501,6 +691,21 @@ bool TileProcessor::dcLevelShiftDecompress()
 	return true;
 }
 
+/**
+ * Fused inverse MCT, DC shift, clamp and pack of tile into interleaved output
+ */
+bool TileProcessor::interleaveDecompress()
+{
+	bool doMct = needsMctDecompress(0);
+	// custom MCT mixes all components, so it is applied in place beforehand,
+	// leaving only clamping and packing for the fused stage
+	bool custom = doMct && m_tcp->mct == 2;
+	if(custom && (!mctDecompress() || !dcLevelShiftDecompress()))
+		return false;
+
+	return mct::decompress_interleaved(tile, headerImage, m_tcp->tccps, doMct && !custom, custom,
+									   interleavedOutput);
+}
 bool TileProcessor::dcLevelShiftCompress()
 {
 	for(uint16_t compno = 0; compno < tile->numcomps; compno++)
@@ -603,10 +808,18 @@ void TileProcessor::t1_encode()
 		mct_norms = (const double*)(tcp->mct_norms);
 	}
 
-	auto scheduler =
-		std::unique_ptr<T1CompressScheduler>(new T1CompressScheduler(tile, needsRateControl()));
+	auto scheduler = std::unique_ptr<T1CompressScheduler>(new T1CompressScheduler(
+		tile, needsRateControl(), stats->get(tcp->isHT() ? GRK_STAGE_T1_HT : GRK_STAGE_T1)));
 	scheduler->scheduleCompress(tcp, mct_norms, mct_numcomps);
 }
+uint64_t TileProcessor::sampleBytes(void)
+{
+	uint64_t bytes = 0;
+	for(uint16_t compno = 0; compno < tile->numcomps; ++compno)
+		bytes += (tile->comps + compno)->getBuffer()->stridedArea() * sizeof(int32_t);
+
+	return bytes;
+}
 bool TileProcessor::encodeT2(uint32_t* tileBytesWritten)
 {
 	auto l_t2 = new T2Compress(this);
@@ -713,12 +926,24 @@ bool TileProcessor::encodeT2(uint32_t* tileBytesWritten)
 
 	return true;
 }
-bool TileProcessor::preCompressTile()
+bool TileProcessor::preCompressTile(bool ingest)
 {
 	m_tilePartIndex = 0;
 	numTilePartsTotal = m_cp->tcps[m_tileIndex].numTileParts;
 	m_first_poc_tile_part = true;
 
+	if(ingest)
+	{
+		for(uint16_t i = 0; i < headerImage->numcomps; ++i)
+		{
+			if(!headerImage->comps[i].data)
+			{
+				GRK_ERROR("Image component %u has no data", i);
+				return false;
+			}
+		}
+	}
+
 	/* initialization before tile compressing  */
 	bool rc = init();
 	if(!rc)
@@ -735,7 +960,7 @@ bool TileProcessor::preCompressTile()
 	{
 		auto tilec = tile->comps + j;
 		auto imagec = headerImage->comps + j;
-		if(transfer_image_to_tile && imagec->data)
+		if(transfer_image_to_tile && ingest)
 		{
 			tilec->getBuffer()->attach(imagec->data, imagec->stride);
 		}
@@ -748,7 +973,7 @@ bool TileProcessor::preCompressTile()
 			}
 		}
 	}
-	if(!transfer_image_to_tile)
+	if(!transfer_image_to_tile && ingest)
 		ingestImage();
 
 	return true;
@@ -828,6 +1053,27 @@ bool TileProcessor::ingestUncompressedData(uint8_t* p_src, uint64_t src_length)
 	}
 	return true;
 }
+void TileProcessor::ingestRows(const int32_t* const* data, const uint32_t* stride, uint32_t y0,
+							   uint32_t numRows)
+{
+	for(uint16_t i = 0; i < headerImage->numcomps; ++i)
+	{
+		auto tilec = tile->comps + i;
+		uint32_t rowBegin = std::max<uint32_t>(y0, tilec->y0);
+		uint32_t rowEnd = std::min<uint32_t>(y0 + numRows, tilec->y1);
+		if(rowBegin >= rowEnd)
+			continue;
+		auto win = tilec->getBuffer()->getHighestBufferResWindowREL();
+		auto src = data[i] + (uint64_t)(rowBegin - y0) * stride[i] + (tilec->x0 - headerImage->x0);
+		auto dest = win->getBuffer() + (uint64_t)(rowBegin - tilec->y0) * win->stride;
+		for(uint32_t j = rowBegin; j < rowEnd; ++j)
+		{
+			memcpy(dest, src, tilec->width() * sizeof(int32_t));
+			src += stride[i];
+			dest += win->stride;
+		}
+	}
+}
 bool TileProcessor::prepareSodDecompress(CodeStreamDecompress* codeStream)
 {
 	assert(codeStream);
@@ -843,6 +1089,13 @@ bool TileProcessor::prepareSodDecompress(CodeStreamDecompress* codeStream)
 		if(tilePartDataLength >= 2)
 			tilePartDataLength -= 2;
 	}
+	if(m_cp->plm_markers)
+	{
+		PL_INFO_VEC plmLengths;
+		if(m_cp->plm_markers->popTilePartLengths(tilePartSotPosition, tilePartDataLength,
+												 &plmLengths))
+			packetLengthCache.pushPlmLengths(&plmLengths);
+	}
 	if(tilePartDataLength)
 	{
 		auto bytesLeftInStream = m_stream->numBytesLeft();
@@ -26,6 +26,8 @@
 
 namespace grk
 {
+class DecompressContext;
+
 /*
  * Tile structure.
  *
@@ -79,25 +81,63 @@ struct TileProcessor
 						   bool isWholeTileDecompress);
 	~TileProcessor();
 	bool init(void);
+	/**
+	 * Prepare for decompression of more layers and/or resolutions than
+	 * the previous decompress, re-using its packet headers and code blocks
+	 */
+	bool initRefine(void);
 	bool allocWindowBuffers(const GrkImage* outputImage);
 	void deallocBuffers();
-	bool preCompressTile(void);
+	/**
+	 * Prepare tile for compression
+	 *
+	 * @param ingest	if true, copy tile samples from the image; otherwise the caller
+	 * pushes them, through ingestUncompressedData or ingestRows
+	 */
+	bool preCompressTile(bool ingest);
 	bool canWritePocMarker(void);
 	bool writeTilePartT2(uint32_t* tileBytesWritten);
 	bool doCompress(void);
-	bool decompressT1(void);
 	bool decompressT2(SparseBuffer* srcBuf);
+	/**
+	 * Emplace tile decompression task graph into a flow:
+	 *
+	 * T2 -> per-resolution T1 -> per-resolution DWT -> MCT/DC shift -> post
+	 *
+	 * With interleaved output, the MCT/DC shift stage also writes the tile to the output.
+	 *
+	 * Result is available from getDecompressResult once the graph has run.
+	 */
+	void emplaceDecompressT2T1(tf::FlowBuilder& flow, TileCodingParams* tcp,
+							   GrkImage* outputImage, bool multiTile, bool doPost);
+	bool getDecompressResult(void);
 	bool decompressT2T1(TileCodingParams* tcp, GrkImage* outputImage, bool multiTile, bool doPost);
 	bool ingestUncompressedData(uint8_t* p_src, uint64_t src_length);
+	/**
+	 * Copy the part of a strip of image rows that overlaps this tile
+	 *
+	 * @param data		planar component buffers, one row per canvas row
+	 * @param stride	component buffer strides, in samples
+	 * @param y0		canvas row of first strip row
+	 * @param numRows	number of rows in strip
+	 */
+	void ingestRows(const int32_t* const* data, const uint32_t* stride, uint32_t y0,
+					uint32_t numRows);
 	bool needsRateControl();
 	void ingestImage();
 	bool prepareSodDecompress(CodeStreamDecompress* codeStream);
 	void generateImage(GrkImage* src_image, Tile* src_tile);
 	GrkImage* getImage(void);
+	void releaseImage(void);
 	void setCorruptPacket(void);
 	PacketTracker* getPacketTracker(void);
 	grkRectU32 getUnreducedTileWindow(void);
 	TileCodingParams* getTileCodingParams(void);
+	/**
+	 * Estimate bytes kept between decompresses, excluding tile image:
+	 * precincts and code blocks, and compressed tile data copied from the stream
+	 */
+	uint64_t getRetainedBytes(void);
 	uint8_t getMaxNumDecompressResolutions(void);
 	IBufferedStream* getStream(void);
 	uint32_t getPreCalculatedTileLen(void);
@@ -115,6 +155,9 @@ struct TileProcessor
 	uint8_t m_tilePartIndex;
 	// Decompressing Only
 	uint32_t tilePartDataLength;
+	// Decompressing Only
+	// position of SOT marker of tile part being read
+	uint64_t tilePartSotPosition;
 	/** Compressing Only
 	 * Total number of tile parts of the tile*/
 	uint8_t numTilePartsTotal;
@@ -128,25 +171,45 @@ struct TileProcessor
 	bool wholeTileDecompress;
 	CodingParams* m_cp;
 	PacketLengthCache packetLengthCache;
+	// Decompressing Only
+	// if set, tile is written to this buffer instead of to an output image
+	const InterleavedBuffer* interleavedOutput;
+	// Decompressing Only
+	// true if tile is being refined: data of skipped packets is then read as well
+	bool refining;
+	// Decompressing Only
+	// true if data of packets beyond requested layers or resolutions was skipped,
+	// in which case tile can't be refined without decompressing it from scratch
+	bool skippedPacketData;
 
   private:
 	// Compressing only - track which packets have already been written
 	// to the code stream
 	PacketTracker m_packetTracker;
 	IBufferedStream* m_stream;
-	bool m_corrupt_packet;
+	// may be set concurrently by packets of different precincts
+	std::atomic_bool m_corrupt_packet;
 	/** position of the tile part flag in progression order*/
 	uint32_t newTilePartProgressionPosition;
 	// coding/decoding parameters for this tile
 	TileCodingParams* m_tcp;
 	bool isWholeTileDecompress(uint32_t compno);
+	void emplaceDecompressT1(tf::Subflow& flow);
+	void failDecompress(void);
+	// decompression result, valid once decompression graph has run
+	std::atomic_bool decompressSuccess;
+	// false once a decompression stage has failed, or T2 has abandoned the tile
+	std::atomic_bool decompressActive;
 	bool needsMctDecompress(uint32_t compno);
 	bool mctDecompress();
 	bool dcLevelShiftDecompress();
+	bool interleaveDecompress();
 	bool dcLevelShiftCompress();
 	bool mct_encode();
 	bool dwt_encode();
 	void t1_encode();
+	// number of bytes in tile component sample buffers
+	uint64_t sampleBytes(void);
 	bool encodeT2(uint32_t* packet_bytes_written);
 	bool rateAllocate(uint32_t* allPacketBytes);
 	bool layerNeedsRateControl(uint32_t layno);
@@ -161,6 +224,9 @@ struct TileProcessor
 	bool m_isCompressor;
 	grkRectU32 unreducedTileWindow;
 	uint32_t preCalculatedTileLen;
+	CodecStats* stats;
+	// optional state shared with other decompressors; processor holds a reference
+	DecompressContext* context;
 };
 
 struct TileProcessorComparator
@@ -22,385 +22,312 @@
 #include <algorithm>
 #include <limits>
 #include <sstream>
+
+#undef HWY_TARGET_INCLUDE
+#define HWY_TARGET_INCLUDE "transform/WaveletFwd.cpp"
+#include <hwy/foreach_target.h>
+#include <hwy/highway.h>
+HWY_BEFORE_NAMESPACE();
 namespace grk
 {
-template<typename T>
-struct dwt_line
+namespace HWY_NAMESPACE
 {
-	T* mem;
-	uint32_t dn; /* number of elements in high pass band */
-	uint32_t sn; /* number of elements in low pass band */
-	uint32_t parity; /* 0 = start on even coord, 1 = start on odd coord */
-};
-
-const uint32_t NB_ELTS_V8 = 8;
+	using namespace hwy::HWY_NAMESPACE;
 
-/* From table F.4 from the standard */
-static const float alpha = -1.586134342f;
-static const float beta = -0.052980118f;
-static const float gamma = 0.882911075f;
-static const float delta = 0.443506852f;
-static const float grk_K = 1.230174105f;
-static const float grk_invK = (float)(1.0 / 1.230174105);
-
-#define GRK_S(i) a[(i)*2]
-#define GRK_D(i) a[(1 + (i)*2)]
-#define GRK_S_(i) ((i) < 0 ? GRK_S(0) : ((i) >= sn ? GRK_S(sn - 1) : GRK_S(i)))
-#define GRK_D_(i) ((i) < 0 ? GRK_D(0) : ((i) >= dn ? GRK_D(dn - 1) : GRK_D(i)))
-#define GRK_SS_(i) ((i) < 0 ? GRK_S(0) : ((i) >= dn ? GRK_S(dn - 1) : GRK_S(i)))
-#define GRK_DD_(i) ((i) < 0 ? GRK_D(0) : ((i) >= sn ? GRK_D(sn - 1) : GRK_D(i)))
+	/* From table F.4 from the standard */
+	const float alpha = -1.586134342f;
+	const float beta = -0.052980118f;
+	const float gamma = 0.882911075f;
+	const float delta = 0.443506852f;
+	const float grk_K = 1.230174105f;
+	const float grk_invK = (float)(1.0 / 1.230174105);
 
-/* <summary>                             */
-/* Forward lazy transform (horizontal).  */
-/* </summary>                            */
-template<typename T>
-void deinterleave_h(const T* GRK_RESTRICT a, T* GRK_RESTRICT b, int32_t dn, int32_t sn,
-					int32_t parity)
-{
-	int32_t i;
-	T* GRK_RESTRICT destPtr = b;
-	const T* GRK_RESTRICT src = a + parity;
-
-	for(i = 0; i < sn; ++i)
+	static size_t hwy_fwd_num_lanes(void)
 	{
-		*destPtr++ = *src;
-		src += 2;
+		const HWY_FULL(int32_t) di;
+		return Lanes(di);
 	}
 
-	destPtr = b + sn;
-	src = a + 1 - parity;
-
-	for(i = 0; i < dn; ++i)
+	/* 5/3 predict: d(i) -= (s(i) + s(i+1)) >> 1 */
+	struct Predict53
 	{
-		*destPtr++ = *src;
-		src += 2;
-	}
-}
+		template<typename D, typename V>
+		V operator()(D d, V x, V a, V b) const
+		{
+			(void)d;
+			return x - ShiftRight<1>(a + b);
+		}
+	};
 
-#if 0
-void dwt97::encode_step1(float* fw,
-                                 uint32_t end,
-                                 const float c)
-{
-    uint32_t i = 0;
-    for (; i < end; ++i) {
-        fw[0] *= c;
-        fw += 2;
-    }
-}
-#else
-void dwt97::encode_step1_combined(float* fw, uint32_t iters_c1, uint32_t iters_c2, const float c1,
-								  const float c2)
-{
-	uint32_t i = 0;
-	const uint32_t iters_common = std::min<uint32_t>(iters_c1, iters_c2);
-	assert((((size_t)fw) & 0xf) == 0);
-	assert(abs((int32_t)iters_c1 - (int32_t)iters_c2) <= 1);
-	for(; i + 3 < iters_common; i += 4)
+	/* 5/3 update: s(i) += (d(i-1) + d(i) + 2) >> 2 */
+	struct Update53
 	{
-#ifdef __SSE__
-		const __m128 vcst = _mm_set_ps(c2, c1, c2, c1);
-		*(__m128*)fw = _mm_mul_ps(*(__m128*)fw, vcst);
-		*(__m128*)(fw + 4) = _mm_mul_ps(*(__m128*)(fw + 4), vcst);
-#else
-		fw[0] *= c1;
-		fw[1] *= c2;
-		fw[2] *= c1;
-		fw[3] *= c2;
-		fw[4] *= c1;
-		fw[5] *= c2;
-		fw[6] *= c1;
-		fw[7] *= c2;
-#endif
-		fw += 8;
-	}
-	for(; i < iters_common; i++)
+		template<typename D, typename V>
+		V operator()(D d, V x, V a, V b) const
+		{
+			return x + ShiftRight<2>(a + b + Set(d, 2));
+		}
+	};
+
+	/* single 5/3 sample of odd parity: x *= 2 */
+	struct Twice53
 	{
-		fw[0] *= c1;
-		fw[1] *= c2;
-		fw += 2;
-	}
-	if(i < iters_c1)
-		fw[0] *= c1;
-	else if(i < iters_c2)
-		fw[1] *= c2;
-}
+		template<typename D, typename V>
+		V operator()(D d, V x, V a, V b) const
+		{
+			(void)d;
+			(void)a;
+			(void)b;
+			return x + x;
+		}
+	};
 
-#endif
+	/* 9/7 lifting step: x(i) += (a + b) * c */
+	struct Lift97
+	{
+		explicit Lift97(float coeff) : c(coeff) {}
+		template<typename D, typename V>
+		V operator()(D d, V x, V a, V b) const
+		{
+			return x + (a + b) * Set(d, c);
+		}
+		float c;
+	};
 
-void dwt97::encode_step2(float* fl, float* fw, uint32_t end, uint32_t m, float c)
-{
-	uint32_t i;
-	uint32_t imax = std::min<uint32_t>(end, m);
-	if(imax > 0)
+	/* 9/7 normalization: x(i) *= c */
+	struct Scale97
 	{
-		fw[-1] += (fl[0] + fw[0]) * c;
-		fw += 2;
-		i = 1;
-		for(; i + 3 < imax; i += 4)
+		explicit Scale97(float coeff) : c(coeff) {}
+		template<typename D, typename V>
+		V operator()(D d, V x, V a, V b) const
 		{
-			fw[-1] += (fw[-2] + fw[0]) * c;
-			fw[1] += (fw[0] + fw[2]) * c;
-			fw[3] += (fw[2] + fw[4]) * c;
-			fw[5] += (fw[4] + fw[6]) * c;
-			fw += 8;
+			(void)a;
+			(void)b;
+			return x * Set(d, c);
 		}
-		for(; i < imax; ++i)
+		float c;
+	};
+
+	/**
+	 * Lifting over the contiguous samples of a single row:
+	 * full vectors along the row, and a single lane for the remainder
+	 */
+	template<typename T>
+	struct RowLifter
+	{
+		template<typename OP>
+		void step(T* x, const T* a, const T* b, size_t n, OP op) const
 		{
-			fw[-1] += (fw[-2] + fw[0]) * c;
-			fw += 2;
+			const HWY_FULL(T) d;
+			size_t i = 0;
+			for(; i + Lanes(d) <= n; i += Lanes(d))
+				StoreU(op(d, LoadU(d, x + i), LoadU(d, a + i), LoadU(d, b + i)), d, x + i);
+			const HWY_CAPPED(T, 1) d1;
+			for(; i < n; ++i)
+				StoreU(op(d1, LoadU(d1, x + i), LoadU(d1, a + i), LoadU(d1, b + i)), d1, x + i);
 		}
+		// distance between consecutive samples of a band
+		const size_t stride = 1;
+	};
+
+	/**
+	 * Lifting over a strip of columns: each band sample is a row of
+	 * cols values, which are processed as full vectors.
+	 *
+	 * The strip width is chosen outside of this target, and the dispatched
+	 * target can change between calls (see hwy::DisableTargets), so any
+	 * columns beyond the last full vector are processed one lane at a time
+	 */
+	template<typename T>
+	struct ColLifter
+	{
+		explicit ColLifter(size_t numCols) : stride(numCols), cols(numCols) {}
+		template<typename OP>
+		void step(T* x, const T* a, const T* b, size_t n, OP op) const
+		{
+			const HWY_FULL(T) d;
+			const HWY_CAPPED(T, 1) d1;
+			const size_t vecCols = cols - cols % Lanes(d);
+			for(size_t i = 0; i < n; ++i)
+			{
+				size_t c = 0;
+				for(; c < vecCols; c += Lanes(d))
+					StoreU(op(d, LoadU(d, x + c), LoadU(d, a + c), LoadU(d, b + c)), d, x + c);
+				for(; c < cols; ++c)
+					StoreU(op(d1, LoadU(d1, x + c), LoadU(d1, a + c), LoadU(d1, b + c)), d1, x + c);
+				x += stride;
+				a += stride;
+				b += stride;
+			}
+		}
+		// distance between consecutive samples of a band
+		const size_t stride;
+		const size_t cols;
+	};
+
+	/**
+	 * Lift band x from its two neighbours in band y, i.e.
+	 * x(i) = op(x(i), y(i + off), y(i + off + 1)),
+	 * where y indices are clamped to [0, ny - 1] (symmetric extension)
+	 */
+	template<typename T, typename LIFTER, typename OP>
+	void lift(const LIFTER& lf, T* x, uint32_t nx, const T* y, uint32_t ny, int32_t off, OP op)
+	{
+		auto ySample = [&lf, y, ny](int64_t i) {
+			return y + (size_t)std::clamp<int64_t>(i, 0, (int64_t)ny - 1) * lf.stride;
+		};
+		int64_t begin = std::min<int64_t>(nx, std::max<int64_t>(0, -off));
+		int64_t end = std::max<int64_t>(begin, std::min<int64_t>(nx, (int64_t)ny - 1 - off));
+		for(int64_t i = 0; i < begin; ++i)
+			lf.step(x + (size_t)i * lf.stride, ySample(i + off), ySample(i + off + 1), 1, op);
+		if(end > begin)
+			lf.step(x + (size_t)begin * lf.stride, ySample(begin + off), ySample(begin + off + 1),
+					(size_t)(end - begin), op);
+		for(int64_t i = end; i < nx; ++i)
+			lf.step(x + (size_t)i * lf.stride, ySample(i + off), ySample(i + off + 1), 1, op);
 	}
-	if(m < end)
+
+	/**
+	 * Forward 5/3 lifting on deinterleaved bands L (sn samples) and H (dn samples)
+	 */
+	template<typename LIFTER>
+	void encode_53(const LIFTER& lf, int32_t* L, uint32_t sn, int32_t* H, uint32_t dn, bool even)
 	{
-		assert(m + 1 == end);
-		fw[-1] += (2 * fw[-2]) * c;
+		if(sn + dn == 1)
+		{
+			if(!even)
+				lf.step(H, H, H, 1, Twice53());
+			return;
+		}
+		int32_t parity = even ? 0 : 1;
+		lift(lf, H, dn, L, sn, -parity, Predict53());
+		lift(lf, L, sn, H, dn, parity - 1, Update53());
 	}
-}
 
-void dwt97::encode_1_real(float* w, int32_t dn, int32_t sn, int32_t parity)
-{
-	int32_t a, b;
-	assert(dn + sn > 1);
-	if(parity == 0)
+	/**
+	 * Forward 9/7 lifting on deinterleaved bands L (sn samples) and H (dn samples)
+	 */
+	template<typename LIFTER>
+	void encode_97(const LIFTER& lf, float* L, uint32_t sn, float* H, uint32_t dn, bool even)
 	{
-		a = 0;
-		b = 1;
+		if(sn + dn == 1)
+			return;
+		int32_t parity = even ? 0 : 1;
+		lift(lf, H, dn, L, sn, -parity, Lift97(alpha));
+		lift(lf, L, sn, H, dn, parity - 1, Lift97(beta));
+		lift(lf, H, dn, L, sn, -parity, Lift97(gamma));
+		lift(lf, L, sn, H, dn, parity - 1, Lift97(delta));
+		lf.step(H, H, H, dn, Scale97(grk_K));
+		lf.step(L, L, L, sn, Scale97(grk_invK));
 	}
-	else
+
+	static void hwy_encode_h_53(int32_t* bands, uint32_t width, bool even)
 	{
-		a = 1;
-		b = 0;
+		uint32_t sn = (width + (even ? 1 : 0)) >> 1;
+		encode_53(RowLifter<int32_t>(), bands, sn, bands + sn, width - sn, even);
 	}
-	encode_step2(w + a, w + b + 1, (uint32_t)dn, (uint32_t)std::min<int32_t>(dn, sn - b), alpha);
-	encode_step2(w + b, w + a + 1, (uint32_t)sn, (uint32_t)std::min<int32_t>(sn, dn - a), beta);
-	encode_step2(w + a, w + b + 1, (uint32_t)dn, (uint32_t)std::min<int32_t>(dn, sn - b), gamma);
-	encode_step2(w + b, w + a + 1, (uint32_t)sn, (uint32_t)std::min<int32_t>(sn, dn - a), delta);
-#if 0
-    encode_step1(w + b, (uint32_t)dn,
-                         grk_K);
-    encode_step1(w + a, (uint32_t)sn,
-                         grk_invK);
-#else
-	if(a == 0)
-		encode_step1_combined(w, (uint32_t)sn, (uint32_t)dn, grk_invK, grk_K);
-	else
-		encode_step1_combined(w, (uint32_t)dn, (uint32_t)sn, grk_K, grk_invK);
-#endif
-}
-template<typename T, typename DWT>
-struct encode_h_job
-{
-	dwt_line<T> h;
-	uint32_t rw; /* Width of the resolution to process */
-	uint32_t w; /* Width of tiledp */
-	T* GRK_RESTRICT tiledp;
-	uint32_t min_j;
-	uint32_t max_j;
-	DWT dwt;
-};
 
-template<typename T, typename DWT>
-void encode_h_func(encode_h_job<T, DWT>* job)
-{
-	uint32_t j;
-	for(j = job->min_j; j < job->max_j; j++)
+	static void hwy_encode_h_97(float* bands, uint32_t width, bool even)
 	{
-		T* GRK_RESTRICT aj = (T*)job->tiledp + j * job->w;
-		job->dwt.encode_and_deinterleave_h_one_row((T*)aj, (T*)job->h.mem, job->rw,
-												   job->h.parity == 0 ? true : false);
+		uint32_t sn = (width + (even ? 1 : 0)) >> 1;
+		encode_97(RowLifter<float>(), bands, sn, bands + sn, width - sn, even);
 	}
-	grkAlignedFree(job->h.mem);
-	delete job;
-}
 
-template<typename T, typename DWT>
-struct encode_v_job
+	static void hwy_encode_v_53(int32_t* bands, uint32_t height, bool even, uint32_t pllCols)
+	{
+		uint32_t sn = (height + (even ? 1 : 0)) >> 1;
+		encode_53(ColLifter<int32_t>(pllCols), bands, sn, bands + (size_t)sn * pllCols,
+				  height - sn, even);
+	}
+
+	static void hwy_encode_v_97(float* bands, uint32_t height, bool even, uint32_t pllCols)
+	{
+		uint32_t sn = (height + (even ? 1 : 0)) >> 1;
+		encode_97(ColLifter<float>(pllCols), bands, sn, bands + (size_t)sn * pllCols,
+				  height - sn, even);
+	}
+} // namespace HWY_NAMESPACE
+} // namespace grk
+HWY_AFTER_NAMESPACE();
+
+#if HWY_ONCE
+namespace grk
 {
-	dwt_line<T> v;
-	uint32_t rh;
-	uint32_t w;
-	T* GRK_RESTRICT tiledp;
-	uint32_t min_j;
-	uint32_t max_j;
-	DWT dwt;
-};
+HWY_EXPORT(hwy_fwd_num_lanes);
+HWY_EXPORT(hwy_encode_h_53);
+HWY_EXPORT(hwy_encode_h_97);
+HWY_EXPORT(hwy_encode_v_53);
+HWY_EXPORT(hwy_encode_v_97);
 
-template<typename T, typename DWT>
-void encode_v_func(encode_v_job<T, DWT>* job)
+const uint32_t NB_ELTS_V8 = 8;
+
+/**
+ * Number of columns that we can process in parallel in the vertical pass: a hint,
+ * as the vertical kernels accept any number of columns
+ */
+static uint32_t pll_cols_fwd(void)
 {
-	uint32_t j;
-	for(j = job->min_j; j + NB_ELTS_V8 - 1 < job->max_j; j += NB_ELTS_V8)
-		job->dwt.encode_and_deinterleave_v((T*)job->tiledp + j, (T*)job->v.mem, job->rh,
-										   job->v.parity == 0, job->w, NB_ELTS_V8);
-	if(j < job->max_j)
-		job->dwt.encode_and_deinterleave_v((T*)job->tiledp + j, (T*)job->v.mem, job->rh,
-										   job->v.parity == 0, job->w, job->max_j - j);
-	grkAlignedFree(job->v.mem);
-	delete job;
+	return std::max<uint32_t>(NB_ELTS_V8,
+							  2 * (uint32_t)HWY_DYNAMIC_DISPATCH(hwy_fwd_num_lanes)());
 }
 
-/** Fetch up to cols <= NB_ELTS_V8 for each line, and put them in tmpOut */
-/* that has a NB_ELTS_V8 interleave factor. */
+/* <summary>                             */
+/* Forward lazy transform (horizontal).  */
+/* </summary>                            */
 template<typename T>
-void fetch_cols_vertical_pass(const T* array, T* tmp, uint32_t height, uint32_t stride_width,
-							  uint32_t cols)
+void deinterleave_h(const T* GRK_RESTRICT a, T* GRK_RESTRICT b, uint32_t dn, uint32_t sn,
+					uint32_t parity)
 {
-	if(cols == NB_ELTS_V8)
-	{
-		uint32_t k;
-		for(k = 0; k < height; ++k)
-			memcpy(tmp + NB_ELTS_V8 * k, array + k * stride_width, NB_ELTS_V8 * sizeof(T));
-	}
-	else
+	T* GRK_RESTRICT destPtr = b;
+	const T* GRK_RESTRICT src = a + parity;
+
+	for(uint32_t i = 0; i < sn; ++i)
 	{
-		uint32_t k;
-		for(k = 0; k < height; ++k)
-		{
-			uint32_t c;
-			for(c = 0; c < cols; c++)
-				tmp[NB_ELTS_V8 * k + c] = array[c + k * stride_width];
-			for(; c < NB_ELTS_V8; c++)
-				tmp[NB_ELTS_V8 * k + c] = 0;
-		}
+		*destPtr++ = *src;
+		src += 2;
 	}
-}
 
-/* Deinterleave result of forward transform, where cols <= NB_ELTS_V8 */
-/* and src contains NB_ELTS_V8 consecutive values for up to NB_ELTS_V8 */
-/* columns. */
-template<typename T>
-void deinterleave_v_cols(const T* GRK_RESTRICT src, T* GRK_RESTRICT dst, uint32_t dn, uint32_t sn,
-						 uint32_t stride_width, uint32_t parity, uint32_t cols)
-{
-	int32_t k;
-	int64_t i = sn;
-	T* GRK_RESTRICT destPtr = dst;
-	const T* GRK_RESTRICT srcPtr = src + parity * NB_ELTS_V8;
-	uint32_t c;
+	destPtr = b + sn;
+	src = a + 1 - parity;
 
-	for(k = 0; k < 2; k++)
+	for(uint32_t i = 0; i < dn; ++i)
 	{
-		while(i--)
-		{
-			if(cols == NB_ELTS_V8)
-			{
-				memcpy(destPtr, srcPtr, NB_ELTS_V8 * sizeof(T));
-			}
-			else
-			{
-				c = 0;
-				switch(cols)
-				{
-					case 7:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					case 6:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					case 5:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					case 4:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					case 3:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					case 2:
-						destPtr[c] = srcPtr[c];
-						c++; /* fallthru */
-					default:
-						destPtr[c] = srcPtr[c];
-						break;
-				}
-			}
-			destPtr += stride_width;
-			srcPtr += 2 * NB_ELTS_V8;
-		}
-
-		destPtr = dst + (size_t)sn * (size_t)stride_width;
-		srcPtr = src + (1 - parity) * NB_ELTS_V8;
-		i = dn;
+		*destPtr++ = *src;
+		src += 2;
 	}
 }
-void dwt97::grk_v8dwt_encode_step1(float* fw, uint32_t end, const float cst)
+
+/**
+ * Fetch up to cols <= pllCols columns from each line, deinterleaving
+ * the lines into low pass rows followed by high pass rows of tmp,
+ * where each tmp row holds pllCols values
+ */
+template<typename T>
+void fetch_cols_vertical_pass(const T* GRK_RESTRICT array, T* GRK_RESTRICT tmp, uint32_t height,
+							  bool even, uint32_t stride_width, uint32_t cols, uint32_t pllCols)
 {
-	uint32_t i;
-#ifdef __SSE__
-	__m128* vw = (__m128*)fw;
-	const __m128 vcst = _mm_set1_ps(cst);
-	for(i = 0; i < end; ++i)
-	{
-		vw[0] = _mm_mul_ps(vw[0], vcst);
-		vw[1] = _mm_mul_ps(vw[1], vcst);
-		vw += 2 * (NB_ELTS_V8 * sizeof(float) / sizeof(__m128));
-	}
-#else
-	uint32_t c;
-	for(i = 0; i < end; ++i)
+	const uint32_t sn = (height + (even ? 1 : 0)) >> 1;
+	for(uint32_t k = 0; k < height; ++k)
 	{
-		for(c = 0; c < NB_ELTS_V8; c++)
-			fw[i * 2 * NB_ELTS_V8 + c] *= cst;
+		uint32_t row = ((k & 1) == (even ? 0U : 1U)) ? k >> 1 : sn + (k >> 1);
+		auto dest = tmp + (size_t)row * pllCols;
+		memcpy(dest, array + (size_t)k * stride_width, cols * sizeof(T));
+		if(cols < pllCols)
+			memset(dest + cols, 0, (pllCols - cols) * sizeof(T));
 	}
-#endif
 }
 
-void dwt97::grk_v8dwt_encode_step2(float* fl, float* fw, uint32_t end, uint32_t m, float cst)
+/** Store the first cols columns of the deinterleaved tmp rows back to array */
+template<typename T>
+void store_cols_vertical_pass(const T* GRK_RESTRICT tmp, T* GRK_RESTRICT array, uint32_t height,
+							  uint32_t stride_width, uint32_t cols, uint32_t pllCols)
 {
-	uint32_t i;
-	uint32_t imax = std::min<uint32_t>(end, m);
-#ifdef __SSE__
-	__m128* vw = (__m128*)fw;
-	__m128 vcst = _mm_set1_ps(cst);
-	if(imax > 0)
-	{
-		__m128* vl = (__m128*)fl;
-		vw[-2] = _mm_add_ps(vw[-2], _mm_mul_ps(_mm_add_ps(vl[0], vw[0]), vcst));
-		vw[-1] = _mm_add_ps(vw[-1], _mm_mul_ps(_mm_add_ps(vl[1], vw[1]), vcst));
-		vw += 2 * (NB_ELTS_V8 * sizeof(float) / sizeof(__m128));
-		i = 1;
-
-		for(; i < imax; ++i)
-		{
-			vw[-2] = _mm_add_ps(vw[-2], _mm_mul_ps(_mm_add_ps(vw[-4], vw[0]), vcst));
-			vw[-1] = _mm_add_ps(vw[-1], _mm_mul_ps(_mm_add_ps(vw[-3], vw[1]), vcst));
-			vw += 2 * (NB_ELTS_V8 * sizeof(float) / sizeof(__m128));
-		}
-	}
-	if(m < end)
-	{
-		assert(m + 1 == end);
-		vcst = _mm_add_ps(vcst, vcst);
-		vw[-2] = _mm_add_ps(vw[-2], _mm_mul_ps(vw[-4], vcst));
-		vw[-1] = _mm_add_ps(vw[-1], _mm_mul_ps(vw[-3], vcst));
-	}
-#else
-	uint32_t c;
-	const int64_t NB_ELTS = (int64_t)NB_ELTS_V8;
-	if(imax > 0)
-	{
-		for(c = 0; c < NB_ELTS; c++)
-			fw[-1 * NB_ELTS + c] += (fl[0 * NB_ELTS + c] + fw[0 * NB_ELTS + c]) * cst;
-		fw += 2 * NB_ELTS;
-		i = 1;
-		for(; i < imax; ++i)
-		{
-			for(c = 0; c < NB_ELTS; c++)
-				fw[-1 * NB_ELTS + c] += (fw[-2 * NB_ELTS + c] + fw[0 * NB_ELTS + c]) * cst;
-			fw += 2 * NB_ELTS;
-		}
-	}
-	if(m < end)
-	{
-		assert(m + 1 == end);
-		for(c = 0; c < NB_ELTS; c++)
-			fw[-1 * NB_ELTS + c] += (2 * fw[-2 * NB_ELTS + c]) * cst;
-	}
-#endif
+	for(uint32_t k = 0; k < height; ++k)
+		memcpy(array + (size_t)k * stride_width, tmp + (size_t)k * pllCols, cols * sizeof(T));
 }
+
 /* <summary>                            */
-/* Forward 5-3 wavelet transform in 2-D. */
+/* Forward wavelet transform in 2-D. */
 /* </summary>                           */
 template<typename T, typename DWT>
 bool WaveletFwdImpl::encode_procedure(TileComponent* tilec)
@@ -408,45 +335,46 @@ bool WaveletFwdImpl::encode_procedure(TileComponent* tilec)
 	if(tilec->numresolutions == 1U)
 		return true;
 
-	int32_t i;
-	int32_t maxNumResolutions;
-	size_t dataSize;
-
-	// const int num_threads = grk_thread_pool_get_thread_count(tp);
 	uint32_t stride = tilec->getBuffer()->getHighestBufferResWindowREL()->stride;
 	T* GRK_RESTRICT tiledp = (T*)tilec->getBuffer()->getHighestBufferResWindowREL()->getBuffer();
 
-	maxNumResolutions = (int32_t)tilec->numresolutions - 1;
+	int32_t maxNumResolutions = (int32_t)tilec->numresolutions - 1;
 	auto currentRes = tilec->tileCompResolution + maxNumResolutions;
 	auto lastRes = currentRes - 1;
 
-	dataSize = max_resolution(tilec->tileCompResolution, tilec->numresolutions);
+	const uint32_t pllCols = pll_cols_fwd();
+	size_t dataSize = max_resolution(tilec->tileCompResolution, tilec->numresolutions);
 	/* overflow check */
-	if(dataSize > (SIZE_MAX / (NB_ELTS_V8 * sizeof(int32_t))))
+	if(dataSize > (SIZE_MAX / (pllCols * sizeof(T))))
 	{
 		GRK_ERROR("Forward wavelet overflow");
 		return false;
 	}
-	dataSize *= NB_ELTS_V8 * sizeof(int32_t);
-	auto bj = (T*)grkAlignedMalloc(dataSize);
-	/* dataSize is equal to 0 when numresolutions == 1 but bj is not used */
-	/* in that case, so do not error out */
-	if(dataSize != 0 && !bj)
-		return false;
-	i = maxNumResolutions;
-	uint32_t num_threads = ThreadPool::get()->num_threads() > 1 ? 2 : 1;
+	dataSize *= pllCols * sizeof(T);
+
+	// one scratch buffer per job, reused across resolutions
+	uint32_t numThreads = ExecSingleton::numThreads();
+	std::vector<T*> scratch;
+	bool rc = true;
+	for(uint32_t j = 0; j < numThreads; ++j)
+	{
+		auto mem = (T*)grkAlignedMalloc(dataSize);
+		if(!mem)
+		{
+			GRK_ERROR("Out of memory");
+			rc = false;
+			break;
+		}
+		scratch.push_back(mem);
+	}
 
 	DWT dwt;
-	while(i--)
+	for(int32_t i = maxNumResolutions; rc && i > 0; --i)
 	{
 		// width of the resolution level computed
 		uint32_t rw = (uint32_t)(currentRes->x1 - currentRes->x0);
 		// height of the resolution level computed
 		uint32_t rh = (uint32_t)(currentRes->y1 - currentRes->y0);
-		// width of the resolution level once lower than computed one
-		uint32_t rw1 = (uint32_t)(lastRes->x1 - lastRes->x0);
-		// height of the resolution level once lower than computed one
-		uint32_t rh1 = (uint32_t)(lastRes->y1 - lastRes->y0);
 
 		/* 0 = non inversion on horizontal filtering 1 = inversion between low-pass and high-pass
 		 * filtering */
@@ -455,123 +383,36 @@ bool WaveletFwdImpl::encode_procedure(TileComponent* tilec)
 		 * filtering   */
 		uint32_t parity_col = currentRes->y0 & 1;
 
-		uint32_t sn = rh1;
-		uint32_t dn = (uint32_t)(rh - rh1);
-
-		bool rc = true;
-
-		/* Perform vertical pass */
-		if(num_threads <= 1 || rw < 2 * NB_ELTS_V8)
-		{
-			uint32_t j;
-			for(j = 0; j + NB_ELTS_V8 - 1 < rw; j += NB_ELTS_V8)
-				dwt.encode_and_deinterleave_v((T*)tiledp + j, bj, rh, parity_col == 0, stride,
-											  NB_ELTS_V8);
-			if(j < rw)
-				dwt.encode_and_deinterleave_v((T*)tiledp + j, bj, rh, parity_col == 0, stride,
-											  rw - j);
-		}
-		else
-		{
-			uint32_t num_jobs = (uint32_t)num_threads;
-			uint32_t step_j;
-
-			if(rw < num_jobs)
-				num_jobs = rw;
-			step_j = ((rw / num_jobs) / NB_ELTS_V8) * NB_ELTS_V8;
-			std::vector<std::future<int>> results;
-			for(uint32_t j = 0; j < num_jobs; j++)
+		/* Perform vertical pass: each job transforms a contiguous range of column strips */
+		uint32_t numStrips = (rw + pllCols - 1) / pllCols;
+		uint32_t numJobs = std::min<uint32_t>(numThreads, numStrips);
+		ExecSingleton::forkJoin(numJobs, [&](uint32_t index) {
+			uint32_t stripEnd = (uint32_t)(((uint64_t)index + 1) * numStrips / numJobs);
+			for(uint32_t s = (uint32_t)((uint64_t)index * numStrips / numJobs); s < stripEnd; ++s)
 			{
-				auto job = new encode_v_job<T, DWT>();
-				job->v.mem = (T*)grkAlignedMalloc(dataSize);
-				if(!job->v.mem)
-				{
-					delete job;
-					grkAlignedFree(bj);
-					rc = false;
-					break;
-				}
-				job->v.dn = dn;
-				job->v.sn = sn;
-				job->v.parity = parity_col;
-				job->rh = rh;
-				job->w = stride;
-				job->tiledp = tiledp;
-				job->min_j = j * step_j;
-				job->max_j = (j + 1 == num_jobs) ? rw : (j + 1) * step_j;
-				results.emplace_back(ThreadPool::get()->enqueue([job] {
-					encode_v_func<T>(job);
-					return 0;
-				}));
+				uint32_t j = s * pllCols;
+				dwt.encode_and_deinterleave_v(tiledp + j, scratch[index], rh, parity_col == 0,
+											  stride, std::min<uint32_t>(pllCols, rw - j),
+											  pllCols);
 			}
-			for(auto& result : results)
-				result.get();
-			if(!rc)
-				return false;
-		}
+		});
 
-		sn = rw1;
-		dn = (uint32_t)(rw - rw1);
+		/* Perform horizontal pass: each job transforms a contiguous range of rows */
+		numJobs = std::min<uint32_t>(numThreads, rh);
+		ExecSingleton::forkJoin(numJobs, [&](uint32_t index) {
+			uint32_t rowEnd = (uint32_t)(((uint64_t)index + 1) * rh / numJobs);
+			for(uint32_t j = (uint32_t)((uint64_t)index * rh / numJobs); j < rowEnd; ++j)
+				dwt.encode_and_deinterleave_h_one_row(tiledp + (size_t)j * stride, scratch[index],
+													  rw, parity_row == 0);
+		});
 
-		/* Perform horizontal pass */
-		if(num_threads <= 1 || rh <= 1)
-		{
-			uint32_t j;
-			DWT dwt;
-			for(j = 0; j < rh; j++)
-			{
-				T* GRK_RESTRICT aj = (T*)(tiledp) + j * stride;
-				dwt.encode_and_deinterleave_h_one_row(aj, bj, rw, parity_row == 0 ? true : false);
-			}
-		}
-		else
-		{
-			uint32_t num_jobs = (uint32_t)num_threads;
-			uint32_t step_j;
-
-			if(rh < num_jobs)
-				num_jobs = rh;
-			step_j = (rh / num_jobs);
-			std::vector<std::future<int>> results;
-			for(uint32_t j = 0; j < num_jobs; j++)
-			{
-				auto job = new encode_h_job<T, DWT>();
-				job->h.mem = (T*)grkAlignedMalloc(dataSize);
-				if(!job->h.mem)
-				{
-					delete job;
-					grkAlignedFree(bj);
-					rc = false;
-					break;
-				}
-				job->h.dn = dn;
-				job->h.sn = sn;
-				job->h.parity = parity_row;
-				job->rw = rw;
-				job->w = stride;
-				job->tiledp = tiledp;
-				job->min_j = j * step_j;
-				job->max_j = (j + 1U) * step_j; // this can overflow
-				if(j == (num_jobs - 1U))
-				{ // this will take care of the overflow
-					job->max_j = rh;
-				}
-				results.emplace_back(ThreadPool::get()->enqueue([job] {
-					encode_h_func<T, DWT>(job);
-					return 0;
-				}));
-			}
-			for(auto& result : results)
-				result.get();
-			if(!rc)
-				return false;
-		}
 		currentRes = lastRes;
 		--lastRes;
 	}
+	for(auto mem : scratch)
+		grkAlignedFree(mem);
 
-	grkAlignedFree(bj);
-	return true;
+	return rc;
 }
 
 bool WaveletFwdImpl::compress(TileComponent* tile_comp, uint8_t qmfbid)
@@ -587,334 +428,47 @@ bool WaveletFwdImpl::compress(TileComponent* tile_comp, uint8_t qmfbid)
 //////////////////////////////////////////////////////////////////////////////////////////////
 
 /* Forward 5-3 transform, for the vertical pass, processing cols columns */
-/* where cols <= NB_ELTS_V8 */
+/* where cols <= pllCols */
 void dwt53::encode_and_deinterleave_v(int32_t* arrayIn, int32_t* tmpIn, uint32_t height, bool even,
-									  uint32_t stride_width, uint32_t cols)
+									  uint32_t stride_width, uint32_t cols, uint32_t pllCols)
 {
-	int32_t* GRK_RESTRICT array = (int32_t * GRK_RESTRICT) arrayIn;
-	int32_t* GRK_RESTRICT tmp = (int32_t * GRK_RESTRICT) tmpIn;
-	const uint32_t sn = (height + (even ? 1 : 0)) >> 1;
-	const uint32_t dn = height - sn;
-
-	fetch_cols_vertical_pass<int32_t>(arrayIn, tmpIn, height, stride_width, cols);
-
-#define GRK_Sc(i) tmp[(i)*2 * NB_ELTS_V8 + c]
-#define GRK_Dc(i) tmp[((1 + (i)*2)) * NB_ELTS_V8 + c]
-
-#ifdef __SSE2__
-	if(height == 1)
-	{
-		if(!even)
-		{
-			uint32_t c;
-			for(c = 0; c < NB_ELTS_V8; c++)
-				tmp[c] *= 2;
-		}
-	}
-	else if(even)
-	{
-		uint32_t c;
-		uint32_t i;
-		i = 0;
-		if(i + 1 < sn)
-		{
-			__m128i xmm_Si_0 = *(const __m128i*)(tmp + 4 * 0);
-			__m128i xmm_Si_1 = *(const __m128i*)(tmp + 4 * 1);
-			for(; i + 1 < sn; i++)
-			{
-				__m128i xmm_Sip1_0 = *(const __m128i*)(tmp + (i + 1) * 2 * NB_ELTS_V8 + 4 * 0);
-				__m128i xmm_Sip1_1 = *(const __m128i*)(tmp + (i + 1) * 2 * NB_ELTS_V8 + 4 * 1);
-				__m128i xmm_Di_0 = *(const __m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 0);
-				__m128i xmm_Di_1 = *(const __m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 1);
-				xmm_Di_0 =
-					_mm_sub_epi32(xmm_Di_0, _mm_srai_epi32(_mm_add_epi32(xmm_Si_0, xmm_Sip1_0), 1));
-				xmm_Di_1 =
-					_mm_sub_epi32(xmm_Di_1, _mm_srai_epi32(_mm_add_epi32(xmm_Si_1, xmm_Sip1_1), 1));
-				*(__m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 0) = xmm_Di_0;
-				*(__m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 1) = xmm_Di_1;
-				xmm_Si_0 = xmm_Sip1_0;
-				xmm_Si_1 = xmm_Sip1_1;
-			}
-		}
-		if(((height) % 2) == 0)
-		{
-			for(c = 0; c < NB_ELTS_V8; c++)
-				GRK_Dc(i) -= GRK_Sc(i);
-		}
-		for(c = 0; c < NB_ELTS_V8; c++)
-			GRK_Sc(0) += (GRK_Dc(0) + GRK_Dc(0) + 2) >> 2;
-		i = 1;
-		if(i < dn)
-		{
-			__m128i xmm_Dim1_0 = *(const __m128i*)(tmp + (1 + (i - 1) * 2) * NB_ELTS_V8 + 4 * 0);
-			__m128i xmm_Dim1_1 = *(const __m128i*)(tmp + (1 + (i - 1) * 2) * NB_ELTS_V8 + 4 * 1);
-			const __m128i xmm_two = _mm_set1_epi32(2);
-			for(; i < dn; i++)
-			{
-				__m128i xmm_Di_0 = *(const __m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 0);
-				__m128i xmm_Di_1 = *(const __m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 1);
-				__m128i xmm_Si_0 = *(const __m128i*)(tmp + (i * 2) * NB_ELTS_V8 + 4 * 0);
-				__m128i xmm_Si_1 = *(const __m128i*)(tmp + (i * 2) * NB_ELTS_V8 + 4 * 1);
-				xmm_Si_0 = _mm_add_epi32(
-					xmm_Si_0,
-					_mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(xmm_Dim1_0, xmm_Di_0), xmm_two), 2));
-				xmm_Si_1 = _mm_add_epi32(
-					xmm_Si_1,
-					_mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(xmm_Dim1_1, xmm_Di_1), xmm_two), 2));
-				*(__m128i*)(tmp + (i * 2) * NB_ELTS_V8 + 4 * 0) = xmm_Si_0;
-				*(__m128i*)(tmp + (i * 2) * NB_ELTS_V8 + 4 * 1) = xmm_Si_1;
-				xmm_Dim1_0 = xmm_Di_0;
-				xmm_Dim1_1 = xmm_Di_1;
-			}
-		}
-		if(((height) % 2) == 1)
-		{
-			for(c = 0; c < NB_ELTS_V8; c++)
-				GRK_Sc(i) += (GRK_Dc(i - 1) + GRK_Dc(i - 1) + 2) >> 2;
-		}
-	}
-	else
-	{
-		uint32_t c;
-		uint32_t i;
-		for(c = 0; c < NB_ELTS_V8; c++)
-		{
-			GRK_Sc(0) -= GRK_Dc(0);
-		}
-		i = 1;
-		if(i < sn)
-		{
-			__m128i xmm_Dim1_0 = *(const __m128i*)(tmp + (1 + (i - 1) * 2) * NB_ELTS_V8 + 4 * 0);
-			__m128i xmm_Dim1_1 = *(const __m128i*)(tmp + (1 + (i - 1) * 2) * NB_ELTS_V8 + 4 * 1);
-			for(; i < sn; i++)
-			{
-				__m128i xmm_Di_0 = *(const __m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 0);
-				__m128i xmm_Di_1 = *(const __m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 1);
-				__m128i xmm_Si_0 = *(const __m128i*)(tmp + (i * 2) * NB_ELTS_V8 + 4 * 0);
-				__m128i xmm_Si_1 = *(const __m128i*)(tmp + (i * 2) * NB_ELTS_V8 + 4 * 1);
-				xmm_Si_0 =
-					_mm_sub_epi32(xmm_Si_0, _mm_srai_epi32(_mm_add_epi32(xmm_Di_0, xmm_Dim1_0), 1));
-				xmm_Si_1 =
-					_mm_sub_epi32(xmm_Si_1, _mm_srai_epi32(_mm_add_epi32(xmm_Di_1, xmm_Dim1_1), 1));
-				*(__m128i*)(tmp + (i * 2) * NB_ELTS_V8 + 4 * 0) = xmm_Si_0;
-				*(__m128i*)(tmp + (i * 2) * NB_ELTS_V8 + 4 * 1) = xmm_Si_1;
-				xmm_Dim1_0 = xmm_Di_0;
-				xmm_Dim1_1 = xmm_Di_1;
-			}
-		}
-		if(((height) % 2) == 1)
-		{
-			for(c = 0; c < NB_ELTS_V8; c++)
-				GRK_Sc(i) -= GRK_Dc(i - 1);
-		}
-		i = 0;
-		if(i + 1 < dn)
-		{
-			__m128i xmm_Si_0 = *((const __m128i*)(tmp + 4 * 0));
-			__m128i xmm_Si_1 = *((const __m128i*)(tmp + 4 * 1));
-			const __m128i xmm_two = _mm_set1_epi32(2);
-			for(; i + 1 < dn; i++)
-			{
-				__m128i xmm_Sip1_0 = *(const __m128i*)(tmp + (i + 1) * 2 * NB_ELTS_V8 + 4 * 0);
-				__m128i xmm_Sip1_1 = *(const __m128i*)(tmp + (i + 1) * 2 * NB_ELTS_V8 + 4 * 1);
-				__m128i xmm_Di_0 = *(const __m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 0);
-				__m128i xmm_Di_1 = *(const __m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 1);
-				xmm_Di_0 = _mm_add_epi32(
-					xmm_Di_0,
-					_mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(xmm_Si_0, xmm_Sip1_0), xmm_two), 2));
-				xmm_Di_1 = _mm_add_epi32(
-					xmm_Di_1,
-					_mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(xmm_Si_1, xmm_Sip1_1), xmm_two), 2));
-				*(__m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 0) = xmm_Di_0;
-				*(__m128i*)(tmp + (1 + i * 2) * NB_ELTS_V8 + 4 * 1) = xmm_Di_1;
-				xmm_Si_0 = xmm_Sip1_0;
-				xmm_Si_1 = xmm_Sip1_1;
-			}
-		}
-		if(((height) % 2) == 0)
-		{
-			for(c = 0; c < NB_ELTS_V8; c++)
-				GRK_Dc(i) += (GRK_Sc(i) + GRK_Sc(i) + 2) >> 2;
-		}
-	}
-#else
-	if(even)
-	{
-		uint32_t c;
-		if(height > 1)
-		{
-			uint32_t i;
-			for(i = 0; i + 1 < sn; i++)
-			{
-				for(c = 0; c < NB_ELTS_V8; c++)
-					GRK_Dc(i) -= (GRK_Sc(i) + GRK_Sc(i + 1)) >> 1;
-			}
-			if(((height) % 2) == 0)
-			{
-				for(c = 0; c < NB_ELTS_V8; c++)
-					GRK_Dc(i) -= GRK_Sc(i);
-			}
-			for(c = 0; c < NB_ELTS_V8; c++)
-				GRK_Sc(0) += (GRK_Dc(0) + GRK_Dc(0) + 2) >> 2;
-			for(i = 1; i < dn; i++)
-			{
-				for(c = 0; c < NB_ELTS_V8; c++)
-					GRK_Sc(i) += (GRK_Dc(i - 1) + GRK_Dc(i) + 2) >> 2;
-			}
-			if(((height) % 2) == 1)
-			{
-				for(c = 0; c < NB_ELTS_V8; c++)
-					GRK_Sc(i) += (GRK_Dc(i - 1) + GRK_Dc(i - 1) + 2) >> 2;
-			}
-		}
-	}
-	else
-	{
-		uint32_t c;
-		if(height == 1)
-		{
-			for(c = 0; c < NB_ELTS_V8; c++)
-				GRK_Sc(0) *= 2;
-		}
-		else
-		{
-			uint32_t i;
-			for(c = 0; c < NB_ELTS_V8; c++)
-				GRK_Sc(0) -= GRK_Dc(0);
-			for(i = 1; i < sn; i++)
-			{
-				for(c = 0; c < NB_ELTS_V8; c++)
-					GRK_Sc(i) -= (GRK_Dc(i) + GRK_Dc(i - 1)) >> 1;
-			}
-			if(((height) % 2) == 1)
-			{
-				for(c = 0; c < NB_ELTS_V8; c++)
-					GRK_Sc(i) -= GRK_Dc(i - 1);
-			}
-			for(i = 0; i + 1 < dn; i++)
-			{
-				for(c = 0; c < NB_ELTS_V8; c++)
-					GRK_Dc(i) += (GRK_Sc(i) + GRK_Sc(i + 1) + 2) >> 2;
-			}
-			if(((height) % 2) == 0)
-			{
-				for(c = 0; c < NB_ELTS_V8; c++)
-					GRK_Dc(i) += (GRK_Sc(i) + GRK_Sc(i) + 2) >> 2;
-			}
-		}
-	}
-#endif
-
-	if(cols == NB_ELTS_V8)
-		deinterleave_v_cols(tmp, array, dn, sn, stride_width, even ? 0 : 1, NB_ELTS_V8);
-	else
-		deinterleave_v_cols(tmp, array, dn, sn, stride_width, even ? 0 : 1, cols);
+	fetch_cols_vertical_pass(arrayIn, tmpIn, height, even, stride_width, cols, pllCols);
+	HWY_DYNAMIC_DISPATCH(hwy_encode_v_53)(tmpIn, height, even, pllCols);
+	store_cols_vertical_pass(tmpIn, arrayIn, height, stride_width, cols, pllCols);
 }
 
 /** Process one line for the horizontal pass of the 5x3 forward transform */
 void dwt53::encode_and_deinterleave_h_one_row(int32_t* rowIn, int32_t* tmpIn, uint32_t width,
 											  bool even)
 {
-	int32_t* GRK_RESTRICT row = (int32_t*)rowIn;
-	int32_t* GRK_RESTRICT tmp = (int32_t*)tmpIn;
-	const int32_t sn = (int32_t)((width + (even ? 1 : 0)) >> 1);
-	const int32_t dn = (int32_t)(width - (uint32_t)sn);
-
-	if(even)
-	{
-		if(width > 1)
-		{
-			int32_t i;
-			for(i = 0; i < sn - 1; i++)
-				tmp[sn + i] = row[2 * i + 1] - ((row[(i)*2] + row[(i + 1) * 2]) >> 1);
-			if((width % 2) == 0)
-				tmp[sn + i] = row[2 * i + 1] - row[(i)*2];
-			row[0] += (tmp[sn] + tmp[sn] + 2) >> 2;
-			for(i = 1; i < dn; i++)
-				row[i] = row[2 * i] + ((tmp[sn + (i - 1)] + tmp[sn + i] + 2) >> 2);
-			if((width % 2) == 1)
-				row[i] = row[2 * i] + ((tmp[sn + (i - 1)] + tmp[sn + (i - 1)] + 2) >> 2);
-			memcpy(row + sn, tmp + sn, (size_t)dn * sizeof(int32_t));
-		}
-	}
-	else
-	{
-		if(width == 1)
-		{
-			row[0] *= 2;
-		}
-		else
-		{
-			int32_t i;
-			tmp[sn + 0] = row[0] - row[1];
-			for(i = 1; i < sn; i++)
-				tmp[sn + i] = row[2 * i] - ((row[2 * i + 1] + row[2 * (i - 1) + 1]) >> 1);
-			if((width % 2) == 1)
-				tmp[sn + i] = row[2 * i] - row[2 * (i - 1) + 1];
-			for(i = 0; i < dn - 1; i++)
-				row[i] = row[2 * i + 1] + ((tmp[sn + i] + tmp[sn + i + 1] + 2) >> 2);
-			if((width % 2) == 0)
-				row[i] = row[2 * i + 1] + ((tmp[sn + i] + tmp[sn + i] + 2) >> 2);
-			memcpy(row + sn, tmp + sn, (size_t)dn * sizeof(int32_t));
-		}
-	}
+	const uint32_t sn = (width + (even ? 1 : 0)) >> 1;
+	deinterleave_h(rowIn, tmpIn, width - sn, sn, even ? 0 : 1);
+	HWY_DYNAMIC_DISPATCH(hwy_encode_h_53)(tmpIn, width, even);
+	memcpy(rowIn, tmpIn, width * sizeof(int32_t));
 }
 
 /* Forward 9-7 transform, for the vertical pass, processing cols columns */
-/* where cols <= NB_ELTS_V8 */
+/* where cols <= pllCols */
 void dwt97::encode_and_deinterleave_v(float* arrayIn, float* tmpIn, uint32_t height, bool even,
-									  uint32_t stride_width, uint32_t cols)
+									  uint32_t stride_width, uint32_t cols, uint32_t pllCols)
 {
-	float* GRK_RESTRICT array = (float* GRK_RESTRICT)arrayIn;
-	float* GRK_RESTRICT tmp = (float* GRK_RESTRICT)tmpIn;
-	const uint32_t sn = (height + (even ? 1 : 0)) >> 1;
-	const uint32_t dn = height - sn;
-	uint32_t a, b;
-
 	if(height == 1)
 		return;
-
-	fetch_cols_vertical_pass(arrayIn, tmpIn, height, stride_width, cols);
-
-	if(even)
-	{
-		a = 0;
-		b = 1;
-	}
-	else
-	{
-		a = 1;
-		b = 0;
-	}
-	grk_v8dwt_encode_step2(tmp + a * NB_ELTS_V8, tmp + (b + 1) * NB_ELTS_V8, dn,
-						   std::min<uint32_t>(dn, sn - b), alpha);
-	grk_v8dwt_encode_step2(tmp + b * NB_ELTS_V8, tmp + (a + 1) * NB_ELTS_V8, sn,
-						   std::min<uint32_t>(sn, dn - a), beta);
-	grk_v8dwt_encode_step2(tmp + a * NB_ELTS_V8, tmp + (b + 1) * NB_ELTS_V8, dn,
-						   std::min<uint32_t>(dn, sn - b), gamma);
-	grk_v8dwt_encode_step2(tmp + b * NB_ELTS_V8, tmp + (a + 1) * NB_ELTS_V8, sn,
-						   std::min<uint32_t>(sn, dn - a), delta);
-	grk_v8dwt_encode_step1(tmp + b * NB_ELTS_V8, (uint32_t)dn, grk_K);
-	grk_v8dwt_encode_step1(tmp + a * NB_ELTS_V8, (uint32_t)sn, grk_invK);
-
-	if(cols == NB_ELTS_V8)
-		deinterleave_v_cols(tmp, array, dn, sn, stride_width, even ? 0 : 1, NB_ELTS_V8);
-	else
-		deinterleave_v_cols(tmp, array, dn, sn, stride_width, even ? 0 : 1, cols);
+	fetch_cols_vertical_pass(arrayIn, tmpIn, height, even, stride_width, cols, pllCols);
+	HWY_DYNAMIC_DISPATCH(hwy_encode_v_97)(tmpIn, height, even, pllCols);
+	store_cols_vertical_pass(tmpIn, arrayIn, height, stride_width, cols, pllCols);
 }
 
 /** Process one line for the horizontal pass of the 9x7 forward transform */
 void dwt97::encode_and_deinterleave_h_one_row(float* rowIn, float* tmpIn, uint32_t width, bool even)
 {
-	float* GRK_RESTRICT row = (float*)rowIn;
-	float* GRK_RESTRICT tmp = (float*)tmpIn;
-	const int32_t sn = (int32_t)((width + (even ? 1 : 0)) >> 1);
-	const int32_t dn = (int32_t)(width - (uint32_t)sn);
 	if(width == 1)
 		return;
-	memcpy(tmp, row, width * sizeof(float));
-	encode_1_real(tmp, dn, sn, even ? 0 : 1);
-	deinterleave_h(tmp, row, dn, sn, even ? 0 : 1);
+	const uint32_t sn = (width + (even ? 1 : 0)) >> 1;
+	deinterleave_h(rowIn, tmpIn, width - sn, sn, even ? 0 : 1);
+	HWY_DYNAMIC_DISPATCH(hwy_encode_h_97)(tmpIn, width, even);
+	memcpy(rowIn, tmpIn, width * sizeof(float));
 }
 
 } // namespace grk
+#endif
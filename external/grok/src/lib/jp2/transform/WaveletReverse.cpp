@@ -285,6 +285,20 @@ struct decompress_job
 	uint32_t max_j;
 };
 
+/**
+ * Release jobs that were never run, for example after a failed allocation
+ */
+template<typename J>
+static void release_jobs(std::vector<J*>& jobs)
+{
+	for(auto job : jobs)
+	{
+		job->data.release();
+		delete job;
+	}
+	jobs.clear();
+}
+
 /** Number of columns that we can process in parallel in the vertical pass */
 #undef PLL_COLS_53
 #define PLL_COLS_53 (2 * uint32_t(HWY_DYNAMIC_DISPATCH(hwy_num_lanes)()))
@@ -698,7 +712,7 @@ static bool decompress_h_mt_53(uint32_t num_threads, size_t data_size, dwt_data<
 		if(rh < num_jobs)
 			num_jobs = rh;
 		uint32_t step_j = (rh / num_jobs);
-		std::vector<std::future<int>> results;
+		std::vector<decompress_job<int32_t, dwt_data<int32_t>>*> jobs;
 		for(uint32_t j = 0; j < num_jobs; ++j)
 		{
 			auto min_j = j * step_j;
@@ -706,23 +720,23 @@ static bool decompress_h_mt_53(uint32_t num_threads, size_t data_size, dwt_data<
 				horiz, bandL + min_j * strideL, strideL, bandH + min_j * strideH, strideH, nullptr,
 				0, nullptr, 0, dest + min_j * strideDest, strideDest, j * step_j,
 				j < (num_jobs - 1U) ? (j + 1U) * step_j : rh);
+			jobs.push_back(job);
 			if(!job->data.alloc(data_size))
 			{
 				GRK_ERROR("Out of memory");
 				horiz.release();
+				release_jobs(jobs);
 				return false;
 			}
-			results.emplace_back(ThreadPool::get()->enqueue([job] {
-				decompress_h_strip_53(&job->data, job->min_j, job->max_j, job->bandLL,
-									  job->strideLL, job->bandHL, job->strideHL, job->dest,
-									  job->strideDest);
-				job->data.release();
-				delete job;
-				return 0;
-			}));
 		}
-		for(auto& result : results)
-			result.get();
+		ExecSingleton::forkJoin(num_jobs, [&jobs](uint32_t index) {
+			auto job = jobs[index];
+			decompress_h_strip_53(&job->data, job->min_j, job->max_j, job->bandLL,
+								  job->strideLL, job->bandHL, job->strideHL, job->dest,
+								  job->strideDest);
+			job->data.release();
+			delete job;
+		});
 	}
 	return true;
 }
@@ -767,48 +781,49 @@ static bool decompress_v_mt_53(uint32_t num_threads, size_t data_size, dwt_data<
 		if(rw < num_jobs)
 			num_jobs = rw;
 		uint32_t step_j = (rw / num_jobs);
-		std::vector<std::future<int>> results;
+		std::vector<decompress_job<int32_t, dwt_data<int32_t>>*> jobs;
 		for(uint32_t j = 0; j < num_jobs; j++)
 		{
 			auto min_j = j * step_j;
 			auto job = new decompress_job<int32_t, dwt_data<int32_t>>(
 				vert, bandL + min_j, strideL, nullptr, 0, bandH + min_j, strideH, nullptr, 0,
 				dest + min_j, strideDest, j * step_j, j < (num_jobs - 1U) ? (j + 1U) * step_j : rw);
+			jobs.push_back(job);
 			if(!job->data.alloc(data_size))
 			{
 				GRK_ERROR("Out of memory");
 				vert.release();
+				release_jobs(jobs);
 				return false;
 			}
-			results.emplace_back(ThreadPool::get()->enqueue([job] {
-				decompress_v_strip_53(&job->data, job->min_j, job->max_j, job->bandLL,
-									  job->strideLL, job->bandLH, job->strideLH, job->dest,
-									  job->strideDest);
-				job->data.release();
-				delete job;
-				return 0;
-			}));
 		}
-		for(auto& result : results)
-			result.get();
+		ExecSingleton::forkJoin(num_jobs, [&jobs](uint32_t index) {
+			auto job = jobs[index];
+			decompress_v_strip_53(&job->data, job->min_j, job->max_j, job->bandLL,
+								  job->strideLL, job->bandLH, job->strideLH, job->dest,
+								  job->strideDest);
+			job->data.release();
+			delete job;
+		});
 	}
 	return true;
 }
 
 /* <summary>                            */
-/* Inverse wavelet transform in 2-D.    */
+/* Inverse wavelet transform in 2-D,   */
+/* from resolution res - 1 to res.      */
 /* </summary>                           */
-static bool decompress_tile_53(TileComponent* tilec, uint32_t numres)
+static bool decompress_res_53(TileComponent* tilec, uint8_t res)
 {
-	if(numres == 1U)
-		return true;
-
-	auto tr = tilec->tileCompResolution;
+	assert(res > 0);
+	auto tr = tilec->tileCompResolution + res;
 	uint32_t rw = tr->width();
 	uint32_t rh = tr->height();
+	if(rw == 0 || rh == 0)
+		return true;
 
-	uint32_t num_threads = (uint32_t)ThreadPool::get()->num_threads();
-	size_t data_size = max_resolution(tr, numres);
+	uint32_t num_threads = ExecSingleton::numThreads();
+	size_t data_size = max_resolution(tilec->tileCompResolution, (uint32_t)res + 1);
 	/* overflow check */
 	if(data_size > (SIZE_MAX / PLL_COLS_53 / sizeof(int32_t)))
 	{
@@ -821,58 +836,62 @@ static bool decompress_tile_53(TileComponent* tilec, uint32_t numres)
 	dwt_data<int32_t> horiz;
 	dwt_data<int32_t> vert;
 	data_size *= PLL_COLS_53 * sizeof(int32_t);
-	bool rc = true;
+	horiz.sn_full = (tr - 1)->width();
+	vert.sn_full = (tr - 1)->height();
+	horiz.dn_full = rw - horiz.sn_full;
+	horiz.parity = tr->x0 & 1;
+	bool rc = decompress_h_mt_53(
+		num_threads, data_size, horiz, vert, vert.sn_full,
+		// LL
+		tilec->getBuffer()->getBufferResWindowREL(res - 1U)->getBuffer(),
+		tilec->getBuffer()->getBufferResWindowREL(res - 1U)->stride,
+		// HL
+		tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HL)->getBuffer(),
+		tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HL)->stride,
+		// lower split window
+		tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->getBuffer(),
+		tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->stride);
+	rc = rc &&
+		 decompress_h_mt_53(
+			 num_threads, data_size, horiz, vert, rh - vert.sn_full,
+			 // LH
+			 tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_LH)->getBuffer(),
+			 tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_LH)->stride,
+			 // HH
+			 tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HH)->getBuffer(),
+			 tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HH)->stride,
+			 // higher split window
+			 tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->getBuffer(),
+			 tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->stride);
+	vert.dn_full = rh - vert.sn_full;
+	vert.parity = tr->y0 & 1;
+	rc = rc && decompress_v_mt_53(num_threads, data_size, horiz, vert, rw,
+								  // lower split window
+								  tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->getBuffer(),
+								  tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->stride,
+								  // higher split window
+								  tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->getBuffer(),
+								  tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->stride,
+								  // resolution buffer
+								  tilec->getBuffer()->getBufferResWindowREL(res)->getBuffer(),
+								  tilec->getBuffer()->getBufferResWindowREL(res)->stride);
+	horiz.release();
+
+	return rc;
+}
+
+/* <summary>                            */
+/* Inverse wavelet transform in 2-D.    */
+/* </summary>                           */
+static bool decompress_tile_53(TileComponent* tilec, uint32_t numres)
+{
 	for(uint8_t res = 1; res < numres; ++res)
 	{
-		horiz.sn_full = rw;
-		vert.sn_full = rh;
-		++tr;
-		rw = tr->width();
-		rh = tr->height();
-		if(rw == 0 || rh == 0)
-			continue;
-		horiz.dn_full = rw - horiz.sn_full;
-		horiz.parity = tr->x0 & 1;
-		if(!decompress_h_mt_53(
-			   num_threads, data_size, horiz, vert, vert.sn_full,
-			   // LL
-			   tilec->getBuffer()->getBufferResWindowREL(res - 1U)->getBuffer(),
-			   tilec->getBuffer()->getBufferResWindowREL(res - 1U)->stride,
-			   // HL
-			   tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HL)->getBuffer(),
-			   tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HL)->stride,
-			   // lower split window
-			   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->getBuffer(),
-			   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->stride))
-			return false;
-		if(!decompress_h_mt_53(
-			   num_threads, data_size, horiz, vert, rh - vert.sn_full,
-			   // LH
-			   tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_LH)->getBuffer(),
-			   tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_LH)->stride,
-			   // HH
-			   tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HH)->getBuffer(),
-			   tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HH)->stride,
-			   // higher split window
-			   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->getBuffer(),
-			   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->stride))
-			return false;
-		vert.dn_full = rh - vert.sn_full;
-		vert.parity = tr->y0 & 1;
-		if(!decompress_v_mt_53(num_threads, data_size, horiz, vert, rw,
-							   // lower split window
-							   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->getBuffer(),
-							   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->stride,
-							   // higher split window
-							   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->getBuffer(),
-							   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->stride,
-							   // resolution buffer
-							   tilec->getBuffer()->getBufferResWindowREL(res)->getBuffer(),
-							   tilec->getBuffer()->getBufferResWindowREL(res)->stride))
+		if(!decompress_res_53(tilec, res))
 			return false;
 	}
-	horiz.release();
-	return rc;
+
+	return true;
 }
 
 //#undef __SSE__
@@ -1135,7 +1154,7 @@ static bool decompress_h_mt_97(uint32_t num_threads, size_t data_size,
 	}
 	else
 	{
-		std::vector<std::future<int>> results;
+		std::vector<decompress_job<float, dwt_data<vec4f>>*> jobs;
 		for(uint32_t j = 0; j < num_jobs; ++j)
 		{
 			auto min_j = j * step_j;
@@ -1143,22 +1162,22 @@ static bool decompress_h_mt_97(uint32_t num_threads, size_t data_size,
 				horiz, bandL + min_j * strideL, strideL, bandH + min_j * strideH, strideH, nullptr,
 				0, nullptr, 0, dest + min_j * strideDest, strideDest, 0,
 				(j < (num_jobs - 1U) ? (j + 1U) * step_j : rh) - min_j);
+			jobs.push_back(job);
 			if(!job->data.alloc(data_size))
 			{
 				GRK_ERROR("Out of memory");
 				horiz.release();
+				release_jobs(jobs);
 				return false;
 			}
-			results.emplace_back(ThreadPool::get()->enqueue([job] {
-				decompress_h_strip_97(&job->data, job->max_j, job->bandLL, job->strideLL,
-									  job->bandHL, job->strideHL, job->dest, job->strideDest);
-				job->data.release();
-				delete job;
-				return 0;
-			}));
 		}
-		for(auto& result : results)
-			result.get();
+		ExecSingleton::forkJoin(num_jobs, [&jobs](uint32_t index) {
+			auto job = jobs[index];
+			decompress_h_strip_97(&job->data, job->max_j, job->bandLL, job->strideLL,
+								  job->bandHL, job->strideHL, job->dest, job->strideDest);
+			job->data.release();
+			delete job;
+		});
 	}
 	return true;
 }
@@ -1236,7 +1255,7 @@ static bool decompress_v_mt_97(uint32_t num_threads, size_t data_size,
 	}
 	else
 	{
-		std::vector<std::future<int>> results;
+		std::vector<decompress_job<float, dwt_data<vec4f>>*> jobs;
 		for(uint32_t j = 0; j < num_jobs; j++)
 		{
 			auto min_j = j * step_j;
@@ -1244,40 +1263,41 @@ static bool decompress_v_mt_97(uint32_t num_threads, size_t data_size,
 				vert, bandL + min_j, strideL, nullptr, 0, bandH + min_j, strideH, nullptr, 0,
 				dest + min_j, strideDest, 0,
 				(j < (num_jobs - 1U) ? (j + 1U) * step_j : rw) - min_j);
+			jobs.push_back(job);
 			if(!job->data.alloc(data_size))
 			{
 				GRK_ERROR("Out of memory");
 				vert.release();
+				release_jobs(jobs);
 				return false;
 			}
-			results.emplace_back(ThreadPool::get()->enqueue([job, rh] {
-				decompress_v_strip_97(&job->data, job->max_j, rh, job->bandLL, job->strideLL,
-									  job->bandLH, job->strideLH, job->dest, job->strideDest);
-				job->data.release();
-				delete job;
-				return 0;
-			}));
 		}
-		for(auto& result : results)
-			result.get();
+		ExecSingleton::forkJoin(num_jobs, [&jobs, rh](uint32_t index) {
+			auto job = jobs[index];
+			decompress_v_strip_97(&job->data, job->max_j, rh, job->bandLL, job->strideLL,
+								  job->bandLH, job->strideLH, job->dest, job->strideDest);
+			job->data.release();
+			delete job;
+		});
 	}
 
 	return true;
 }
 
 /* <summary>                             */
-/* Inverse 9-7 wavelet transform in 2-D. */
+/* Inverse 9-7 wavelet transform in 2-D, */
+/* from resolution res - 1 to res.       */
 /* </summary>                            */
-static bool decompress_tile_97(TileComponent* GRK_RESTRICT tilec, uint32_t numres)
+static bool decompress_res_97(TileComponent* GRK_RESTRICT tilec, uint8_t res)
 {
-	if(numres == 1U)
-		return true;
-
-	auto tr = tilec->tileCompResolution;
+	assert(res > 0);
+	auto tr = tilec->tileCompResolution + res;
 	uint32_t rw = tr->width();
 	uint32_t rh = tr->height();
+	if(rw == 0 || rh == 0)
+		return true;
 
-	size_t data_size = max_resolution(tr, numres);
+	size_t data_size = max_resolution(tilec->tileCompResolution, (uint32_t)res + 1);
 	dwt_data<vec4f> horiz;
 	dwt_data<vec4f> vert;
 	if(!horiz.alloc(data_size))
@@ -1286,62 +1306,68 @@ static bool decompress_tile_97(TileComponent* GRK_RESTRICT tilec, uint32_t numre
 		return false;
 	}
 	vert.mem = horiz.mem;
-	uint32_t num_threads = (uint32_t)ThreadPool::get()->num_threads();
+	uint32_t num_threads = ExecSingleton::numThreads();
+	horiz.sn_full = (tr - 1)->width();
+	vert.sn_full = (tr - 1)->height();
+	horiz.dn_full = rw - horiz.sn_full;
+	horiz.parity = tr->x0 & 1;
+	horiz.win_l = grkLineU32(0, horiz.sn_full);
+	horiz.win_h = grkLineU32(0, horiz.dn_full);
+	bool rc = decompress_h_mt_97(
+		num_threads, data_size, horiz, vert.sn_full,
+		// LL
+		(float*)tilec->getBuffer()->getBufferResWindowREL(res - 1U)->getBuffer(),
+		tilec->getBuffer()->getBufferResWindowREL(res - 1U)->stride,
+		// HL
+		(float*)tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HL)->getBuffer(),
+		tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HL)->stride,
+		// lower split window
+		(float*)tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->getBuffer(),
+		tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->stride);
+	rc = rc &&
+		 decompress_h_mt_97(
+			 num_threads, data_size, horiz, rh - vert.sn_full,
+			 // LH
+			 (float*)tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_LH)->getBuffer(),
+			 tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_LH)->stride,
+			 // HH
+			 (float*)tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HH)->getBuffer(),
+			 tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HH)->stride,
+			 // higher split window
+			 (float*)tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->getBuffer(),
+			 tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->stride);
+	vert.dn_full = rh - vert.sn_full;
+	vert.parity = tr->y0 & 1;
+	vert.win_l = grkLineU32(0, vert.sn_full);
+	vert.win_h = grkLineU32(0, vert.dn_full);
+	rc = rc &&
+		 decompress_v_mt_97(
+			 num_threads, data_size, vert, rw, rh,
+			 // lower split window
+			 (float*)tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->getBuffer(),
+			 tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->stride,
+			 // higher split window
+			 (float*)tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->getBuffer(),
+			 tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->stride,
+			 // resolution window
+			 (float*)tilec->getBuffer()->getBufferResWindowREL(res)->getBuffer(),
+			 tilec->getBuffer()->getBufferResWindowREL(res)->stride);
+	horiz.release();
+
+	return rc;
+}
+
+/* <summary>                             */
+/* Inverse 9-7 wavelet transform in 2-D. */
+/* </summary>                            */
+static bool decompress_tile_97(TileComponent* GRK_RESTRICT tilec, uint32_t numres)
+{
 	for(uint8_t res = 1; res < numres; ++res)
 	{
-		horiz.sn_full = rw;
-		vert.sn_full = rh;
-		++tr;
-		rw = tr->width();
-		rh = tr->height();
-		if(rw == 0 || rh == 0)
-			continue;
-		horiz.dn_full = rw - horiz.sn_full;
-		horiz.parity = tr->x0 & 1;
-		horiz.win_l = grkLineU32(0, horiz.sn_full);
-		horiz.win_h = grkLineU32(0, horiz.dn_full);
-		if(!decompress_h_mt_97(
-			   num_threads, data_size, horiz, vert.sn_full,
-			   // LL
-			   (float*)tilec->getBuffer()->getBufferResWindowREL(res - 1U)->getBuffer(),
-			   tilec->getBuffer()->getBufferResWindowREL(res - 1U)->stride,
-			   // HL
-			   (float*)tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HL)->getBuffer(),
-			   tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HL)->stride,
-			   // lower split window
-			   (float*)tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->getBuffer(),
-			   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->stride))
-			return false;
-		if(!decompress_h_mt_97(
-			   num_threads, data_size, horiz, rh - vert.sn_full,
-			   // LH
-			   (float*)tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_LH)->getBuffer(),
-			   tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_LH)->stride,
-			   // HH
-			   (float*)tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HH)->getBuffer(),
-			   tilec->getBuffer()->getBandWindowREL(res, BAND_ORIENT_HH)->stride,
-			   // higher split window
-			   (float*)tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->getBuffer(),
-			   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->stride))
-			return false;
-		vert.dn_full = rh - vert.sn_full;
-		vert.parity = tr->y0 & 1;
-		vert.win_l = grkLineU32(0, vert.sn_full);
-		vert.win_h = grkLineU32(0, vert.dn_full);
-		if(!decompress_v_mt_97(
-			   num_threads, data_size, vert, rw, rh,
-			   // lower split window
-			   (float*)tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->getBuffer(),
-			   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_L)->stride,
-			   // higher split window
-			   (float*)tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->getBuffer(),
-			   tilec->getBuffer()->getSplitWindowREL(res, SPLIT_H)->stride,
-			   // resolution window
-			   (float*)tilec->getBuffer()->getBufferResWindowREL(res)->getBuffer(),
-			   tilec->getBuffer()->getBufferResWindowREL(res)->stride))
+		if(!decompress_res_97(tilec, res))
 			return false;
 	}
-	horiz.release();
+
 	return true;
 }
 
@@ -1916,7 +1942,7 @@ bool decompress_partial_tile(TileComponent* GRK_RESTRICT tilec, uint16_t compno,
 	}
 
 	D decompressor;
-	size_t num_threads = ThreadPool::get()->num_threads();
+	size_t num_threads = ExecSingleton::numThreads();
 
 	for(uint8_t resno = 1; resno < numres; resno++)
 	{
@@ -2105,35 +2131,26 @@ bool decompress_partial_tile(TileComponent* GRK_RESTRICT tilec, uint16_t compno,
 			uint32_t step_j = num_jobs ? (num_rows / num_jobs) : 0;
 			if(num_threads == 1 || step_j < HORIZ_PASS_HEIGHT)
 				num_jobs = 1;
-			std::vector<std::future<int>> results;
-			bool blockError = false;
+			std::vector<decompress_job<T, dwt_data<T>>*> jobs;
 			for(uint32_t j = 0; j < num_jobs; ++j)
 			{
 				auto job = new decompress_job<T, dwt_data<T>>(
 					horiz, splitWindowRect[k].y0 + j * step_j,
 					j < (num_jobs - 1U) ? splitWindowRect[k].y0 + (j + 1U) * step_j
 										: splitWindowRect[k].y1);
+				jobs.push_back(job);
 				if(!job->data.alloc(data_size, pad))
 				{
 					GRK_ERROR("Out of memory");
-					delete job;
+					release_jobs(jobs);
 					goto cleanup;
 				}
-				if(num_jobs > 1)
-				{
-					results.emplace_back(
-						ThreadPool::get()->enqueue([job, executor_h] { return executor_h(job); }));
-				}
-				else
-				{
-					blockError = (executor_h(job) != 0);
-				}
 			}
-			for(auto& result : results)
-			{
-				if(result.get() != 0)
+			std::atomic_bool blockError(false);
+			ExecSingleton::forkJoin(num_jobs, [&jobs, &executor_h, &blockError](uint32_t index) {
+				if(executor_h(jobs[index]) != 0)
 					blockError = true;
-			}
+			});
 			if(blockError)
 				goto cleanup;
 		}
@@ -2151,34 +2168,25 @@ bool decompress_partial_tile(TileComponent* GRK_RESTRICT tilec, uint16_t compno,
 		uint32_t step_j = num_jobs ? (num_cols / num_jobs) : 0;
 		if(num_threads == 1 || step_j < 4)
 			num_jobs = 1;
-		bool blockError = false;
-		std::vector<std::future<int>> results;
+		std::vector<decompress_job<T, dwt_data<T>>*> jobs;
 		for(uint32_t j = 0; j < num_jobs; ++j)
 		{
 			auto job = new decompress_job<T, dwt_data<T>>(
 				vert, resWindowRect.x0 + j * step_j,
 				j < (num_jobs - 1U) ? resWindowRect.x0 + (j + 1U) * step_j : resWindowRect.x1);
+			jobs.push_back(job);
 			if(!job->data.alloc(data_size, pad))
 			{
 				GRK_ERROR("Out of memory");
-				delete job;
+				release_jobs(jobs);
 				goto cleanup;
 			}
-			if(num_jobs > 1)
-			{
-				results.emplace_back(
-					ThreadPool::get()->enqueue([job, executor_v] { return executor_v(job); }));
-			}
-			else
-			{
-				blockError = (executor_v(job) != 0);
-			}
 		}
-		for(auto& result : results)
-		{
-			if(result.get() != 0)
+		std::atomic_bool blockError(false);
+		ExecSingleton::forkJoin(num_jobs, [&jobs, &executor_v, &blockError](uint32_t index) {
+			if(executor_v(jobs[index]) != 0)
 				blockError = true;
-		}
+		});
 		if(blockError)
 			goto cleanup;
 	}
@@ -2220,6 +2228,14 @@ cleanup:
 	return rc;
 }
 
+bool WaveletReverse::decompressResolution(TileComponent* tilec, uint8_t resno, uint8_t qmfbid)
+{
+	if(resno == 0)
+		return true;
+
+	return (qmfbid == 1) ? decompress_res_53(tilec, resno) : decompress_res_97(tilec, resno);
+}
+
 bool WaveletReverse::decompress(TileProcessor* p_tcd, TileComponent* tilec, uint16_t compno,
 								grkRectU32 window, uint8_t numres, uint8_t qmfbid)
 {
@@ -57,6 +57,12 @@ class WaveletReverse
   public:
 	bool decompress(TileProcessor* p_tcd, TileComponent* tilec, uint16_t compno, grkRectU32 window,
 					uint8_t numres, uint8_t qmfbid);
+	/**
+	 * Whole-tile synthesis of a single resolution from resolution resno - 1,
+	 * allowing the DWT of lower resolutions to overlap T1 of higher resolutions.
+	 * Resolution resno - 1 must already be synthesized.
+	 */
+	bool decompressResolution(TileComponent* tilec, uint8_t resno, uint8_t qmfbid);
 };
 
 } // namespace grk
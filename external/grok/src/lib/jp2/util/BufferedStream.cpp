@@ -30,8 +30,9 @@ void grk_read(const uint8_t* buffer, TYPE* value, uint32_t numBytes);
 BufferedStream::BufferedStream(uint8_t* buffer, size_t buffer_size, bool is_input)
 	: m_user_data(nullptr), m_free_user_data_fn(nullptr), m_user_data_length(0), m_read_fn(nullptr),
 	  m_zero_copy_read_fn(nullptr), m_write_fn(nullptr), m_seek_fn(nullptr),
-	  m_status(is_input ? GROK_STREAM_STATUS_INPUT : GROK_STREAM_STATUS_OUTPUT), m_buf(nullptr),
-	  m_buffered_bytes(0), m_read_bytes_seekable(0), m_stream_offset(0)
+	  m_read_ranges_fn(nullptr), m_prefetcher(nullptr), m_media_seek_pending(false), m_status(is_input ? GROK_STREAM_STATUS_INPUT : GROK_STREAM_STATUS_OUTPUT), m_buf(nullptr),
+	  m_buffered_bytes(0), m_read_bytes_seekable(0), m_stream_offset(0),
+	  m_ioStats(std::make_shared<StageStats>())
 {
 	m_buf = new grkBufferU8((!buffer && buffer_size) ? new uint8_t[buffer_size] : buffer,
 							buffer_size, buffer == nullptr);
@@ -40,6 +41,8 @@ BufferedStream::BufferedStream(uint8_t* buffer, size_t buffer_size, bool is_inpu
 
 BufferedStream::~BufferedStream()
 {
+	// prefetcher may still be reading from user data
+	delete m_prefetcher;
 	if(m_free_user_data_fn)
 		m_free_user_data_fn(m_user_data);
 	delete m_buf;
@@ -77,6 +80,10 @@ void BufferedStream::setSeekFunction(grk_stream_seek_fn fn)
 {
 	m_seek_fn = fn;
 }
+void BufferedStream::setReadRangesFunction(grk_stream_read_ranges_fn fn)
+{
+	m_read_ranges_fn = fn;
+}
 // note: passing in nullptr for buffer will execute a zero-copy read
 size_t BufferedStream::read(uint8_t* buffer, size_t p_size)
 {
@@ -148,7 +155,7 @@ size_t BufferedStream::read(uint8_t* buffer, size_t p_size)
 	invalidate_buffer();
 	while(true)
 	{
-		m_buffered_bytes = m_read_fn(m_buf->currPtr(), m_buf->len, m_user_data);
+		m_buffered_bytes = read_media(m_buf->currPtr(), m_buf->len);
 		// sanity check on external read function
 		if(m_buffered_bytes > m_buf->len)
 		{
@@ -202,6 +209,29 @@ size_t BufferedStream::read(uint8_t* buffer, size_t p_size)
 	}
 	return 0;
 }
+size_t BufferedStream::read_media(uint8_t* buffer, size_t p_size)
+{
+	if(m_prefetcher)
+	{
+		size_t prefetched = m_prefetcher->read(m_stream_offset, buffer, p_size);
+		if(prefetched)
+		{
+			m_media_seek_pending = true;
+			return prefetched;
+		}
+	}
+	StageTimer timer(m_ioStats.get());
+	if(m_media_seek_pending)
+	{
+		if(!m_seek_fn(m_stream_offset, m_user_data))
+			return 0;
+		m_media_seek_pending = false;
+	}
+	size_t bytesRead = m_read_fn(buffer, p_size, m_user_data);
+	timer.addBytes(bytesRead);
+
+	return bytesRead;
+}
 bool BufferedStream::writeByte(uint8_t value)
 {
 	return writeBytes(&value, 1) == 1;
@@ -263,7 +293,9 @@ size_t BufferedStream::writeBytes(const uint8_t* buffer, size_t p_size)
 	if(isMemStream())
 	{
 		/* we should do an actual write on the media */
+		StageTimer timer(m_ioStats.get());
 		auto current_write_nb_bytes = m_write_fn((uint8_t*)buffer, p_size, m_user_data);
+		timer.addBytes(current_write_nb_bytes);
 		writeIncrement(current_write_nb_bytes);
 
 		return current_write_nb_bytes;
@@ -319,7 +351,9 @@ bool BufferedStream::flush()
 	while(m_buffered_bytes)
 	{
 		/* we should do an actual write on the media */
+		StageTimer timer(m_ioStats.get());
 		size_t current_write_nb_bytes = m_write_fn(m_buf->currPtr(), m_buffered_bytes, m_user_data);
+		timer.addBytes(current_write_nb_bytes);
 
 		if(current_write_nb_bytes != m_buffered_bytes)
 		{
@@ -414,7 +448,19 @@ bool BufferedStream::read_seek(uint64_t offset)
 	// 2. Since we can't seek in buffer, we must invalidate
 	//  buffer contents and seek in media
 	invalidate_buffer();
-	if(!(m_seek_fn(offset, m_user_data)))
+	bool seekSuccess = true;
+	// media seek is deferred until the next media read, which
+	// may never happen if the new offset has been prefetched
+	if(m_prefetcher)
+	{
+		m_media_seek_pending = true;
+	}
+	else
+	{
+		StageTimer timer(m_ioStats.get());
+		seekSuccess = m_seek_fn(offset, m_user_data);
+	}
+	if(!seekSuccess)
 	{
 		m_status |= GROK_STREAM_STATUS_END;
 		return false;
@@ -444,7 +490,12 @@ bool BufferedStream::write_seek(uint64_t offset)
 		return false;
 	}
 	invalidate_buffer();
-	if(!m_seek_fn(offset, m_user_data))
+	bool seekSuccess;
+	{
+		StageTimer timer(m_ioStats.get());
+		seekSuccess = m_seek_fn(offset, m_user_data);
+	}
+	if(!seekSuccess)
 	{
 		m_status |= GROK_STREAM_STATUS_ERROR;
 		return false;
@@ -468,7 +519,37 @@ bool BufferedStream::hasSeek(void)
 {
 	return m_seek_fn != nullptr;
 }
+bool BufferedStream::supportsRangeRead(void)
+{
+	// memory streams have nothing to gain from reading ahead
+	return m_read_ranges_fn && m_seek_fn && !isMemStream() && (m_status & GROK_STREAM_STATUS_INPUT);
+}
+void BufferedStream::prefetch(std::vector<ByteRange>& ranges)
+{
+	if(!supportsRangeRead())
+		return;
+	// bytes before the end of the buffer will never be read from media
+	uint64_t start = m_stream_offset + m_buffered_bytes;
+	for(auto& r : ranges)
+	{
+		uint64_t end = (std::min)(r.offset + r.length, m_user_data_length);
+		if(end <= start)
+		{
+			r.length = 0;
+			continue;
+		}
+		r.offset = (std::max)(r.offset, start);
+		r.length = end - r.offset;
+	}
+	if(!m_prefetcher)
+		m_prefetcher = new StreamPrefetcher(m_read_ranges_fn, m_user_data, m_ioStats);
+	m_prefetcher->prefetch(ranges);
+}
 
+std::shared_ptr<StageStats> BufferedStream::getIOStats(void)
+{
+	return m_ioStats;
+}
 bool BufferedStream::isMemStream()
 {
 	return !m_buf->owns_data;
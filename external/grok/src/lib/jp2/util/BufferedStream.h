@@ -48,6 +48,7 @@ struct BufferedStream : public IBufferedStream
 	void setZeroCopyReadFunction(grk_stream_zero_copy_read_fn fn);
 	void setWriteFunction(grk_stream_write_fn fn);
 	void setSeekFunction(grk_stream_seek_fn fn);
+	void setReadRangesFunction(grk_stream_read_ranges_fn fn);
 	/**
 	 * Reads some bytes from the stream.
 	 * @param		buffer	pointer to the data buffer
@@ -114,6 +115,9 @@ struct BufferedStream : public IBufferedStream
 	bool hasSeek();
 	bool supportsZeroCopy();
 	uint8_t* getZeroCopyPtr();
+	bool supportsRangeRead(void);
+	void prefetch(std::vector<ByteRange>& ranges);
+	std::shared_ptr<StageStats> getIOStats(void);
 
   private:
 	~BufferedStream();
@@ -148,6 +152,15 @@ struct BufferedStream : public IBufferedStream
 	 */
 	bool write_seek(uint64_t offset);
 
+	/**
+	 * Read from media at current stream offset, or from prefetched ranges
+	 * @param		buffer		destination buffer
+	 * @param		p_size		maximum number of bytes to read
+
+	 * @return		the number of bytes read
+	 */
+	size_t read_media(uint8_t* buffer, size_t p_size);
+
 	void writeIncrement(size_t p_size);
 	template<typename TYPE>
 	bool write(TYPE value, uint8_t numBytes);
@@ -189,6 +202,19 @@ struct BufferedStream : public IBufferedStream
 	 * Pointer to actual seek function (if available).
 	 */
 	grk_stream_seek_fn m_seek_fn;
+	/**
+	 * Pointer to range read function (if available).
+	 */
+	grk_stream_read_ranges_fn m_read_ranges_fn;
+	/**
+	 * Reads ahead ranges requested by codec (nullptr until first prefetch)
+	 */
+	StreamPrefetcher* m_prefetcher;
+	/**
+	 * true if media position is out of sync with stream offset, because
+	 * reads were served by prefetcher, or seeks were deferred
+	 */
+	bool m_media_seek_pending;
 	/**
 	 * Stream status flags
 	 */
@@ -207,6 +233,8 @@ struct BufferedStream : public IBufferedStream
 
 	// number of bytes read/written from the beginning of the stream
 	uint64_t m_stream_offset;
+
+	std::shared_ptr<StageStats> m_ioStats;
 };
 
 template<typename TYPE>
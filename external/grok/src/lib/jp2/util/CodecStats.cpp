@@ -0,0 +1,114 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_includes.h"
+#include <chrono>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace grk
+{
+void StageStats::add(uint64_t numInvocations, uint64_t wall, uint64_t cpu, uint64_t numBytes)
+{
+	count.fetch_add(numInvocations, std::memory_order_relaxed);
+	wallNs.fetch_add(wall, std::memory_order_relaxed);
+	cpuNs.fetch_add(cpu, std::memory_order_relaxed);
+	bytes.fetch_add(numBytes, std::memory_order_relaxed);
+}
+void StageStats::addBytes(uint64_t numBytes)
+{
+	bytes.fetch_add(numBytes, std::memory_order_relaxed);
+}
+void StageStats::copyTo(grk_stage_stats* dest) const
+{
+	dest->count = count.load(std::memory_order_relaxed);
+	dest->wallNs = wallNs.load(std::memory_order_relaxed);
+	dest->cpuNs = cpuNs.load(std::memory_order_relaxed);
+	dest->bytes = bytes.load(std::memory_order_relaxed);
+}
+
+CodecStats::CodecStats(std::shared_ptr<StageStats> ioStats) : io(ioStats) {}
+StageStats* CodecStats::get(GRK_STAGE stage)
+{
+	if(stage == GRK_STAGE_IO)
+		return io.get();
+
+	return stage < GRK_NUM_STAGES ? stages + stage : nullptr;
+}
+void CodecStats::copyTo(grk_codec_stats* dest) const
+{
+	for(uint32_t i = 0; i < GRK_NUM_STAGES; ++i)
+		stages[i].copyTo(dest->stages + i);
+	if(io)
+		io->copyTo(dest->stages + GRK_STAGE_IO);
+}
+
+StageTimer::StageTimer(StageStats* stats)
+	: stats_(stats), wallStart_(0), cpuStart_(0), bytes_(0), count_(1)
+{
+	if(stats_)
+	{
+		wallStart_ = wallTimeNs();
+		cpuStart_ = threadCpuTimeNs();
+	}
+}
+StageTimer::StageTimer(CodecStats* stats, GRK_STAGE stage)
+	: StageTimer(stats ? stats->get(stage) : nullptr)
+{}
+StageTimer::~StageTimer()
+{
+	if(stats_ && count_)
+		stats_->add(count_, wallTimeNs() - wallStart_, threadCpuTimeNs() - cpuStart_, bytes_);
+}
+void StageTimer::addBytes(uint64_t numBytes)
+{
+	bytes_ += numBytes;
+}
+void StageTimer::setCount(uint64_t numInvocations)
+{
+	count_ = numInvocations;
+}
+uint64_t StageTimer::wallTimeNs(void)
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+uint64_t StageTimer::threadCpuTimeNs(void)
+{
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	if(!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+		return 0;
+	auto toNs = [](const FILETIME& t) {
+		return ((((uint64_t)t.dwHighDateTime) << 32) | t.dwLowDateTime) * 100;
+	};
+	return toNs(kernel) + toNs(user);
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+	struct timespec ts;
+	if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+		return 0;
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+#else
+	return 0;
+#endif
+}
+
+} // namespace grk
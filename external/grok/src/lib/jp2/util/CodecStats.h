@@ -0,0 +1,86 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace grk
+{
+/**
+ * Time and byte counters of a single codec stage, safe to update from any thread
+ */
+struct StageStats
+{
+	StageStats() : count(0), wallNs(0), cpuNs(0), bytes(0) {}
+	void add(uint64_t numInvocations, uint64_t wall, uint64_t cpu, uint64_t numBytes);
+	void addBytes(uint64_t numBytes);
+	void copyTo(grk_stage_stats* dest) const;
+
+	std::atomic<uint64_t> count;
+	std::atomic<uint64_t> wallNs;
+	std::atomic<uint64_t> cpuNs;
+	std::atomic<uint64_t> bytes;
+};
+
+/**
+ * Stage profile of a codec.
+ *
+ * I/O counters belong to the stream, which may outlive the codec or be
+ * released before it, so they are shared with the stream.
+ */
+class CodecStats
+{
+  public:
+	explicit CodecStats(std::shared_ptr<StageStats> ioStats);
+	StageStats* get(GRK_STAGE stage);
+	void copyTo(grk_codec_stats* dest) const;
+
+  private:
+	StageStats stages[GRK_NUM_STAGES];
+	std::shared_ptr<StageStats> io;
+};
+
+/**
+ * Adds wall time and thread CPU time, from construction to destruction,
+ * to a stage. A null stage is ignored.
+ *
+ * A timer counts as a single stage invocation, unless it spans several,
+ * such as a task that codes many code blocks.
+ */
+class StageTimer
+{
+  public:
+	explicit StageTimer(StageStats* stats);
+	StageTimer(CodecStats* stats, GRK_STAGE stage);
+	~StageTimer();
+	void addBytes(uint64_t numBytes);
+	void setCount(uint64_t numInvocations);
+
+	static uint64_t wallTimeNs(void);
+	static uint64_t threadCpuTimeNs(void);
+
+  private:
+	StageStats* stats_;
+	uint64_t wallStart_;
+	uint64_t cpuStart_;
+	uint64_t bytes_;
+	uint64_t count_;
+};
+
+} // namespace grk
@@ -0,0 +1,187 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace grk
+{
+/**
+ * Persistent work-stealing executor shared by all codecs in the process.
+ *
+ * The executor is created by grk_initialize and destroyed by grk_deinitialize,
+ * along with a small executor for blocking I/O that is created on first use.
+ * Tile task graphs are run on it directly, while nested stages (code blocks,
+ * DWT strips, MCT chunks) fan out through forkJoin, so that no stage ever
+ * creates its own threads.
+ */
+class ExecSingleton
+{
+  public:
+	static tf::Executor* get(void)
+	{
+		return instance(0);
+	}
+	static tf::Executor* instance(uint32_t numthreads)
+	{
+		std::unique_lock<std::mutex> lock(singleton_mutex);
+		if(!singleton)
+			singleton = new tf::Executor(numthreads ? numthreads : hardware_concurrency());
+		return singleton;
+	}
+	/**
+	 * Get executor for blocking I/O, such as stream range reads, so that a
+	 * blocked read never occupies a compute worker
+	 */
+	static tf::Executor* io(void)
+	{
+		std::unique_lock<std::mutex> lock(singleton_mutex);
+		if(!ioSingleton)
+			ioSingleton = new tf::Executor(numIOThreads);
+		return ioSingleton;
+	}
+	static void release(void)
+	{
+		std::unique_lock<std::mutex> lock(singleton_mutex);
+		delete ioSingleton;
+		ioSingleton = nullptr;
+		delete singleton;
+		singleton = nullptr;
+	}
+	static uint32_t numThreads(void)
+	{
+		return (uint32_t)get()->num_workers();
+	}
+	/**
+	 * Get index of calling thread
+	 *
+	 * @return worker id for executor threads, and numThreads() for
+	 * any thread that does not belong to the executor
+	 */
+	static uint32_t threadId(void)
+	{
+		int id = get()->this_worker_id();
+
+		return id >= 0 ? (uint32_t)id : numThreads();
+	}
+	static uint32_t hardware_concurrency(void)
+	{
+		uint32_t ret = 0;
+
+#if _MSC_VER >= 1200 && MSC_VER <= 1910
+		SYSTEM_INFO sysinfo;
+		GetSystemInfo(&sysinfo);
+		ret = sysinfo.dwNumberOfProcessors;
+
+#else
+		ret = std::thread::hardware_concurrency();
+#endif
+		return ret;
+	}
+	/**
+	 * Run a task graph, and return when it has completed.
+	 *
+	 * When called from inside an executor task, the calling worker runs graph
+	 * tasks while it waits instead of blocking, so that a whole codec may itself
+	 * run as an executor task.
+	 *
+	 * @param flow task graph
+	 */
+	static void run(tf::Taskflow& flow)
+	{
+		if(get()->this_worker_id() >= 0)
+			get()->corun(flow);
+		else
+			get()->run(flow).wait();
+	}
+	/**
+	 * Run numJobs independent jobs in parallel, and return when all have completed.
+	 *
+	 * The calling thread claims and runs jobs alongside the helper tasks that are
+	 * submitted to the executor, and only ever waits on jobs that another thread is
+	 * already running. It is therefore safe to call from inside an executor task,
+	 * at any nesting depth.
+	 *
+	 * @param numJobs number of jobs
+	 * @param job callable taking the job index in [0, numJobs)
+	 */
+	template<typename F>
+	static void forkJoin(uint32_t numJobs, F&& job)
+	{
+		if(numJobs == 0)
+			return;
+		uint32_t numHelpers = (std::min<uint32_t>)(numJobs, numThreads()) - 1;
+		if(numHelpers == 0)
+		{
+			for(uint32_t i = 0; i < numJobs; ++i)
+				job(i);
+			return;
+		}
+		auto state = std::make_shared<ForkJoinState>(
+			numJobs, std::function<void(uint32_t)>([&job](uint32_t i) { job(i); }));
+		for(uint32_t i = 0; i < numHelpers; ++i)
+			get()->silent_async([state] { state->work(); });
+		state->work();
+		state->wait();
+	}
+
+  private:
+	struct ForkJoinState
+	{
+		ForkJoinState(uint32_t numJobs, std::function<void(uint32_t)> job)
+			: next(0), done(0), numJobs(numJobs), job(job)
+		{}
+		// claim and run jobs until none are left
+		void work(void)
+		{
+			uint32_t index;
+			while((index = next++) < numJobs)
+			{
+				job(index);
+				if(++done == numJobs)
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					cv.notify_all();
+				}
+			}
+		}
+		// wait for jobs claimed by other threads
+		void wait(void)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv.wait(lock, [this] { return done == numJobs; });
+		}
+		std::atomic<uint32_t> next;
+		std::atomic<uint32_t> done;
+		uint32_t numJobs;
+		std::function<void(uint32_t)> job;
+		std::mutex mutex;
+		std::condition_variable cv;
+	};
+	static tf::Executor* singleton;
+	static tf::Executor* ioSingleton;
+	static const uint32_t numIOThreads = 4;
+	static std::mutex singleton_mutex;
+};
+
+} // namespace grk
@@ -232,6 +232,18 @@ bool GrkImage::allocData(void)
  Transfer data to dest for each component, and null out this data.
  Assumption:  this and dest have the same number of components
  */
+uint64_t GrkImage::dataBytes(void) const
+{
+	uint64_t bytes = 0;
+	for(uint16_t compno = 0; compno < numcomps; ++compno)
+	{
+		auto comp = comps + compno;
+		if(comp->data)
+			bytes += (uint64_t)comp->stride * comp->h * sizeof(int32_t);
+	}
+
+	return bytes;
+}
 void GrkImage::transferDataTo(GrkImage* dest)
 {
 	if(!dest || !comps || !dest->comps || numcomps != dest->numcomps)
@@ -8,6 +8,24 @@ struct Tile;
 struct CodingParams;
 struct TileComponent;
 
+/**
+ * Caller-supplied buffer of interleaved, unsigned 8 or 16 bit samples
+ */
+struct InterleavedBuffer
+{
+	InterleavedBuffer() : data(nullptr), stride(0), bitsPerSample(0) {}
+	bool active(void) const
+	{
+		return data != nullptr;
+	}
+	uint8_t* data;
+	// number of bytes between consecutive rows
+	uint64_t stride;
+	uint8_t bitsPerSample;
+	// area covered by buffer, in reduced component coordinates
+	grkRectU32 bounds;
+};
+
 class GrkImageMeta : public grk_image_meta
 {
   public:
@@ -63,6 +81,8 @@ class GrkImage : public grk_image
 	 */
 	void transferDataTo(GrkImage* dest);
 	void transferDataFrom(const Tile* tile_src_data);
+	// number of bytes in component sample buffers
+	uint64_t dataBytes(void) const;
 	GrkImage* duplicate(const Tile* tile_src);
 	/**
 	 * Copy tile to composite image
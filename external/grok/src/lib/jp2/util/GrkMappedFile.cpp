@@ -239,6 +239,75 @@ grk_stream* create_mapped_file_read_stream(const char* fname)
 	return stream;
 }
 
+static size_t read_from_mapped_file(void* buffer, size_t numBytes, MemStream* memStream)
+{
+	size_t nb_read = (std::min)(numBytes, memStream->len - memStream->off);
+	if(nb_read)
+	{
+		memcpy(buffer, memStream->buf + memStream->off, nb_read);
+		memStream->off += nb_read;
+	}
+
+	return nb_read;
+}
+
+static bool seek_in_mapped_file(uint64_t offset, MemStream* memStream)
+{
+	memStream->off = (size_t)(std::min<uint64_t>)(offset, memStream->len);
+
+	return true;
+}
+
+// ranges are independent of the stream offset, so this may be called concurrently
+static bool read_ranges_from_mapped_file(grk_stream_range* ranges, uint32_t numRanges,
+										 MemStream* memStream)
+{
+	for(uint32_t i = 0; i < numRanges; ++i)
+	{
+		auto range = ranges + i;
+		if(range->offset > memStream->len || range->length > memStream->len - range->offset)
+			return false;
+		memcpy(range->buffer, memStream->buf + range->offset, range->length);
+	}
+
+	return true;
+}
+
+grk_stream* create_mapped_file_range_read_stream(const char* fname, size_t buffer_size)
+{
+	grk_handle fd = open_fd(fname, "r");
+	if(fd == (grk_handle)-1)
+	{
+		GRK_ERROR("Unable to open memory mapped file %s", fname);
+		return nullptr;
+	}
+
+	auto memStream = new MemStream();
+	memStream->fd = fd;
+	memStream->len = (size_t)size_proc(fd);
+	auto mapped_view = grk_map(fd, memStream->len, true);
+	if(!mapped_view)
+	{
+		GRK_ERROR("Unable to map memory mapped file %s", fname);
+		mem_map_free(memStream);
+		return nullptr;
+	}
+	memStream->buf = (uint8_t*)mapped_view;
+	memStream->off = 0;
+
+	// unlike a memory stream, reads are buffered, and page faults for
+	// prefetched ranges are taken concurrently on the library's I/O threads
+	auto stream = grk_stream_new(buffer_size, true);
+	grk_stream_set_user_data(stream, memStream, (grk_stream_free_user_data_fn)mem_map_free);
+	grk_stream_set_user_data_length(stream, memStream->len);
+	grk_stream_set_read_function(stream, (grk_stream_read_fn)read_from_mapped_file);
+	grk_stream_set_seek_function(stream, (grk_stream_seek_fn)seek_in_mapped_file);
+	grk_stream_set_read_ranges_function(stream,
+										(grk_stream_read_ranges_fn)read_ranges_from_mapped_file);
+
+	return stream;
+}
+
 grk_stream* create_mapped_file_write_stream(const char* fname)
 {
 	GRK_ERROR("Memory mapped file writing not currently supported");
@@ -3,6 +3,7 @@
 namespace grk
 {
 grk_stream* create_mapped_file_read_stream(const char* fname);
+grk_stream* create_mapped_file_range_read_stream(const char* fname, size_t buffer_size);
 grk_stream* create_mapped_file_write_stream(const char* fname);
 
 } // namespace grk
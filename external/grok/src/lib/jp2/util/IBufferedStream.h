@@ -91,6 +91,29 @@ struct IBufferedStream
 	 * @return	 true if stream is seekable, otherwise false
 	 */
 	virtual bool hasSeek() = 0;
+
+	/**
+	 * Check if stream can read arbitrary byte ranges concurrently
+	 *
+	 * @return	 true if stream has a range read function, otherwise false
+	 */
+	virtual bool supportsRangeRead(void) = 0;
+
+	/**
+	 * Start reading byte ranges ahead of the stream position. Reads and seeks
+	 * that land in these ranges are then served from memory, and ranges that
+	 * were requested earlier are discarded.
+	 *
+	 * @param ranges	byte ranges, in any order
+	 */
+	virtual void prefetch(std::vector<ByteRange>& ranges) = 0;
+
+	/**
+	 * Get counters for time spent in, and bytes transferred by, stream callbacks
+	 *
+	 * @return	I/O counters, shared with any codec using this stream
+	 */
+	virtual std::shared_ptr<StageStats> getIOStats(void) = 0;
 };
 
 } // namespace grk
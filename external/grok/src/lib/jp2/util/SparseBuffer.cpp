@@ -35,6 +35,21 @@ void SparseBuffer::increment()
 		currentChunkId++;
 	}
 }
+size_t SparseBuffer::getLength(void)
+{
+	return dataLength;
+}
+size_t SparseBuffer::getOwnedLength(void)
+{
+	size_t len = 0;
+	for(auto chunk : chunks)
+	{
+		if(chunk->owns_data)
+			len += chunk->len;
+	}
+
+	return len;
+}
 size_t SparseBuffer::read(void* buffer, size_t numBytes)
 {
 	if(buffer == nullptr || numBytes == 0)
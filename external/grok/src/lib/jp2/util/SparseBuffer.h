@@ -38,6 +38,10 @@ struct SparseBuffer
 	size_t skip(size_t numBytes);
 	void increment(void);
 	size_t read(void* buffer, size_t numBytes);
+	// total length of all chunks
+	size_t getLength(void);
+	// total length of chunks that own their data
+	size_t getOwnedLength(void);
 
   private:
 	// Treat segmented buffer as single contiguous buffer, and get current offset
@@ -0,0 +1,225 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_includes.h"
+
+namespace grk
+{
+StreamPrefetcher::Batch::Batch(void)
+	: numUnconsumed(0), issued(false), claimed(false), done(false), success(false)
+{}
+StreamPrefetcher::Batch::~Batch(void)
+{
+	for(auto& r : ranges)
+		delete[] r.buffer;
+}
+void StreamPrefetcher::Batch::run(grk_stream_read_ranges_fn readRanges, void* userData,
+								  StageStats* ioStats)
+{
+	if(claimed.exchange(true))
+		return;
+	bool rc;
+	{
+		StageTimer timer(ioStats);
+		rc = readRanges(ranges.data(), (uint32_t)ranges.size(), userData);
+		if(rc)
+		{
+			for(auto& r : ranges)
+				timer.addBytes(r.length);
+		}
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	success = rc;
+	done = true;
+	cv.notify_all();
+}
+bool StreamPrefetcher::Batch::wait(grk_stream_read_ranges_fn readRanges, void* userData,
+								   StageStats* ioStats)
+{
+	run(readRanges, userData, ioStats);
+	std::unique_lock<std::mutex> lock(mutex);
+	cv.wait(lock, [this] { return done; });
+
+	return success;
+}
+bool StreamPrefetcher::Batch::isDone(void)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return done;
+}
+StreamPrefetcher::StreamPrefetcher(grk_stream_read_ranges_fn readRanges, void* userData,
+								   std::shared_ptr<StageStats> ioStats)
+	: readRanges_(readRanges), userData_(userData), ioStats_(ioStats), nextBatch_(0),
+	  numInFlight_(0)
+{}
+StreamPrefetcher::~StreamPrefetcher()
+{
+	clear();
+}
+void StreamPrefetcher::clear(void)
+{
+	for(size_t i = 0; i < nextBatch_; ++i)
+	{
+		auto batch = batches_[i].get();
+		// cancel batch if it has not started, otherwise wait for it,
+		// as it is reading into buffers owned by the batch
+		if(!batch->claimed.exchange(true))
+			continue;
+		std::unique_lock<std::mutex> lock(batch->mutex);
+		batch->cv.wait(lock, [batch] { return batch->done; });
+	}
+	segments_.clear();
+	batches_.clear();
+	nextBatch_ = 0;
+	numInFlight_ = 0;
+}
+void StreamPrefetcher::prefetch(std::vector<ByteRange>& ranges)
+{
+	clear();
+	if(ranges.empty())
+		return;
+	std::sort(ranges.begin(), ranges.end(), [](const ByteRange& a, const ByteRange& b) {
+		return a.offset < b.offset;
+	});
+	// coalesce
+	std::vector<ByteRange> coalesced;
+	for(auto& r : ranges)
+	{
+		if(!r.length)
+			continue;
+		if(!coalesced.empty())
+		{
+			auto& last = coalesced.back();
+			uint64_t lastEnd = last.offset + last.length;
+			uint64_t end = (std::max)(lastEnd, r.offset + r.length);
+			// large ranges are left separate, so that batches stay small enough
+			// for decompression to start before the whole window has been read
+			if(r.offset <= lastEnd + maxCoalesceGap && end - last.offset <= maxBatchBytes)
+			{
+				last.length = end - last.offset;
+				continue;
+			}
+		}
+		coalesced.push_back(r);
+	}
+	// group into batches
+	std::shared_ptr<Batch> batch;
+	uint64_t batchBytes = 0;
+	for(auto& r : coalesced)
+	{
+		if(!batch || batch->ranges.size() == maxBatchRanges ||
+		   batchBytes + r.length > maxBatchBytes)
+		{
+			batch = std::make_shared<Batch>();
+			batches_.push_back(batch);
+			batchBytes = 0;
+		}
+		batch->ranges.push_back({r.offset, (size_t)r.length, new uint8_t[(size_t)r.length]});
+		batchBytes += r.length;
+	}
+	// ranges vectors are now fixed, so segments can point into them
+	for(auto& b : batches_)
+	{
+		b->numUnconsumed = (uint32_t)b->ranges.size();
+		for(auto& r : b->ranges)
+			segments_[r.offset + r.length] = {&r, b.get()};
+	}
+	issue();
+}
+void StreamPrefetcher::issue(void)
+{
+	while(nextBatch_ < batches_.size() && numInFlight_ < maxBatchesInFlight)
+	{
+		auto batch = batches_[nextBatch_++];
+		// skip batches that the reader has already read, or skipped past
+		if(batch->claimed)
+			continue;
+		batch->issued = true;
+		numInFlight_++;
+		// a queued batch may outlive the prefetcher, but once cleared
+		// it is claimed, and run returns without reading
+		auto readRanges = readRanges_;
+		auto userData = userData_;
+		auto ioStats = ioStats_;
+		ExecSingleton::io()->silent_async([batch, readRanges, userData, ioStats] {
+			batch->run(readRanges, userData, ioStats.get());
+		});
+	}
+}
+void StreamPrefetcher::release(std::map<uint64_t, Segment>::iterator segment)
+{
+	auto range = segment->second.range;
+	auto batch = segment->second.batch;
+	segments_.erase(segment);
+	if(--batch->numUnconsumed)
+	{
+		// an I/O thread may still be reading into the buffer
+		if(batch->isDone())
+		{
+			delete[] range->buffer;
+			range->buffer = nullptr;
+		}
+		return;
+	}
+	// cancel batch if it has not started, otherwise wait for it
+	if(!batch->claimed.exchange(true))
+	{
+		std::lock_guard<std::mutex> lock(batch->mutex);
+		batch->done = true;
+	}
+	else
+	{
+		std::unique_lock<std::mutex> lock(batch->mutex);
+		batch->cv.wait(lock, [batch] { return batch->done; });
+	}
+	for(auto& r : batch->ranges)
+	{
+		delete[] r.buffer;
+		r.buffer = nullptr;
+	}
+	if(batch->issued)
+	{
+		numInFlight_--;
+		issue();
+	}
+}
+size_t StreamPrefetcher::read(uint64_t offset, uint8_t* buffer, size_t len)
+{
+	// release segments that the reader has skipped past
+	while(!segments_.empty() && segments_.begin()->first <= offset)
+		release(segments_.begin());
+	auto segment = segments_.upper_bound(offset);
+	if(segment == segments_.end() || segment->second.range->offset > offset)
+		return 0;
+	auto range = segment->second.range;
+	if(!segment->second.batch->wait(readRanges_, userData_, ioStats_.get()))
+	{
+		GRK_WARN("Stream prefetch: failed to read %llu bytes at offset %llu",
+				 (unsigned long long)range->length, (unsigned long long)range->offset);
+		release(segment);
+		return 0;
+	}
+	uint64_t end = range->offset + range->length;
+	size_t numBytes = (size_t)(std::min<uint64_t>)(len, end - offset);
+	memcpy(buffer, range->buffer + (offset - range->offset), numBytes);
+	if(offset + numBytes == end)
+		release(segment);
+
+	return numBytes;
+}
+
+} // namespace grk
@@ -0,0 +1,123 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+namespace grk
+{
+/**
+ * Byte range of a stream
+ */
+struct ByteRange
+{
+	ByteRange(uint64_t off, uint64_t len) : offset(off), length(len) {}
+	uint64_t offset;
+	uint64_t length;
+};
+
+/**
+ * Reads a set of byte ranges ahead of a sequential reader, through a stream's
+ * range read function.
+ *
+ * Ranges are sorted and coalesced, then grouped into batches, each of which is
+ * a single call to the range read function. Batches are read on the library's
+ * shared I/O executor, so that a blocking range read never occupies a compute worker.
+ * A bounded number of batches is in flight: a batch is issued once an earlier batch
+ * has been consumed. A reader that needs a batch which has not started yet reads it
+ * itself, rather than waiting for an I/O thread to become free.
+ */
+class StreamPrefetcher
+{
+  public:
+	StreamPrefetcher(grk_stream_read_ranges_fn readRanges, void* userData,
+					 std::shared_ptr<StageStats> ioStats);
+	~StreamPrefetcher();
+	/**
+	 * Discard any earlier ranges, and start reading new ones
+	 *
+	 * @param ranges byte ranges, in any order, possibly overlapping
+	 */
+	void prefetch(std::vector<ByteRange>& ranges);
+	/**
+	 * Copy prefetched bytes, waiting for them if necessary.
+	 * Bytes are released once they have been copied up to the end of their range,
+	 * or once the reader has moved past them.
+	 *
+	 * @param offset stream offset
+	 * @param buffer destination buffer
+	 * @param len maximum number of bytes to copy
+	 *
+	 * @return number of bytes copied, which is zero if offset has not been prefetched,
+	 * or if the range read failed
+	 */
+	size_t read(uint64_t offset, uint8_t* buffer, size_t len);
+	/**
+	 * Wait for batches in flight, and release all prefetched bytes
+	 */
+	void clear(void);
+
+	// ranges separated by at most this many bytes are read as one
+	static const uint64_t maxCoalesceGap = 64 * 1024;
+	// maximum number of ranges and bytes in a single range read call
+	static const uint32_t maxBatchRanges = 16;
+	static const uint64_t maxBatchBytes = 4 * 1024 * 1024;
+	// maximum number of batches that are read but not yet consumed
+	static const uint32_t maxBatchesInFlight = 4;
+
+  private:
+	struct Batch
+	{
+		Batch(void);
+		~Batch(void);
+		// read batch, unless another thread has already claimed it
+		void run(grk_stream_read_ranges_fn readRanges, void* userData, StageStats* ioStats);
+		// wait for batch to be read, reading it on this thread if it has not started
+		bool wait(grk_stream_read_ranges_fn readRanges, void* userData, StageStats* ioStats);
+		bool isDone(void);
+		std::vector<grk_stream_range> ranges;
+		uint32_t numUnconsumed;
+		// batch was handed to the I/O executor, and counts as in flight until consumed
+		bool issued;
+		std::atomic<bool> claimed;
+		bool done;
+		bool success;
+		std::mutex mutex;
+		std::condition_variable cv;
+	};
+	struct Segment
+	{
+		grk_stream_range* range;
+		Batch* batch;
+	};
+	void issue(void);
+	void release(std::map<uint64_t, Segment>::iterator segment);
+
+	grk_stream_read_ranges_fn readRanges_;
+	void* userData_;
+	std::shared_ptr<StageStats> ioStats_;
+	// segments keyed by end offset
+	std::map<uint64_t, Segment> segments_;
+	std::vector<std::shared_ptr<Batch>> batches_;
+	// index of first batch that has not been issued
+	size_t nextBatch_;
+	uint32_t numInFlight_;
+};
+
+} // namespace grk
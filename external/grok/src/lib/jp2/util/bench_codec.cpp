@@ -0,0 +1,399 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "grk_includes.h"
+#include "spdlog/spdlog.h"
+#include "SyntheticImage.h"
+
+#include <chrono> // for high_resolution_clock
+#define TCLAP_NAMESTARTSTRING "-"
+#include "tclap/CmdLine.h"
+using namespace TCLAP;
+
+using namespace grk;
+
+namespace grk
+{
+const uint16_t benchNumComps = 3;
+const uint8_t benchPrecision = 8;
+
+/**
+ * Stand-alone tile with whole-tile component buffers, filled with synthetic
+ * 8 bit samples
+ */
+struct BenchTile
+{
+	BenchTile(uint32_t numresolutions, bool lossy) : image(nullptr)
+	{
+		for(uint16_t compno = 0; compno < benchNumComps; ++compno)
+		{
+			auto tccp = tccps + compno;
+			tccp->numresolutions = (uint8_t)numresolutions;
+			tccp->qmfbid = lossy ? 0 : 1;
+			tccp->cblkw = 6;
+			tccp->cblkh = 6;
+			tccp->m_dc_level_shift = 1 << (benchPrecision - 1);
+			for(uint32_t i = 0; i < GRK_J2K_MAXRLVLS; ++i)
+			{
+				tccp->precinctWidthExp[i] = 15;
+				tccp->precinctHeightExp[i] = 15;
+			}
+		}
+	}
+	~BenchTile()
+	{
+		if(image)
+			grk_object_unref(&image->obj);
+	}
+	bool init(grkRectU32 bounds)
+	{
+		grk_image_cmptparm params[benchNumComps];
+		memset(params, 0, sizeof(params));
+		for(uint16_t compno = 0; compno < benchNumComps; ++compno)
+		{
+			auto param = params + compno;
+			param->dx = 1;
+			param->dy = 1;
+			param->w = bounds.width();
+			param->h = bounds.height();
+			param->prec = benchPrecision;
+		}
+		image = GrkImage::create(benchNumComps, params, GRK_CLRSPC_SRGB, false);
+		if(!image)
+			return false;
+		tile.numcomps = benchNumComps;
+		tile.comps = new TileComponent[benchNumComps];
+		for(uint16_t compno = 0; compno < benchNumComps; ++compno)
+		{
+			auto tilec = tile.comps + compno;
+			if(!tilec->init(true, true, bounds, benchPrecision, &cp, tccps + compno, nullptr) ||
+			   !tilec->allocWindowBuffer(bounds, nullptr) || !tilec->getBuffer()->alloc())
+				return false;
+		}
+		reset();
+
+		return true;
+	}
+	/** Fill buffers with synthetic samples */
+	void reset(void)
+	{
+		for(uint16_t compno = 0; compno < benchNumComps; ++compno)
+		{
+			auto tilec = tile.comps + compno;
+			auto win = tilec->getBuffer()->getHighestBufferResWindowREL();
+			SyntheticImage source(benchNumComps, tilec->width(), tilec->height(), 0, false);
+			for(uint32_t j = 0; j < tilec->height(); ++j)
+			{
+				auto row = win->getBuffer() + (size_t)j * win->stride;
+				for(uint32_t i = 0; i < tilec->width(); ++i)
+					row[i] = source.getSample(i, j, compno);
+			}
+		}
+	}
+	bool dwtForward(void)
+	{
+		for(uint16_t compno = 0; compno < benchNumComps; ++compno)
+		{
+			WaveletFwdImpl w;
+			if(!w.compress(tile.comps + compno, tccps[compno].qmfbid))
+				return false;
+		}
+		return true;
+	}
+	bool dwtInverse(void)
+	{
+		for(uint16_t compno = 0; compno < benchNumComps; ++compno)
+		{
+			auto tilec = tile.comps + compno;
+			WaveletReverse w;
+			for(uint8_t resno = 1; resno < tilec->numresolutions; ++resno)
+			{
+				if(!w.decompressResolution(tilec, resno, tccps[compno].qmfbid))
+					return false;
+			}
+		}
+		return true;
+	}
+	bool mctForward(void)
+	{
+		if(tccps->qmfbid == 1)
+			mct::compress_rev(&tile, image, tccps);
+		else
+			mct::compress_irrev(&tile, image, tccps);
+		return true;
+	}
+	bool mctInverse(void)
+	{
+		if(tccps->qmfbid == 1)
+			mct::decompress_rev(&tile, image, tccps);
+		else
+			mct::decompress_irrev(&tile, image, tccps);
+		return true;
+	}
+	uint64_t numSamples(void)
+	{
+		return tile.comps->getBuffer()->stridedArea() * benchNumComps;
+	}
+
+	CodingParams cp;
+	TileComponentCodingParams tccps[benchNumComps];
+	Tile tile;
+	GrkImage* image;
+};
+
+/**
+ * Synthetic image that is compressed to, and decompressed from, memory.
+ * Block coders are driven through the codec, as they depend on the
+ * tile, precinct and code block structures the codec sets up;
+ * their cost is read back from the codec's stage profile.
+ */
+struct BenchCodec
+{
+	BenchCodec(uint32_t size, uint32_t numresolutions, bool lossy, bool ht)
+		: size(size), numresolutions(numresolutions), lossy(lossy), ht(ht), compressedLength(0)
+	{}
+	bool compress(grk_codec_stats* stats)
+	{
+		grk_cparameters parameters;
+		grk_compress_set_default_params(&parameters);
+		parameters.numresolution = (uint8_t)numresolutions;
+		parameters.irreversible = lossy;
+		if(ht)
+		{
+			parameters.cblk_sty = GRK_CBLKSTY_HT;
+			parameters.isHT = true;
+			parameters.numgbits = 1;
+		}
+		compressed.resize((size_t)size * size * benchNumComps * 2 + 1024 * 1024);
+		auto stream = grk_stream_create_mem_stream(compressed.data(), compressed.size(), false,
+												   false);
+		if(!stream)
+			return false;
+		SyntheticImage source(benchNumComps, size, size, 0, false);
+		bool rc = source.compress(&parameters, GRK_CODEC_J2K, stream, stats);
+		if(rc)
+			compressedLength = grk_stream_get_write_mem_stream_length(stream);
+		grk_object_unref(stream);
+
+		return rc;
+	}
+	bool decompress(grk_codec_stats* stats)
+	{
+		grk_dparameters parameters;
+		grk_decompress_set_default_params(&parameters);
+		auto stream =
+			grk_stream_create_mem_stream(compressed.data(), compressedLength, false, true);
+		auto codec = stream ? grk_decompress_create(GRK_CODEC_J2K, stream) : nullptr;
+		bool rc = codec && grk_decompress_init(codec, &parameters) &&
+				  grk_decompress_read_header(codec, nullptr) && grk_decompress(codec, nullptr) &&
+				  grk_codec_get_stats(codec, stats);
+		grk_object_unref(codec);
+		grk_object_unref(stream);
+
+		return rc;
+	}
+
+	uint32_t size;
+	uint32_t numresolutions;
+	bool lossy;
+	bool ht;
+	std::vector<uint8_t> compressed;
+	size_t compressedLength;
+};
+
+void report(const char* kernel, std::chrono::duration<double> elapsed, uint32_t repetitions,
+			uint64_t numSamples)
+{
+	double ms = elapsed.count() * 1000 / repetitions;
+	spdlog::info("{:<12} {:10.3f} ms {:10.1f} MSamples/s", kernel, ms,
+				 ms > 0 ? (double)numSamples / (ms * 1000) : 0);
+}
+
+void report(const char* kernel, const grk_stage_stats* stage, uint32_t repetitions)
+{
+	// block coders run concurrently, so stage wall time is summed over all blocks
+	spdlog::info("{:<12} {:10.3f} ms block time {:10.3f} ms CPU {:8} blocks {:12} bytes",
+				 kernel, (double)stage->wallNs / 1e6 / repetitions,
+				 (double)stage->cpuNs / 1e6 / repetitions, stage->count / repetitions,
+				 stage->bytes / repetitions);
+}
+
+void addStats(grk_stage_stats* total, const grk_stage_stats* stage)
+{
+	total->count += stage->count;
+	total->wallNs += stage->wallNs;
+	total->cpuNs += stage->cpuNs;
+	total->bytes += stage->bytes;
+}
+
+void usage(void)
+{
+	printf("bench_codec [-size value] [-num_resolutions val] [-irreversible]\n");
+	printf("[-num_threads val] [-repetitions val] [-kernels dwt,mct,t1,t1_ht]\n");
+}
+
+class GrokOutput : public StdOutput
+{
+  public:
+	virtual void usage(CmdLineInterface& c)
+	{
+		(void)c;
+		::usage();
+	}
+};
+} // namespace grk
+
+int main(int argc, char** argv)
+{
+	uint32_t num_threads = 0;
+	bool lossy = false;
+	uint32_t size = 2048;
+	uint32_t num_resolutions = 6;
+	uint32_t repetitions = 3;
+	std::string kernels = "dwt,mct,t1,t1_ht";
+
+	CmdLine cmd("bench_codec command line", ' ', grk_version());
+
+	// set the output
+	GrokOutput output;
+	cmd.setOutput(&output);
+
+	ValueArg<uint32_t> sizeArg("s", "size", "Size of image", false, 0, "unsigned integer", cmd);
+	ValueArg<uint32_t> numThreadsArg("H", "num_threads", "Number of threads", false, 0,
+									 "unsigned integer", cmd);
+	ValueArg<uint32_t> numResolutionsArg("n", "Resolutions", "Number of resolutions", false, 0,
+										 "unsigned integer", cmd);
+	SwitchArg lossyArg("I", "irreversible", "irreversible transforms", cmd);
+	ValueArg<uint32_t> repetitionsArg("r", "repetitions", "Number of timed repetitions", false, 1,
+									  "unsigned integer", cmd);
+	ValueArg<std::string> kernelsArg("k", "kernels", "Comma separated list of kernels", false, "",
+									 "string", cmd);
+
+	cmd.parse(argc, argv);
+
+	if(lossyArg.isSet())
+		lossy = true;
+	if(sizeArg.isSet())
+		size = std::max<uint32_t>(sizeArg.getValue(), 1);
+	if(numThreadsArg.isSet())
+		num_threads = numThreadsArg.getValue();
+	if(numResolutionsArg.isSet())
+	{
+		num_resolutions = numResolutionsArg.getValue();
+		if(num_resolutions == 0 || num_resolutions > 32)
+		{
+			spdlog::error("Invalid value for num_resolutions. "
+						  "Should be >= 1 and <= 32");
+			return 1;
+		}
+	}
+	if(repetitionsArg.isSet())
+		repetitions = std::max<uint32_t>(repetitionsArg.getValue(), 1);
+	if(kernelsArg.isSet())
+		kernels = kernelsArg.getValue();
+	auto runKernel = [&kernels](const std::string& kernel) {
+		std::string list = "," + kernels + ",";
+		return list.find("," + kernel + ",") != std::string::npos;
+	};
+
+	grk_initialize(nullptr, num_threads);
+	spdlog::info("{} {}x{} image, {} components, {} resolutions, {} threads",
+				 lossy ? "irreversible" : "reversible", size, size, benchNumComps,
+				 num_resolutions, ExecSingleton::numThreads());
+	int rc = 0;
+	if(runKernel("dwt") || runKernel("mct"))
+	{
+		BenchTile tile(num_resolutions, lossy);
+		if(!tile.init(grkRectU32(0, 0, size, size)))
+		{
+			spdlog::error("Failed to initialize tile");
+			rc = 1;
+		}
+		std::chrono::duration<double> fwd[2] = {}, inv[2] = {};
+		for(uint32_t r = 0; r < repetitions && rc == 0; ++r)
+		{
+			// transform the synthetic samples on every repetition
+			tile.reset();
+			for(uint32_t k = 0; k < 2 && rc == 0; ++k)
+			{
+				bool dwt = k == 0;
+				if(!runKernel(dwt ? "dwt" : "mct"))
+					continue;
+				auto start = std::chrono::high_resolution_clock::now();
+				bool success = dwt ? tile.dwtForward() : tile.mctForward();
+				fwd[k] += std::chrono::high_resolution_clock::now() - start;
+				start = std::chrono::high_resolution_clock::now();
+				success = success && (dwt ? tile.dwtInverse() : tile.mctInverse());
+				inv[k] += std::chrono::high_resolution_clock::now() - start;
+				if(!success)
+				{
+					spdlog::error("{} failed", dwt ? "dwt" : "mct");
+					rc = 1;
+				}
+			}
+		}
+		if(rc == 0)
+		{
+			if(runKernel("dwt"))
+			{
+				report("dwt fwd", fwd[0], repetitions, tile.numSamples());
+				report("dwt inv", inv[0], repetitions, tile.numSamples());
+			}
+			if(runKernel("mct"))
+			{
+				report("mct fwd", fwd[1], repetitions, tile.numSamples());
+				report("mct inv", inv[1], repetitions, tile.numSamples());
+			}
+		}
+	}
+	for(uint32_t k = 0; k < 2 && rc == 0; ++k)
+	{
+		bool ht = k == 1;
+		if(!runKernel(ht ? "t1_ht" : "t1"))
+			continue;
+		auto stage = ht ? GRK_STAGE_T1_HT : GRK_STAGE_T1;
+		BenchCodec codec(size, num_resolutions, lossy, ht);
+		grk_stage_stats compressTotal, decompressTotal;
+		memset(&compressTotal, 0, sizeof(compressTotal));
+		memset(&decompressTotal, 0, sizeof(decompressTotal));
+		for(uint32_t r = 0; r < repetitions; ++r)
+		{
+			grk_codec_stats stats;
+			if(!codec.compress(&stats))
+			{
+				spdlog::error("{} compress failed", grk_codec_stage_name(stage));
+				rc = 1;
+				break;
+			}
+			addStats(&compressTotal, stats.stages + stage);
+			if(!codec.decompress(&stats))
+			{
+				spdlog::error("{} decompress failed", grk_codec_stage_name(stage));
+				rc = 1;
+				break;
+			}
+			addStats(&decompressTotal, stats.stages + stage);
+		}
+		if(rc == 0)
+		{
+			report(ht ? "t1_ht enc" : "t1 enc", &compressTotal, repetitions);
+			report(ht ? "t1_ht dec" : "t1 dec", &decompressTotal, repetitions);
+		}
+	}
+	grk_deinitialize();
+
+	return rc;
+}
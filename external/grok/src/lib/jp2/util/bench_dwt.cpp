@@ -48,14 +48,7 @@
  */
 #include "grk_includes.h"
 #include "spdlog/spdlog.h"
-
-#ifdef _WIN32
-#include <windows.h>
-#else
-#include <sys/time.h>
-#include <sys/resource.h>
-#include <sys/times.h>
-#endif /* _WIN32 */
+#include <hwy/targets.h>
 
 #include <chrono> // for high_resolution_clock
 #define TCLAP_NAMESTARTSTRING "-"
@@ -71,52 +64,114 @@ int32_t getValue(uint32_t i)
 	return ((int32_t)i % 511) - 256;
 }
 
-bool init_tilec(TileComponent* tilec, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1,
-				uint32_t numresolutions, GrkImage* outputImage)
+/**
+ * Stand-alone tile component with whole-tile buffer, filled with test values
+ */
+struct BenchTileComponent
 {
-	tilec->numresolutions = numresolutions;
-	tilec->resolutions_to_decompress = numresolutions;
-	tilec->tileCompResolution = new Resolution[tilec->numresolutions];
-	for(auto i = 0; i < tilec->numresolutions; ++i)
-		memset(tilec->tileCompResolution + i, 0, sizeof(Resolution));
-	uint32_t leveno = tilec->numresolutions - 1;
-	auto res = tilec->tileCompResolution;
-
-	/* Adapted from grk_init_tile() */
-	for(uint32_t resno = 0; resno < tilec->numresolutions; ++resno)
+	BenchTileComponent(uint32_t numresolutions, bool lossy)
 	{
-		/* border for each resolution level (global) */
-		res->x0 = ceildivpow2<uint32_t>(x0, leveno);
-		res->y0 = ceildivpow2<uint32_t>(y0, leveno);
-		res->x1 = ceildivpow2<uint32_t>(x1, leveno);
-		res->y1 = ceildivpow2<uint32_t>(y1, leveno);
-		++res;
-		--leveno;
+		tccp.numresolutions = (uint8_t)numresolutions;
+		tccp.qmfbid = lossy ? 0 : 1;
+		tccp.cblkw = 6;
+		tccp.cblkh = 6;
+		for(uint32_t i = 0; i < GRK_J2K_MAXRLVLS; ++i)
+		{
+			tccp.precinctWidthExp[i] = 15;
+			tccp.precinctHeightExp[i] = 15;
+		}
 	}
-	bool isCompressor = (outputImage == nullptr);
-	auto highestNumberOfResolutions =
-		(!isCompressor) ? tilec->resolutions_to_decompress : numresolutions;
-	auto hightestResolution = tilec->tileCompResolution + highestNumberOfResolutions - 1;
-	tilec->set(hightestResolution);
-	grkRectU32 unreduced_tile_comp_window_dims;
-	if(!isCompressor)
+	bool init(grkRectU32 bounds)
 	{
-		unreduced_tile_comp_window_dims = grkRectU32(
-			ceildiv<uint32_t>(outputImage->x0, 1), ceildiv<uint32_t>(outputImage->y0, 1),
-			ceildiv<uint32_t>(outputImage->x1, 1), ceildiv<uint32_t>(outputImage->y1, 1));
+		if(!tilec.init(true, true, bounds, 8, &cp, &tccp, nullptr) ||
+		   !tilec.allocWindowBuffer(bounds, nullptr) || !tilec.getBuffer()->alloc())
+			return false;
+		reset();
+		return true;
 	}
-	tilec->allocWindowBuffer(tilec, unreduced_tile_comp_window_dims);
-	tilec->getBuffer()->alloc();
-	auto data = tilec->getBuffer()->ptr();
-	for(size_t i = 0; i < tilec->getBuffer()->stridedArea(); i++)
-		data[i] = getValue((uint32_t)i);
-	return true;
-}
+	/** Fill buffer with test values */
+	void reset(void)
+	{
+		auto win = tilec.getBuffer()->getHighestBufferResWindowREL();
+		for(uint32_t j = 0; j < tilec.height(); ++j)
+		{
+			auto row = win->getBuffer() + (size_t)j * win->stride;
+			for(uint32_t i = 0; i < tilec.width(); ++i)
+			{
+				int32_t val = getValue(j * tilec.width() + i);
+				if(tccp.qmfbid == 1)
+					row[i] = val;
+				else
+					((float*)row)[i] = (float)val;
+			}
+		}
+	}
+	bool forward(void)
+	{
+		WaveletFwdImpl w;
+		return w.compress(&tilec, tccp.qmfbid);
+	}
+	bool inverse(void)
+	{
+		WaveletReverse w;
+		for(uint8_t resno = 1; resno < tilec.numresolutions; ++resno)
+		{
+			if(!w.decompressResolution(&tilec, resno, tccp.qmfbid))
+				return false;
+		}
+		return true;
+	}
+	/**
+	 * Compare with other tile component, which is assumed to have identical bounds
+	 *
+	 * @return maximum absolute difference
+	 */
+	double compare(BenchTileComponent* other)
+	{
+		double maxDiff = 0;
+		auto win = tilec.getBuffer()->getHighestBufferResWindowREL();
+		auto otherWin = other->tilec.getBuffer()->getHighestBufferResWindowREL();
+		for(uint32_t j = 0; j < tilec.height(); ++j)
+		{
+			auto row = win->getBuffer() + (size_t)j * win->stride;
+			auto otherRow = otherWin->getBuffer() + (size_t)j * otherWin->stride;
+			for(uint32_t i = 0; i < tilec.width(); ++i)
+			{
+				double diff = (tccp.qmfbid == 1)
+								  ? std::abs((double)row[i] - (double)otherRow[i])
+								  : std::abs((double)((float*)row)[i] - (double)((float*)otherRow)[i]);
+				maxDiff = std::max<double>(maxDiff, diff);
+			}
+		}
+		return maxDiff;
+	}
+	void display(const char* title)
+	{
+		spdlog::info(title);
+		auto win = tilec.getBuffer()->getHighestBufferResWindowREL();
+		for(uint32_t j = 0; j < tilec.height(); j++)
+		{
+			auto row = win->getBuffer() + (size_t)j * win->stride;
+			for(uint32_t i = 0; i < tilec.width(); i++)
+			{
+				if(tccp.qmfbid == 1)
+					printf("%d ", row[i]);
+				else
+					printf("%f ", ((float*)row)[i]);
+			}
+			printf("\n");
+		}
+	}
+
+	CodingParams cp;
+	TileComponentCodingParams tccp;
+	TileComponent tilec;
+};
 
 void usage(void)
 {
-	printf("bench_dwt [-size value] [-check] [-display] [-num_resolutions val] [-lossy]\n");
-	printf("[-offset x y] [-num_threads val]\n");
+	printf("bench_dwt [-size value] [-check] [-display] [-num_resolutions val] [-irreversible]\n");
+	printf("[-forward] [-num_threads val] [-ThreadScaling] [-repetitions val]\n");
 }
 
 class GrokOutput : public StdOutput
@@ -133,13 +188,6 @@ class GrokOutput : public StdOutput
 int main(int argc, char** argv)
 {
 	uint32_t num_threads = 0;
-	GrkImage image;
-	GrkImage outputImage;
-	Tile tile;
-	TileComponent tilec;
-	grk_image_comp imageComp;
-	grk_image_comp output_image_comp;
-	int32_t i, j;
 	bool display = false;
 	bool check = false;
 	bool lossy = false;
@@ -148,6 +196,7 @@ int main(int argc, char** argv)
 	uint32_t offset_x = (uint32_t)((size + 1) / 2 - 1);
 	uint32_t offset_y = (uint32_t)((size + 1) / 2 - 1);
 	uint32_t num_resolutions = 6;
+	uint32_t repetitions = 1;
 
 	CmdLine cmd("bench_dwt command line", ' ', grk_version());
 
@@ -164,6 +213,8 @@ int main(int argc, char** argv)
 										 "unsigned integer", cmd);
 	SwitchArg lossyArg("I", "irreversible", "irreversible dwt", cmd);
 	SwitchArg forwardArg("F", "forward", "forward dwt", cmd);
+	ValueArg<uint32_t> repetitionsArg("r", "repetitions", "Number of timed repetitions", false, 1,
+									  "unsigned integer", cmd);
 
 	SwitchArg threadScalingArg("S", "ThreadScaling", "Thread scaling", cmd);
 
@@ -187,7 +238,7 @@ int main(int argc, char** argv)
 	if(numThreadsArg.isSet())
 		num_threads = numThreadsArg.getValue();
 	if(num_threads == 0)
-		num_threads = ThreadPool::hardware_concurrency();
+		num_threads = ExecSingleton::hardware_concurrency();
 	if(numResolutionsArg.isSet())
 	{
 		num_resolutions = numResolutionsArg.getValue();
@@ -200,144 +251,102 @@ int main(int argc, char** argv)
 	}
 	if(forwardArg.isSet())
 		forward = forwardArg.getValue();
+	if(repetitionsArg.isSet())
+		repetitions = std::max<uint32_t>(repetitionsArg.getValue(), 1);
 
-	size_t begin = num_threads;
-	size_t end = num_threads;
+	uint32_t begin = num_threads;
+	uint32_t end = num_threads;
 	if(threadScalingArg.isSet())
 		begin = 1;
 
-	CodeStream codeStream(!forwardArg.isSet(), nullptr);
-	codeStream.m_headerImage = &image;
-
-	for(size_t k = begin; k <= end; ++k)
+	grkRectU32 bounds(offset_x, offset_y, offset_x + size, offset_y + size);
+	int rc = 0;
+	for(uint32_t k = begin; k <= end && rc == 0; ++k)
 	{
-		memset(&image, 0, sizeof(image));
-		image.numcomps = 1;
-		image.x0 = offset_x;
-		image.y0 = offset_y;
-		image.x1 = offset_x + size;
-		image.y1 = offset_y + size;
-		image.comps = &imageComp;
-		memset(&imageComp, 0, sizeof(imageComp));
-		imageComp.dx = 1;
-		imageComp.dy = 1;
-		imageComp.w = size;
-		imageComp.stride = size;
-		imageComp.h = size;
-
-		memset(&outputImage, 0, sizeof(outputImage));
-		outputImage.numcomps = 1;
-		outputImage.x0 = offset_x;
-		outputImage.y0 = offset_y;
-		outputImage.x1 = offset_x + size;
-		outputImage.y1 = offset_y + size;
-		outputImage.comps = &output_image_comp;
-		memset(&output_image_comp, 0, sizeof(output_image_comp));
-		output_image_comp.dx = 1;
-		output_image_comp.dy = 1;
-		output_image_comp.w = size;
-		output_image_comp.stride = size;
-		output_image_comp.h = size;
-
-		std::unique_ptr<TileProcessor> tileProcessor(new TileProcessor(&codeStream, nullptr));
 		grk_initialize(nullptr, k);
-		init_tilec(&tilec, offset_x, offset_y, offset_x + size, offset_y + size, num_resolutions,
-				   &image);
-		auto data = tilec.getBuffer()->ptr();
-
-		if(display)
+		BenchTileComponent tile(num_resolutions, lossy);
+		if(!tile.init(bounds))
 		{
-			spdlog::info("Before");
-			k = 0;
-			for(j = 0; j < (int32_t)(tilec.height()); j++)
-			{
-				for(i = 0; i < (int32_t)(tilec.width()); i++)
-				{
-					printf("%u ", data[k]);
-					k++;
-				}
-				printf("\n");
-			}
+			spdlog::error("Failed to initialize tile component");
+			return 1;
 		}
-		memset(&tile, 0, sizeof(tile));
-		tile.x0 = tilec.x0;
-		tile.y0 = tilec.y0;
-		tile.x1 = tilec.x1;
-		tile.y1 = tilec.y1;
-		tile.numcomps = 1;
-		tile.comps = &tilec;
-
-		std::chrono::time_point<std::chrono::high_resolution_clock> start, finish;
-		std::chrono::duration<double> elapsed;
+		if(display)
+			tile.display("Before");
 
-		start = std::chrono::high_resolution_clock::now();
-		bool rc = false;
-		if(forward)
+		std::chrono::duration<double> elapsed(0);
+		bool success = true;
+		for(uint32_t r = 0; r < repetitions && success; ++r)
 		{
-			WaveletFwdImpl w;
-			rc = w.compress(&tilec, lossy ? 0 : 1);
+			// transform the test values on every repetition
+			if(r > 0)
+				tile.reset();
+			auto start = std::chrono::high_resolution_clock::now();
+			success = forward ? tile.forward() : tile.inverse();
+			elapsed += std::chrono::high_resolution_clock::now() - start;
 		}
-		else
+		if(!success)
 		{
-			WaveletReverse w;
-			rc = w.decompress(tileProcessor.get(), &tilec, tilec.getBuffer()->unreducedBounds(),
-							  tilec.numresolutions, lossy ? 0 : 1);
+			spdlog::error("dwt failed");
+			rc = 1;
+			break;
 		}
-		assert(rc);
-		finish = std::chrono::high_resolution_clock::now();
-		elapsed = finish - start;
-		spdlog::info("{} dwt {} with {:02d} threads: {} ms", lossy ? "lossy" : "lossless",
-					 forward ? "compress" : "decompress", k, (uint32_t)(elapsed.count() * 1000));
+		spdlog::info("{} dwt {} with {:02d} threads: {:.3f} ms", lossy ? "lossy" : "lossless",
+					 forward ? "compress" : "decompress", k,
+					 elapsed.count() * 1000 / repetitions);
+		if(display)
+			tile.display(forward ? "After FDWT" : "After IDWT");
 
-		if(display || check)
+		if(check && forward)
 		{
-			if(display)
+			// cross-check against the scalar implementation of the same transform
+			BenchTileComponent ref(num_resolutions, lossy);
+			hwy::DisableTargets(uint32_t(~HWY_SCALAR));
+			bool refRc = ref.init(bounds) && ref.forward();
+			hwy::DisableTargets(0);
+			if(!refRc)
 			{
-				spdlog::info("After IDWT\n");
-				k = 0;
-				for(j = 0; j < (int32_t)(tilec.height()); j++)
-				{
-					for(i = 0; i < (int32_t)(tilec.width()); i++)
-					{
-						printf("%u ", data[k]);
-						k++;
-					}
-					printf("\n");
-				}
+				spdlog::error("scalar dwt failed");
+				rc = 1;
+				break;
 			}
-			WaveletFwdImpl w;
-			w.compress(&tilec, 1);
-			if(display)
+			double maxDiff = tile.compare(&ref);
+			// 9/7 lifting may be fused into multiply-add on wider targets
+			double tolerance = lossy ? 1e-2 : 0;
+			if(maxDiff > tolerance)
 			{
-				spdlog::info("After FDWT\n");
-				k = 0;
-				for(j = 0; j < (int32_t)(tilec.height()); j++)
-				{
-					for(i = 0; i < (int32_t)(tilec.width()); i++)
-					{
-						printf("%u ", data[k]);
-						k++;
-					}
-					printf("\n");
-				}
+				spdlog::error("Forward dwt differs from scalar dwt: maximum difference {}",
+							  maxDiff);
+				rc = 1;
+				break;
 			}
-			if(check)
+			spdlog::info("Forward dwt matches scalar dwt: maximum difference {}", maxDiff);
+			// lossless forward transform must be inverted exactly
+			if(!lossy)
 			{
-				size_t idx;
-				size_t nValues = (size_t)tilec.area();
-				for(idx = 0; idx < nValues; idx++)
+				ref.reset();
+				if(!tile.inverse() || tile.compare(&ref) != 0)
 				{
-					if(data[idx] != getValue((uint32_t)idx))
-					{
-						printf("Difference found at idx = %u\n", (uint32_t)idx);
-						return 1;
-					}
+					spdlog::error("Inverse dwt does not reconstruct forward dwt input");
+					rc = 1;
+					break;
 				}
 			}
 		}
+		else if(check && !lossy)
+		{
+			tile.forward();
+			if(display)
+				tile.display("After FDWT");
+			BenchTileComponent ref(num_resolutions, lossy);
+			if(!ref.init(bounds) || tile.compare(&ref) != 0)
+			{
+				spdlog::error("Forward dwt does not reconstruct inverse dwt input");
+				rc = 1;
+				break;
+			}
+		}
 		grk_deinitialize();
 	}
 
-	codeStream.m_headerImage = nullptr;
-	return 0;
+	return rc;
 }
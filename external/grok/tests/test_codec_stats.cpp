@@ -0,0 +1,139 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_config.h"
+#include "common.h"
+#include "SyntheticImage.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+const uint16_t numComps = 3;
+const uint32_t imageSize = 300;
+
+/**
+ * Check that every expected stage was invoked and processed some bytes,
+ * and that no other stage was invoked
+ */
+static bool check(const char* op, grk_codec_stats* stats, const GRK_STAGE* expected,
+				  size_t numExpected)
+{
+	bool rc = true;
+	for(uint32_t i = 0; i < GRK_NUM_STAGES; ++i)
+	{
+		auto stage = (GRK_STAGE)i;
+		auto stageStats = stats->stages + i;
+		bool isExpected =
+			std::find(expected, expected + numExpected, stage) != expected + numExpected;
+		if(isExpected && (!stageStats->count || !stageStats->bytes))
+		{
+			spdlog::error("stats: {} stage {} has count {} and {} bytes", op,
+						  grk_codec_stage_name(stage), stageStats->count, stageStats->bytes);
+			rc = false;
+		}
+		else if(!isExpected && stageStats->count)
+		{
+			spdlog::error("stats: {} stage {} is unexpectedly invoked {} times", op,
+						  grk_codec_stage_name(stage), stageStats->count);
+			rc = false;
+		}
+		else if(stageStats->count && stageStats->wallNs == 0)
+		{
+			spdlog::error("stats: {} stage {} has zero wall time", op,
+						  grk_codec_stage_name(stage));
+			rc = false;
+		}
+	}
+
+	return rc;
+}
+
+static bool compress(grk_cparameters* parameters, const char* file, grk_codec_stats* stats)
+{
+	grk::SyntheticImage source(numComps, imageSize, imageSize, 0, false);
+
+	return source.compress(parameters, file, stats);
+}
+
+static bool decompress(const char* file, grk_codec_stats* stats)
+{
+	grk_dparameters parameters;
+	grk_decompress_set_default_params(&parameters);
+	auto stream = grk_stream_create_file_stream(file, 1024 * 1024, true);
+	if(!stream)
+		return false;
+	auto codec = grk_decompress_create(GRK_CODEC_J2K, stream);
+	bool rc = codec && grk_decompress_init(codec, &parameters) &&
+			  grk_decompress_read_header(codec, nullptr) && grk_decompress(codec, nullptr);
+	// stream is released first: the codec's I/O counters must survive it
+	grk_object_unref(stream);
+	rc = rc && grk_codec_get_stats(codec, stats);
+	grk_object_unref(codec);
+
+	return rc;
+}
+
+int32_t main(int argc, char** argv)
+{
+	/* should be test_codec_stats <ht> <output file> */
+	if(argc != 3)
+	{
+		spdlog::error("Usage: {} <ht> <output file>", argv[0]);
+		return EXIT_FAILURE;
+	}
+	bool ht = atoi(argv[1]) != 0;
+	const char* file = argv[2];
+
+	grk_initialize(nullptr, 0);
+	grk_set_info_handler(grk::infoCallback, nullptr);
+	grk_set_warning_handler(grk::warningCallback, nullptr);
+	grk_set_error_handler(grk::errorCallback, nullptr);
+	grk_cparameters parameters;
+	grk_compress_set_default_params(&parameters);
+	parameters.tile_size_on = true;
+	parameters.t_width = 128;
+	parameters.t_height = 128;
+	parameters.numresolution = 3;
+	if(ht)
+	{
+		parameters.cblk_sty = GRK_CBLKSTY_HT;
+		parameters.isHT = true;
+		parameters.numgbits = 1;
+	}
+	auto t1 = ht ? GRK_STAGE_T1_HT : GRK_STAGE_T1;
+
+	int32_t rc = EXIT_FAILURE;
+	grk_codec_stats compressStats, decompressStats;
+	const GRK_STAGE compressStages[] = {GRK_STAGE_MARKERS, GRK_STAGE_T2,  t1,
+										GRK_STAGE_DWT,     GRK_STAGE_MCT, GRK_STAGE_IO,
+										GRK_STAGE_RATE_CONTROL};
+	const GRK_STAGE decompressStages[] = {GRK_STAGE_MARKERS, GRK_STAGE_T2,  t1,
+										  GRK_STAGE_DWT,     GRK_STAGE_MCT, GRK_STAGE_IO,
+										  GRK_STAGE_COMPOSITE};
+	if(!compress(&parameters, file, &compressStats))
+		spdlog::error("stats: failed to compress {}", file);
+	else if(!decompress(file, &decompressStats))
+		spdlog::error("stats: failed to decompress {}", file);
+	else if(check("compress", &compressStats, compressStages,
+				  sizeof(compressStages) / sizeof(GRK_STAGE)) &&
+			check("decompress", &decompressStats, decompressStages,
+				  sizeof(decompressStages) / sizeof(GRK_STAGE)))
+		rc = EXIT_SUCCESS;
+	grk_deinitialize();
+
+	return rc;
+}
@@ -0,0 +1,245 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_config.h"
+#include "common.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+const uint16_t maxNumComps = 4;
+
+struct Source
+{
+	uint16_t numcomps;
+	uint32_t width;
+	uint32_t height;
+	std::vector<int32_t> comps[maxNumComps];
+};
+
+static void generate(Source* src)
+{
+	for(uint16_t compno = 0; compno < src->numcomps; ++compno)
+	{
+		auto& comp = src->comps[compno];
+		comp.resize((uint64_t)src->width * src->height);
+		for(uint32_t j = 0; j < src->height; ++j)
+		{
+			for(uint32_t i = 0; i < src->width; ++i)
+				comp[(uint64_t)j * src->width + i] =
+					(int32_t)((i * (3 + compno) + j * 5 + ((i * j) >> 4)) & 0xFF);
+		}
+	}
+}
+
+static grk_image* create_image(const Source* src, bool allocData)
+{
+	grk_image_cmptparm params[maxNumComps];
+	memset(params, 0, sizeof(params));
+	for(uint16_t compno = 0; compno < src->numcomps; ++compno)
+	{
+		auto param = params + compno;
+		param->dx = 1;
+		param->dy = 1;
+		param->w = src->width;
+		param->h = src->height;
+		param->prec = 8;
+		param->sgnd = false;
+	}
+	auto image = grk_image_new(src->numcomps, params,
+							   src->numcomps >= 3 ? GRK_CLRSPC_SRGB : GRK_CLRSPC_GRAY, allocData);
+	if(!image)
+		return nullptr;
+	image->x1 = src->width;
+	image->y1 = src->height;
+
+	return image;
+}
+
+/**
+ * Compress source image either in one call, or by pushing strips of stripHeight rows
+ */
+static bool compress(const Source* src, grk_cparameters* parameters, const char* file,
+					 uint32_t stripHeight)
+{
+	bool rc = false;
+	grk_codec* codec = nullptr;
+	grk_image* image = nullptr;
+	auto stream = grk_stream_create_file_stream(file, 1024 * 1024, false);
+	if(!stream)
+	{
+		spdlog::error("strips: failed to create a stream from file {}", file);
+		return false;
+	}
+	codec = grk_compress_create(GRK_CODEC_J2K, stream);
+	image = create_image(src, stripHeight == 0);
+	if(!codec || !image)
+		goto cleanup;
+	if(!stripHeight)
+	{
+		for(uint16_t compno = 0; compno < src->numcomps; ++compno)
+		{
+			auto comp = image->comps + compno;
+			for(uint32_t j = 0; j < src->height; ++j)
+				memcpy(comp->data + (uint64_t)j * comp->stride,
+					   src->comps[compno].data() + (uint64_t)j * src->width,
+					   src->width * sizeof(int32_t));
+		}
+	}
+	if(!grk_compress_init(codec, parameters, image) || !grk_compress_start(codec))
+		goto cleanup;
+	if(!stripHeight)
+	{
+		if(!grk_compress(codec))
+			goto cleanup;
+	}
+	else
+	{
+		const int32_t* data[maxNumComps];
+		uint32_t stride[maxNumComps];
+		for(uint32_t y = 0; y < src->height; y += stripHeight)
+		{
+			uint32_t numRows = std::min<uint32_t>(stripHeight, src->height - y);
+			for(uint16_t compno = 0; compno < src->numcomps; ++compno)
+			{
+				data[compno] = src->comps[compno].data() + (uint64_t)y * src->width;
+				stride[compno] = src->width;
+			}
+			if(!grk_compress_push_rows(codec, data, stride, numRows))
+			{
+				spdlog::error("strips: failed to push rows {} to {}", y, y + numRows);
+				goto cleanup;
+			}
+		}
+	}
+	rc = grk_compress_end(codec);
+cleanup:
+	grk_object_unref(codec);
+	grk_object_unref(stream);
+	if(image)
+		grk_object_unref(&image->obj);
+
+	return rc;
+}
+
+static bool verify(const Source* src, const char* file)
+{
+	bool rc = false;
+	grk_dparameters parameters;
+	grk_decompress_set_default_params(&parameters);
+	grk_image* image = nullptr;
+	auto stream = grk_stream_create_file_stream(file, 1024 * 1024, true);
+	if(!stream)
+		return false;
+	auto codec = grk_decompress_create(GRK_CODEC_J2K, stream);
+	if(!codec || !grk_decompress_init(codec, &parameters) ||
+	   !grk_decompress_read_header(codec, nullptr) || !grk_decompress(codec, nullptr))
+	{
+		spdlog::error("strips: failed to decompress {}", file);
+		goto cleanup;
+	}
+	image = grk_decompress_get_composited_image(codec);
+	for(uint16_t compno = 0; compno < src->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		for(uint32_t j = 0; j < src->height; ++j)
+		{
+			for(uint32_t i = 0; i < src->width; ++i)
+			{
+				int32_t expected = src->comps[compno][(uint64_t)j * src->width + i];
+				int32_t actual = comp->data[(uint64_t)j * comp->stride + i];
+				if(actual != expected)
+				{
+					spdlog::error("strips: sample ({},{}) of component {} is {}; expected {}", i,
+								  j, compno, actual, expected);
+					goto cleanup;
+				}
+			}
+		}
+	}
+	rc = true;
+cleanup:
+	grk_object_unref(codec);
+	grk_object_unref(stream);
+
+	return rc;
+}
+
+static bool sameFiles(const std::string& first, const std::string& second)
+{
+	std::ifstream f1(first, std::ios::binary), f2(second, std::ios::binary);
+	std::vector<char> b1((std::istreambuf_iterator<char>(f1)), std::istreambuf_iterator<char>());
+	std::vector<char> b2((std::istreambuf_iterator<char>(f2)), std::istreambuf_iterator<char>());
+
+	return !b1.empty() && b1 == b2;
+}
+
+int32_t main(int argc, char** argv)
+{
+	/* should be test_compress_strips <num comps> <width> <height> <tile width> <tile height>
+	 * <strip height> <output file> */
+	if(argc != 8)
+	{
+		spdlog::error("Usage: {} <num comps> <width> <height> <tile width> <tile height> "
+					  "<strip height> <output file>",
+					  argv[0]);
+		return EXIT_FAILURE;
+	}
+	Source src;
+	src.numcomps = (uint16_t)atoi(argv[1]);
+	src.width = (uint32_t)atoi(argv[2]);
+	src.height = (uint32_t)atoi(argv[3]);
+	uint32_t stripHeight = (uint32_t)atoi(argv[6]);
+	std::string stripFile = argv[7];
+	std::string refFile = stripFile + ".ref.j2k";
+	if(!src.numcomps || src.numcomps > maxNumComps || !src.width || !src.height || !stripHeight)
+	{
+		spdlog::error("strips: invalid arguments");
+		return EXIT_FAILURE;
+	}
+	generate(&src);
+
+	grk_initialize(nullptr, 0);
+	grk_set_info_handler(grk::infoCallback, nullptr);
+	grk_set_warning_handler(grk::warningCallback, nullptr);
+	grk_set_error_handler(grk::errorCallback, nullptr);
+	grk_cparameters parameters;
+	grk_compress_set_default_params(&parameters);
+	parameters.tile_size_on = true;
+	parameters.t_width = (uint32_t)atoi(argv[4]);
+	parameters.t_height = (uint32_t)atoi(argv[5]);
+	parameters.numresolution = 4;
+	parameters.writeTLM = true;
+	parameters.writePLT = true;
+
+	int32_t rc = EXIT_FAILURE;
+	if(!compress(&src, &parameters, refFile.c_str(), 0))
+		spdlog::error("strips: failed to compress reference image");
+	else if(!compress(&src, &parameters, stripFile.c_str(), stripHeight))
+		spdlog::error("strips: failed to compress image in strips of {} rows", stripHeight);
+	else if(!sameFiles(refFile, stripFile))
+		spdlog::error("strips: strip code stream differs from reference code stream");
+	else if(verify(&src, stripFile.c_str()))
+		rc = EXIT_SUCCESS;
+	grk_deinitialize();
+
+	return rc;
+}
@@ -0,0 +1,198 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_config.h"
+#include "common.h"
+#include "SyntheticImage.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+const uint16_t numComps = 3;
+
+/**
+ * Small test image : geometry alternates between two sizes, and every third
+ * image is tiled, so that pooled state is re-used across different layouts
+ */
+struct TestImage
+{
+	TestImage(uint32_t imageno)
+		: imageno(imageno), size((imageno & 1) ? 96 : 64), tiled(imageno % 3 == 2),
+		  format((imageno & 2) ? GRK_CODEC_JP2 : GRK_CODEC_J2K), compressedLength(0),
+		  source(numComps, size, size, imageno, false)
+	{}
+	bool compress(bool ht)
+	{
+		grk_cparameters parameters;
+		grk_compress_set_default_params(&parameters);
+		parameters.numresolution = 3;
+		if(tiled)
+		{
+			parameters.tile_size_on = true;
+			parameters.t_width = 32;
+			parameters.t_height = 32;
+		}
+		if(ht)
+		{
+			parameters.cblk_sty = GRK_CBLKSTY_HT;
+			parameters.isHT = true;
+			parameters.numgbits = 1;
+		}
+		compressed.resize((size_t)size * size * numComps * 2 + 1024 * 1024);
+		auto stream =
+			grk_stream_create_mem_stream(compressed.data(), compressed.size(), false, false);
+		if(!stream)
+			return false;
+		bool rc = source.compress(&parameters, format, stream, nullptr);
+		if(rc)
+			compressedLength = grk_stream_get_write_mem_stream_length(stream);
+		grk_object_unref(stream);
+
+		return rc;
+	}
+	bool check(grk_image* image) const
+	{
+		if(!image || image->numcomps != numComps || image->x1 - image->x0 != size ||
+		   image->y1 - image->y0 != size)
+		{
+			spdlog::error("batch: image {} has wrong dimensions", imageno);
+			return false;
+		}
+		for(uint16_t compno = 0; compno < numComps; ++compno)
+		{
+			auto comp = image->comps + compno;
+			if(!comp->data)
+			{
+				spdlog::error("batch: image {} component {} has no data", imageno, compno);
+				return false;
+			}
+			for(uint32_t j = 0; j < size; ++j)
+			{
+				for(uint32_t i = 0; i < size; ++i)
+				{
+					if(comp->data[(uint64_t)j * comp->stride + i] !=
+					   source.getSample(i, j, compno))
+					{
+						spdlog::error("batch: image {} component {} differs at ({},{})",
+									  imageno, compno, i, j);
+						return false;
+					}
+				}
+			}
+		}
+
+		return true;
+	}
+
+	uint32_t imageno;
+	uint32_t size;
+	bool tiled;
+	GRK_CODEC_FORMAT format;
+	std::vector<uint8_t> compressed;
+	size_t compressedLength;
+	grk::SyntheticImage source;
+};
+
+static bool decompressBatch(grk_decompress_context* context, std::vector<TestImage>& images)
+{
+	grk_dparameters parameters;
+	grk_decompress_set_default_params(&parameters);
+	std::vector<grk_decompress_batch_item> items(images.size());
+	for(size_t i = 0; i < images.size(); ++i)
+	{
+		items[i].data = images[i].compressed.data();
+		items[i].len = images[i].compressedLength;
+	}
+	bool rc = grk_decompress_batch(context, &parameters, items.data(), (uint32_t)items.size());
+	for(size_t i = 0; i < images.size(); ++i)
+	{
+		if(!items[i].success || !images[i].check(items[i].image))
+			rc = false;
+		if(items[i].image)
+			grk_object_unref(&items[i].image->obj);
+	}
+
+	return rc;
+}
+
+int32_t main(int argc, char** argv)
+{
+	/* should be test_decompress_batch <ht> <number of images> */
+	if(argc != 3)
+	{
+		spdlog::error("Usage: {} <ht> <number of images>", argv[0]);
+		return EXIT_FAILURE;
+	}
+	bool ht = atoi(argv[1]) != 0;
+	uint32_t numImages = (uint32_t)atoi(argv[2]);
+
+	grk_initialize(nullptr, 0);
+	grk_set_info_handler(grk::infoCallback, nullptr);
+	grk_set_warning_handler(grk::warningCallback, nullptr);
+	grk_set_error_handler(grk::errorCallback, nullptr);
+
+	int32_t rc = EXIT_FAILURE;
+	std::vector<TestImage> images;
+	for(uint32_t i = 0; i < numImages; ++i)
+		images.emplace_back(i);
+	bool compressed = true;
+	for(auto& image : images)
+	{
+		if(!image.compress(ht))
+		{
+			spdlog::error("batch: failed to compress image {}", image.imageno);
+			compressed = false;
+			break;
+		}
+	}
+	if(compressed)
+	{
+		auto context = grk_decompress_context_create();
+		// second batch runs entirely on state recycled from the first
+		if(!decompressBatch(nullptr, images))
+			spdlog::error("batch: failed to decompress without context");
+		else if(!decompressBatch(context, images) || !decompressBatch(context, images))
+			spdlog::error("batch: failed to decompress with context");
+		else
+		{
+			// a corrupt code stream fails on its own
+			uint8_t garbage[64];
+			memset(garbage, 0xA5, sizeof(garbage));
+			grk_decompress_batch_item items[2];
+			memset(items, 0, sizeof(items));
+			items[0].data = garbage;
+			items[0].len = sizeof(garbage);
+			items[1].data = images[0].compressed.data();
+			items[1].len = images[0].compressedLength;
+			grk_dparameters parameters;
+			grk_decompress_set_default_params(&parameters);
+			bool batchRc = grk_decompress_batch(context, &parameters, items, 2);
+			if(batchRc || items[0].success || items[0].image || !items[1].success ||
+			   !images[0].check(items[1].image))
+				spdlog::error("batch: corrupt code stream was not isolated");
+			else
+				rc = EXIT_SUCCESS;
+			if(items[1].image)
+				grk_object_unref(&items[1].image->obj);
+		}
+		grk_object_unref(context);
+	}
+	grk_deinitialize();
+
+	return rc;
+}
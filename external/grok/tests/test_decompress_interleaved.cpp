@@ -0,0 +1,176 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_config.h"
+#include "common.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+struct Window
+{
+	uint32_t x0, y0, x1, y1;
+};
+
+// padding at end of each interleaved row, which must not be written to
+const uint32_t rowPadding = 16;
+const uint8_t padValue = 0xA5;
+
+static grk_codec* create_codec(grk_dparameters* parameters, grk_stream** stream)
+{
+	*stream = grk_stream_create_file_stream(parameters->infile, 1024 * 1024, 1);
+	if(!*stream)
+	{
+		spdlog::error("failed to create a stream from file {}", parameters->infile);
+		return nullptr;
+	}
+	auto codec = grk_decompress_create(
+		parameters->decod_format == GRK_J2K_FMT ? GRK_CODEC_J2K : GRK_CODEC_JP2, *stream);
+	if(!codec || !grk_decompress_init(codec, parameters) ||
+	   !grk_decompress_read_header(codec, nullptr))
+	{
+		spdlog::error("interleaved: failed to read header");
+		grk_object_unref(codec);
+		grk_object_unref(*stream);
+		*stream = nullptr;
+		return nullptr;
+	}
+
+	return codec;
+}
+
+/**
+ * Decompress into planar composite image, and then into interleaved buffer,
+ * and compare the two
+ */
+static bool test_interleaved(grk_dparameters* parameters, Window* window, uint8_t bitsPerSample)
+{
+	bool rc = false;
+	grk_stream *planarStream = nullptr, *stream = nullptr;
+	grk_codec* codec = nullptr;
+	grk_image* image = nullptr;
+	uint32_t bytesPerSample = bitsPerSample / 8U;
+	uint64_t stride = 0;
+	std::vector<uint8_t> buffer;
+
+	auto planarCodec = create_codec(parameters, &planarStream);
+	if(!planarCodec ||
+	   !grk_decompress_set_window(planarCodec, window->x0, window->y0, window->x1, window->y1) ||
+	   !grk_decompress(planarCodec, nullptr))
+	{
+		spdlog::error("interleaved: failed to decompress planar image");
+		goto cleanup;
+	}
+	image = grk_decompress_get_composited_image(planarCodec);
+
+	codec = create_codec(parameters, &stream);
+	if(!codec ||
+	   !grk_decompress_set_window(codec, window->x0, window->y0, window->x1, window->y1))
+		goto cleanup;
+	stride = (uint64_t)image->comps->w * image->numcomps * bytesPerSample + rowPadding;
+	buffer.resize(stride * image->comps->h, padValue);
+	if(!grk_decompress_set_interleaved_output(codec, buffer.data(), stride, bitsPerSample) ||
+	   !grk_decompress(codec, nullptr))
+	{
+		spdlog::error("interleaved: failed to decompress interleaved image");
+		goto cleanup;
+	}
+	for(uint32_t j = 0; j < image->comps->h; ++j)
+	{
+		auto row = buffer.data() + j * stride;
+		for(uint32_t i = 0; i < image->comps->w; ++i)
+		{
+			for(uint16_t compno = 0; compno < image->numcomps; ++compno)
+			{
+				auto comp = image->comps + compno;
+				int32_t expected = comp->data[(uint64_t)j * comp->stride + i];
+				uint64_t index = (uint64_t)i * image->numcomps + compno;
+				int32_t actual = bitsPerSample == 8 ? row[index] : ((uint16_t*)row)[index];
+				if(actual != expected)
+				{
+					spdlog::error("interleaved: {} bit sample ({},{}) of component {} is {}; "
+								  "expected {}",
+								  bitsPerSample, i, j, compno, actual, expected);
+					goto cleanup;
+				}
+			}
+		}
+		for(uint32_t k = 0; k < rowPadding; ++k)
+		{
+			if(row[stride - rowPadding + k] != padValue)
+			{
+				spdlog::error("interleaved: padding of row {} was overwritten", j);
+				goto cleanup;
+			}
+		}
+	}
+	rc = true;
+cleanup:
+	grk_object_unref(codec);
+	grk_object_unref(stream);
+	grk_object_unref(planarCodec);
+	grk_object_unref(planarStream);
+
+	return rc;
+}
+
+int32_t main(int argc, char** argv)
+{
+	grk_dparameters parameters;
+	int32_t rc = EXIT_SUCCESS;
+	Window windows[] = {{0, 0, 0, 0}, {100, 100, 300, 300}, {37, 5, 301, 259}};
+	uint8_t reductions[] = {0, 1};
+	uint8_t bitsPerSample[] = {8, 16};
+
+	/* should be test_decompress_interleaved tte8.j2k */
+	if(argc != 2)
+	{
+		spdlog::error("Usage: {} <input_file>", argv[0]);
+		return EXIT_FAILURE;
+	}
+	grk_initialize(nullptr, 0);
+	grk_set_info_handler(grk::infoCallback, nullptr);
+	grk_set_warning_handler(grk::warningCallback, nullptr);
+	grk_set_error_handler(grk::errorCallback, nullptr);
+	grk_decompress_set_default_params(&parameters);
+	strncpy(parameters.infile, argv[1], GRK_PATH_LEN - 1);
+	if(!grk::jpeg2000_file_format(parameters.infile, &parameters.decod_format))
+	{
+		spdlog::error("Failed to detect JPEG 2000 file format for file {}", parameters.infile);
+		return EXIT_FAILURE;
+	}
+	for(auto reduce : reductions)
+	{
+		parameters.cp_reduce = reduce;
+		for(auto& window : windows)
+		{
+			for(auto bits : bitsPerSample)
+			{
+				if(!test_interleaved(&parameters, &window, bits))
+				{
+					spdlog::error("interleaved: failed for window ({},{},{},{}), reduce {}",
+								  window.x0, window.y0, window.x1, window.y1, reduce);
+					rc = EXIT_FAILURE;
+				}
+			}
+		}
+	}
+	grk_deinitialize();
+
+	return rc;
+}
@@ -0,0 +1,361 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_config.h"
+#include "common.h"
+#include "SyntheticImage.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <deque>
+#include <map>
+#include <vector>
+
+const uint16_t numComps = 3;
+const uint32_t imageSize = 384;
+const uint32_t tileSize = 128;
+// Iplm bytes per Nplm, kept small so that tile parts continue into following PLM segments
+const size_t maxNplmBytes = 16;
+
+static uint32_t numPlmWarnings = 0;
+
+static void warningCallback(const char* msg, void* client_data)
+{
+	if(strstr(msg, "PLM"))
+		numPlmWarnings++;
+	grk::warningCallback(msg, client_data);
+}
+
+/**
+ * Compress multi-tile image with PLT markers, and one tile part per resolution
+ */
+static bool compress(const char* file)
+{
+	grk_cparameters parameters;
+	grk_compress_set_default_params(&parameters);
+	parameters.tile_size_on = true;
+	parameters.t_width = tileSize;
+	parameters.t_height = tileSize;
+	parameters.numresolution = 3;
+	parameters.writePLT = true;
+	parameters.enableTilePartGeneration = true;
+	parameters.newTilePartProgressionDivider = 'R';
+	// noise, so that packet lengths differ from tile to tile
+	grk::SyntheticImage source(numComps, imageSize, imageSize, 0, true);
+
+	return source.compress(&parameters, file, nullptr);
+}
+
+static uint16_t getShort(const std::vector<uint8_t>& buf, size_t pos)
+{
+	return (uint16_t)((buf[pos] << 8) | buf[pos + 1]);
+}
+
+static uint32_t getInt(const std::vector<uint8_t>& buf, size_t pos)
+{
+	return ((uint32_t)getShort(buf, pos) << 16) | getShort(buf, pos + 2);
+}
+
+static void putShort(std::vector<uint8_t>& buf, uint16_t val)
+{
+	buf.push_back((uint8_t)(val >> 8));
+	buf.push_back((uint8_t)val);
+}
+
+static void putInt(std::vector<uint8_t>& buf, uint32_t val)
+{
+	putShort(buf, (uint16_t)(val >> 16));
+	putShort(buf, (uint16_t)val);
+}
+
+struct TilePart
+{
+	uint16_t tileIndex;
+	uint8_t tilePartIndex;
+	uint8_t numTileParts;
+	// tile part header markers, other than PLT, and tile part data following SOD
+	std::vector<uint8_t> header;
+	std::vector<uint8_t> data;
+};
+
+/**
+ * Move packet lengths of a code stream from PLT markers into PLM markers,
+ * and write a TLM marker for the resulting tile parts.
+ * PLT markers of a tile may cover packets of later tile parts of the tile.
+ */
+static bool convertToPlm(const std::vector<uint8_t>& in, std::vector<uint8_t>& out)
+{
+	if(in.size() < 4 || getShort(in, 0) != 0xFF4F)
+		return false;
+	size_t pos = 2;
+	std::vector<uint8_t> mainHeader;
+	while(pos + 4 <= in.size() && getShort(in, pos) != 0xFF90)
+	{
+		uint16_t marker = getShort(in, pos);
+		size_t len = 2 + (size_t)getShort(in, pos + 2);
+		if(pos + len > in.size())
+			return false;
+		if(marker != 0xFF55 && marker != 0xFF57)
+			mainHeader.insert(mainHeader.end(), in.begin() + (ptrdiff_t)pos,
+							  in.begin() + (ptrdiff_t)(pos + len));
+		pos += len;
+	}
+	std::vector<TilePart> tileParts;
+	// packet lengths of each tile, in code stream order
+	std::map<uint16_t, std::deque<uint32_t>> packetLengths;
+	while(pos + 12 <= in.size() && getShort(in, pos) == 0xFF90)
+	{
+		TilePart tp;
+		tp.tileIndex = getShort(in, pos + 4);
+		uint32_t psot = getInt(in, pos + 6);
+		tp.tilePartIndex = in[pos + 10];
+		tp.numTileParts = in[pos + 11];
+		if(!psot || pos + psot > in.size())
+			return false;
+		size_t end = pos + psot;
+		pos += 12;
+		while(pos + 2 <= end && getShort(in, pos) != 0xFF93)
+		{
+			size_t len = 2 + (size_t)getShort(in, pos + 2);
+			if(pos + len > end)
+				return false;
+			if(getShort(in, pos) == 0xFF58)
+			{
+				uint32_t length = 0;
+				for(size_t i = pos + 5; i < pos + len; ++i)
+				{
+					length = (length << 7) | (in[i] & 0x7F);
+					if(!(in[i] & 0x80))
+					{
+						packetLengths[tp.tileIndex].push_back(length);
+						length = 0;
+					}
+				}
+			}
+			else
+			{
+				tp.header.insert(tp.header.end(), in.begin() + (ptrdiff_t)pos,
+								 in.begin() + (ptrdiff_t)(pos + len));
+			}
+			pos += len;
+		}
+		if(pos + 2 > end)
+			return false;
+		tp.data.assign(in.begin() + (ptrdiff_t)pos + 2, in.begin() + (ptrdiff_t)end);
+		tileParts.push_back(tp);
+		pos = end;
+	}
+	if(tileParts.empty())
+		return false;
+
+	// PLM segments : a tile part's Iplm bytes are split at packet boundaries,
+	// and each continuation starts a new segment
+	std::vector<std::vector<uint8_t>> segments(1);
+	for(auto& tp : tileParts)
+	{
+		auto& lengths = packetLengths[tp.tileIndex];
+		uint64_t dataLength = 0;
+		std::vector<std::vector<uint8_t>> groups(1);
+		while(dataLength < tp.data.size() && !lengths.empty())
+		{
+			uint32_t length = lengths.front();
+			lengths.pop_front();
+			dataLength += length;
+			uint8_t bytes[5];
+			size_t numBytes = 0;
+			do
+			{
+				bytes[numBytes] = (uint8_t)((length & 0x7F) | (numBytes ? 0x80 : 0));
+				length >>= 7;
+				numBytes++;
+			} while(length);
+			if(groups.back().size() + numBytes > maxNplmBytes)
+				groups.emplace_back();
+			while(numBytes)
+				groups.back().push_back(bytes[--numBytes]);
+		}
+		if(dataLength != tp.data.size())
+			return false;
+		for(size_t i = 0; i < groups.size(); ++i)
+		{
+			if(i)
+				segments.emplace_back();
+			auto& segment = segments.back();
+			segment.push_back((uint8_t)groups[i].size());
+			segment.insert(segment.end(), groups[i].begin(), groups[i].end());
+		}
+	}
+	if(segments.size() > 256)
+		return false;
+
+	out.clear();
+	putShort(out, 0xFF4F);
+	out.insert(out.end(), mainHeader.begin(), mainHeader.end());
+	// TLM : 16 bit tile indices, 32 bit tile part lengths
+	putShort(out, 0xFF55);
+	putShort(out, (uint16_t)(4 + 6 * tileParts.size()));
+	out.push_back(0);
+	out.push_back(0x60);
+	for(auto& tp : tileParts)
+	{
+		putShort(out, tp.tileIndex);
+		putInt(out, (uint32_t)(12 + tp.header.size() + 2 + tp.data.size()));
+	}
+	for(size_t i = 0; i < segments.size(); ++i)
+	{
+		putShort(out, 0xFF57);
+		putShort(out, (uint16_t)(3 + segments[i].size()));
+		out.push_back((uint8_t)i);
+		out.insert(out.end(), segments[i].begin(), segments[i].end());
+	}
+	for(auto& tp : tileParts)
+	{
+		putShort(out, 0xFF90);
+		putShort(out, 10);
+		putShort(out, tp.tileIndex);
+		putInt(out, (uint32_t)(12 + tp.header.size() + 2 + tp.data.size()));
+		out.push_back(tp.tilePartIndex);
+		out.push_back(tp.numTileParts);
+		out.insert(out.end(), tp.header.begin(), tp.header.end());
+		putShort(out, 0xFF93);
+		out.insert(out.end(), tp.data.begin(), tp.data.end());
+	}
+	putShort(out, 0xFFD9);
+
+	return true;
+}
+
+/**
+ * Decompress window, whole image if window is empty, or single tile if tileIndex is not -1
+ */
+static bool decompress(std::vector<uint8_t>& buf, uint32_t x0, uint32_t y0, uint32_t x1,
+					   uint32_t y1, int32_t tileIndex, std::vector<int32_t>* samples)
+{
+	grk_dparameters parameters;
+	grk_decompress_set_default_params(&parameters);
+	auto stream = grk_stream_create_mem_stream(buf.data(), buf.size(), false, true);
+	auto codec = stream ? grk_decompress_create(GRK_CODEC_J2K, stream) : nullptr;
+	bool rc = codec && grk_decompress_init(codec, &parameters) &&
+			  grk_decompress_read_header(codec, nullptr);
+	if(rc && x1 > x0)
+		rc = grk_decompress_set_window(codec, x0, y0, x1, y1);
+	if(rc)
+		rc = tileIndex == -1 ? grk_decompress(codec, nullptr)
+							 : grk_decompress_tile(codec, (uint16_t)tileIndex);
+	if(rc)
+	{
+		auto image = grk_decompress_get_composited_image(codec);
+		samples->clear();
+		for(uint32_t compno = 0; rc && compno < image->numcomps; ++compno)
+		{
+			auto comp = image->comps + compno;
+			if(!comp->data)
+			{
+				rc = false;
+				break;
+			}
+			for(uint32_t j = 0; j < comp->h; ++j)
+				samples->insert(samples->end(), comp->data + (uint64_t)j * comp->stride,
+								comp->data + (uint64_t)j * comp->stride + comp->w);
+		}
+	}
+	grk_object_unref(codec);
+	grk_object_unref(stream);
+
+	return rc;
+}
+
+static bool compare(std::vector<uint8_t>& plt, std::vector<uint8_t>& plm, uint32_t x0,
+					uint32_t y0, uint32_t x1, uint32_t y1, int32_t tileIndex)
+{
+	std::vector<int32_t> expected, actual;
+	numPlmWarnings = 0;
+	if(!decompress(plt, x0, y0, x1, y1, tileIndex, &expected) ||
+	   !decompress(plm, x0, y0, x1, y1, tileIndex, &actual))
+	{
+		spdlog::error("plm: failed to decompress window ({},{},{},{}), tile {}", x0, y0, x1, y1,
+					  tileIndex);
+		return false;
+	}
+	if(expected != actual)
+	{
+		spdlog::error("plm: window ({},{},{},{}), tile {} differs from PLT decompress", x0, y0,
+					  x1, y1, tileIndex);
+		return false;
+	}
+	// PLM lengths must stay in step with tile parts that are skipped
+	if(numPlmWarnings)
+	{
+		spdlog::error("plm: window ({},{},{},{}), tile {} ignored PLM markers", x0, y0, x1, y1,
+					  tileIndex);
+		return false;
+	}
+
+	return true;
+}
+
+int32_t main(int argc, char** argv)
+{
+	/* should be test_decompress_plm <output file> */
+	if(argc != 2)
+	{
+		spdlog::error("Usage: {} <output file>", argv[0]);
+		return EXIT_FAILURE;
+	}
+	const char* file = argv[1];
+
+	grk_initialize(nullptr, 0);
+	grk_set_info_handler(grk::infoCallback, nullptr);
+	grk_set_warning_handler(warningCallback, nullptr);
+	grk_set_error_handler(grk::errorCallback, nullptr);
+
+	bool rc = compress(file);
+	std::vector<uint8_t> plt, plm;
+	if(rc)
+	{
+		auto fp = fopen(file, "rb");
+		if(fp)
+		{
+			fseek(fp, 0, SEEK_END);
+			plt.resize((size_t)ftell(fp));
+			fseek(fp, 0, SEEK_SET);
+			if(fread(plt.data(), 1, plt.size(), fp) != plt.size())
+				plt.clear();
+			fclose(fp);
+		}
+	}
+	if(!rc)
+	{
+		spdlog::error("plm: failed to compress {}", file);
+	}
+	else if(!convertToPlm(plt, plm))
+	{
+		spdlog::error("plm: failed to convert PLT markers of {} to PLM markers", file);
+		rc = false;
+	}
+	// whole image, window inside last tile, window straddling four tiles, and each single tile
+	uint32_t numTiles = (imageSize / tileSize) * (imageSize / tileSize);
+	uint32_t last = imageSize - tileSize;
+	rc = rc && compare(plt, plm, 0, 0, 0, 0, -1) &&
+		 compare(plt, plm, last + 10, last + 10, imageSize - 10, imageSize - 10, -1) &&
+		 compare(plt, plm, last - 10, last - 10, last + 10, last + 10, -1);
+	for(uint32_t i = 0; rc && i < numTiles; ++i)
+		rc = compare(plt, plm, 0, 0, 0, 0, (int32_t)(numTiles - 1 - i));
+	grk_deinitialize();
+
+	return rc ? EXIT_SUCCESS : EXIT_FAILURE;
+}
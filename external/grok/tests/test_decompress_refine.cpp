@@ -0,0 +1,173 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_config.h"
+#include "common.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+struct Window
+{
+	uint32_t x0, y0, x1, y1;
+};
+
+struct Refinement
+{
+	uint16_t layers;
+	uint8_t reduce;
+};
+
+static grk_codec* create_codec(grk_dparameters* parameters, grk_stream** stream)
+{
+	*stream = grk_stream_create_file_stream(parameters->infile, 1024 * 1024, 1);
+	if(!*stream)
+	{
+		spdlog::error("failed to create a stream from file {}", parameters->infile);
+		return nullptr;
+	}
+	auto codec = grk_decompress_create(
+		parameters->decod_format == GRK_J2K_FMT ? GRK_CODEC_J2K : GRK_CODEC_JP2, *stream);
+	if(!codec || !grk_decompress_init(codec, parameters) ||
+	   !grk_decompress_read_header(codec, nullptr))
+	{
+		spdlog::error("refine: failed to read header");
+		grk_object_unref(codec);
+		grk_object_unref(*stream);
+		*stream = nullptr;
+		return nullptr;
+	}
+
+	return codec;
+}
+
+static bool get_samples(grk_codec* codec, std::vector<int32_t>* samples)
+{
+	auto image = grk_decompress_get_composited_image(codec);
+	samples->clear();
+	for(uint32_t compno = 0; compno < image->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		if(!comp->data)
+			return false;
+		for(uint32_t j = 0; j < comp->h; ++j)
+			samples->insert(samples->end(), comp->data + (uint64_t)j * comp->stride,
+							comp->data + (uint64_t)j * comp->stride + comp->w);
+	}
+
+	return true;
+}
+
+static bool decompress(grk_dparameters* parameters, Window* window, Refinement* ref,
+					   grk_codec** codec, grk_stream** stream)
+{
+	parameters->cp_layer = ref->layers;
+	parameters->cp_reduce = ref->reduce;
+	*codec = create_codec(parameters, stream);
+
+	return *codec &&
+		   grk_decompress_set_window(*codec, window->x0, window->y0, window->x1, window->y1) &&
+		   grk_decompress(*codec, nullptr);
+}
+
+static int32_t test_refine(grk_dparameters* parameters, grk_dparameters* refParameters,
+						   Window* window)
+{
+	// preview, followed by refinements that add layers, add resolutions, or both
+	Refinement refinements[] = {{1, 2}, {2, 2}, {2, 1}, {4, 0}, {0, 0}};
+	int32_t rc = EXIT_FAILURE;
+	grk_codec* codec = nullptr;
+	grk_stream* stream = nullptr;
+	for(uint32_t i = 0; i < sizeof(refinements) / sizeof(Refinement); ++i)
+	{
+		auto ref = refinements + i;
+		std::vector<int32_t> refined, fresh;
+		bool refineRc = (i == 0) ? decompress(parameters, window, ref, &codec, &stream)
+								 : grk_decompress_refine(codec, ref->layers, ref->reduce);
+		if(!refineRc || !get_samples(codec, &refined))
+		{
+			spdlog::error("refine: failed to decompress refinement {}", i);
+			goto cleanup;
+		}
+
+		// compare with decompress from scratch
+		grk_codec* freshCodec = nullptr;
+		grk_stream* freshStream = nullptr;
+		bool freshRc = decompress(refParameters, window, ref, &freshCodec, &freshStream) &&
+					   get_samples(freshCodec, &fresh);
+		grk_object_unref(freshCodec);
+		grk_object_unref(freshStream);
+		if(!freshRc)
+			goto cleanup;
+		if(refined != fresh)
+		{
+			spdlog::error("refine: refinement {} (layers {}, reduce {}) differs from "
+						  "decompress from scratch",
+						  i, ref->layers, ref->reduce);
+			goto cleanup;
+		}
+	}
+	rc = EXIT_SUCCESS;
+cleanup:
+	grk_object_unref(codec);
+	grk_object_unref(stream);
+
+	return rc;
+}
+
+int32_t main(int argc, char** argv)
+{
+	grk_dparameters parameters, refParameters;
+	int32_t rc = EXIT_SUCCESS;
+	Window windows[] = {{0, 0, 0, 0}, {100, 100, 300, 300}};
+
+	/* should be test_decompress_refine tte8.j2k [reference file] */
+	/* reference file holds the same image, compressed without packet length markers */
+	if(argc != 2 && argc != 3)
+	{
+		spdlog::error("Usage: {} <input_file> [reference file]", argv[0]);
+		return EXIT_FAILURE;
+	}
+	grk_initialize(nullptr, 0);
+	grk_set_info_handler(grk::infoCallback, nullptr);
+	grk_set_warning_handler(grk::warningCallback, nullptr);
+	grk_set_error_handler(grk::errorCallback, nullptr);
+	grk_decompress_set_default_params(&parameters);
+	strncpy(parameters.infile, argv[1], GRK_PATH_LEN - 1);
+	if(!grk::jpeg2000_file_format(parameters.infile, &parameters.decod_format))
+	{
+		spdlog::error("Failed to detect JPEG 2000 file format for file {}", parameters.infile);
+		return EXIT_FAILURE;
+	}
+	refParameters = parameters;
+	if(argc == 3)
+	{
+		strncpy(refParameters.infile, argv[2], GRK_PATH_LEN - 1);
+		if(!grk::jpeg2000_file_format(refParameters.infile, &refParameters.decod_format))
+		{
+			spdlog::error("Failed to detect JPEG 2000 file format for file {}",
+						  refParameters.infile);
+			return EXIT_FAILURE;
+		}
+	}
+	for(uint32_t i = 0; i < sizeof(windows) / sizeof(Window) && rc == EXIT_SUCCESS; ++i)
+		rc = test_refine(&parameters, &refParameters, windows + i);
+	grk_deinitialize();
+
+	return rc;
+}
@@ -0,0 +1,293 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_config.h"
+#include "common.h"
+#include "SyntheticImage.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <atomic>
+#include <vector>
+
+const uint16_t numComps = 3;
+const uint32_t imageSize = 800;
+const uint32_t tileSize = 160;
+const size_t streamBufferSize = 4096;
+
+// noise, so that each tile part is larger than the gap over which ranges are coalesced
+static const grk::SyntheticImage source(numComps, imageSize, imageSize, 0, true);
+
+static bool compress(bool ht, const char* file)
+{
+	grk_cparameters parameters;
+	grk_compress_set_default_params(&parameters);
+	parameters.tile_size_on = true;
+	parameters.t_width = tileSize;
+	parameters.t_height = tileSize;
+	parameters.numresolution = 3;
+	parameters.writeTLM = true;
+	if(ht)
+	{
+		parameters.cblk_sty = GRK_CBLKSTY_HT;
+		parameters.isHT = true;
+		parameters.numgbits = 1;
+	}
+
+	return source.compress(&parameters, file, nullptr);
+}
+
+/**
+ * In-memory stand-in for a remote object, counting sequential and range reads
+ */
+struct RemoteObject
+{
+	RemoteObject(void) : offset(0), failRangeReads(false)
+	{
+		resetCounters();
+	}
+	void resetCounters(void)
+	{
+		offset = 0;
+		sequentialBytes = 0;
+		rangeCalls = 0;
+		ranges = 0;
+		rangeBytes = 0;
+	}
+	std::vector<uint8_t> data;
+	uint64_t offset;
+	bool failRangeReads;
+	std::atomic<uint64_t> sequentialBytes;
+	std::atomic<uint32_t> rangeCalls;
+	std::atomic<uint32_t> ranges;
+	std::atomic<uint64_t> rangeBytes;
+};
+
+static size_t remoteRead(void* buffer, size_t numBytes, void* user_data)
+{
+	auto remote = (RemoteObject*)user_data;
+	size_t numRead = std::min<size_t>(numBytes, remote->data.size() - remote->offset);
+	memcpy(buffer, remote->data.data() + remote->offset, numRead);
+	remote->offset += numRead;
+	remote->sequentialBytes += numRead;
+
+	return numRead;
+}
+
+static bool remoteSeek(uint64_t offset, void* user_data)
+{
+	auto remote = (RemoteObject*)user_data;
+	if(offset > remote->data.size())
+		return false;
+	remote->offset = offset;
+
+	return true;
+}
+
+static bool remoteReadRanges(grk_stream_range* ranges, uint32_t numRanges, void* user_data)
+{
+	auto remote = (RemoteObject*)user_data;
+	remote->rangeCalls++;
+	if(remote->failRangeReads)
+		return false;
+	for(uint32_t i = 0; i < numRanges; ++i)
+	{
+		auto range = ranges + i;
+		if(range->offset + range->length > remote->data.size())
+			return false;
+		memcpy(range->buffer, remote->data.data() + range->offset, range->length);
+		remote->ranges++;
+		remote->rangeBytes += range->length;
+	}
+
+	return true;
+}
+
+static grk_stream* createRemoteStream(RemoteObject* remote)
+{
+	auto stream = grk_stream_new(streamBufferSize, true);
+	grk_stream_set_user_data(stream, remote, nullptr);
+	grk_stream_set_user_data_length(stream, remote->data.size());
+	grk_stream_set_read_function(stream, remoteRead);
+	grk_stream_set_seek_function(stream, remoteSeek);
+	grk_stream_set_read_ranges_function(stream, remoteReadRanges);
+
+	return stream;
+}
+
+static bool check(grk_image* image, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
+{
+	if(!image || image->numcomps != numComps)
+		return false;
+	for(uint16_t compno = 0; compno < numComps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		if(!comp->data || comp->x0 != x0 || comp->y0 != y0 || comp->w != x1 - x0 ||
+		   comp->h != y1 - y0)
+		{
+			spdlog::error("prefetch: component {} has wrong dimensions", compno);
+			return false;
+		}
+		for(uint32_t j = 0; j < comp->h; ++j)
+		{
+			for(uint32_t i = 0; i < comp->w; ++i)
+			{
+				if(comp->data[(uint64_t)j * comp->stride + i] != source.getSample(x0 + i, y0 + j, compno))
+				{
+					spdlog::error("prefetch: component {} differs at ({},{})", compno, x0 + i,
+								  y0 + j);
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Decompress window, or whole image if window is empty
+ */
+static bool decompress(grk_stream* stream, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1)
+{
+	grk_dparameters parameters;
+	grk_decompress_set_default_params(&parameters);
+	auto codec = grk_decompress_create(GRK_CODEC_J2K, stream);
+	bool rc = codec && grk_decompress_init(codec, &parameters) &&
+			  grk_decompress_read_header(codec, nullptr);
+	if(rc && x1 > x0)
+		rc = grk_decompress_set_window(codec, x0, y0, x1, y1);
+	rc = rc && grk_decompress(codec, nullptr);
+	if(rc)
+	{
+		if(x1 == x0)
+		{
+			x1 = imageSize;
+			y1 = imageSize;
+		}
+		rc = check(grk_decompress_get_composited_image(codec), x0, y0, x1, y1);
+	}
+	grk_object_unref(codec);
+
+	return rc;
+}
+
+static bool testRemote(RemoteObject* remote)
+{
+	auto stream = createRemoteStream(remote);
+	bool rc = decompress(stream, 0, 0, 0, 0);
+	grk_object_unref(stream);
+	if(!rc)
+	{
+		spdlog::error("prefetch: failed to decompress image");
+		return false;
+	}
+	// only the main header is read sequentially, and coalesced tile parts
+	// are read in fewer ranges than there are tiles
+	uint32_t numTiles = (imageSize / tileSize) * (imageSize / tileSize);
+	if(remote->sequentialBytes > streamBufferSize || !remote->rangeCalls ||
+	   remote->ranges >= numTiles || remote->rangeBytes + streamBufferSize < remote->data.size())
+	{
+		spdlog::error("prefetch: image read {} bytes sequentially and {} bytes in {} ranges, "
+					  "over {} calls",
+					  (uint64_t)remote->sequentialBytes, (uint64_t)remote->rangeBytes,
+					  (uint32_t)remote->ranges, (uint32_t)remote->rangeCalls);
+		return false;
+	}
+
+	// window covering four tiles only fetches those tiles
+	remote->resetCounters();
+	stream = createRemoteStream(remote);
+	rc = decompress(stream, tileSize + 10, tileSize + 10, 3 * tileSize - 10, 3 * tileSize - 10);
+	grk_object_unref(stream);
+	if(!rc)
+	{
+		spdlog::error("prefetch: failed to decompress window");
+		return false;
+	}
+	if(remote->sequentialBytes > streamBufferSize || remote->rangeBytes > remote->data.size() / 4)
+	{
+		spdlog::error("prefetch: window read {} bytes sequentially and {} bytes in ranges",
+					  (uint64_t)remote->sequentialBytes, (uint64_t)remote->rangeBytes);
+		return false;
+	}
+
+	// failed range reads fall back to sequential reads
+	remote->resetCounters();
+	remote->failRangeReads = true;
+	stream = createRemoteStream(remote);
+	rc = decompress(stream, 0, 0, 0, 0);
+	grk_object_unref(stream);
+	remote->failRangeReads = false;
+	if(!rc || !remote->rangeCalls)
+	{
+		spdlog::error("prefetch: failed to decompress after failed range reads");
+		return false;
+	}
+
+	return true;
+}
+
+int32_t main(int argc, char** argv)
+{
+	/* should be test_stream_prefetch <ht> <output file> */
+	if(argc != 3)
+	{
+		spdlog::error("Usage: {} <ht> <output file>", argv[0]);
+		return EXIT_FAILURE;
+	}
+	bool ht = atoi(argv[1]) != 0;
+	const char* file = argv[2];
+
+	grk_initialize(nullptr, 0);
+	grk_set_info_handler(grk::infoCallback, nullptr);
+	grk_set_warning_handler(grk::warningCallback, nullptr);
+	grk_set_error_handler(grk::errorCallback, nullptr);
+
+	int32_t rc = EXIT_FAILURE;
+	RemoteObject remote;
+	if(!compress(ht, file))
+	{
+		spdlog::error("prefetch: failed to compress {}", file);
+	}
+	else
+	{
+		auto fp = fopen(file, "rb");
+		if(fp)
+		{
+			fseek(fp, 0, SEEK_END);
+			remote.data.resize((size_t)ftell(fp));
+			fseek(fp, 0, SEEK_SET);
+			if(fread(remote.data.data(), 1, remote.data.size(), fp) != remote.data.size())
+				remote.data.clear();
+			fclose(fp);
+		}
+		auto stream = grk_stream_create_mapped_file_range_stream(file, streamBufferSize);
+		if(remote.data.empty())
+			spdlog::error("prefetch: failed to read {}", file);
+		else if(!testRemote(&remote))
+			spdlog::error("prefetch: remote stream test failed");
+		else if(!stream || !decompress(stream, 0, 0, 0, 0))
+			spdlog::error("prefetch: failed to decompress mapped file range stream");
+		else
+			rc = EXIT_SUCCESS;
+		grk_object_unref(stream);
+	}
+	grk_deinitialize();
+
+	return rc;
+}
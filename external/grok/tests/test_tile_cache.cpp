@@ -0,0 +1,177 @@
+/*
+ *    Copyright (C) 2016-2021 Grok Image Compression Inc.
+ *
+ *    This source code is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This source code is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "grk_config.h"
+#include "common.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+struct Request
+{
+	uint32_t x0, y0, x1, y1;
+	uint8_t reduce;
+};
+
+static grk_codec* create_codec(grk_dparameters* parameters, grk_stream** stream)
+{
+	*stream = grk_stream_create_file_stream(parameters->infile, 1024 * 1024, 1);
+	if(!*stream)
+	{
+		spdlog::error("failed to create a stream from file {}", parameters->infile);
+		return nullptr;
+	}
+	auto codec = grk_decompress_create(
+		parameters->decod_format == GRK_J2K_FMT ? GRK_CODEC_J2K : GRK_CODEC_JP2, *stream);
+	if(!codec || !grk_decompress_init(codec, parameters) ||
+	   !grk_decompress_read_header(codec, nullptr))
+	{
+		spdlog::error("tile cache: failed to read header");
+		grk_object_unref(codec);
+		grk_object_unref(*stream);
+		return nullptr;
+	}
+
+	return codec;
+}
+
+static bool decompress(grk_codec* codec, grk_dparameters* parameters, Request* req,
+					   std::vector<int32_t>* samples)
+{
+	parameters->cp_reduce = req->reduce;
+	if(!grk_decompress_init(codec, parameters) ||
+	   !grk_decompress_set_window(codec, req->x0, req->y0, req->x1, req->y1) ||
+	   !grk_decompress(codec, nullptr))
+		return false;
+	auto image = grk_decompress_get_composited_image(codec);
+	samples->clear();
+	for(uint32_t compno = 0; compno < image->numcomps; ++compno)
+	{
+		auto comp = image->comps + compno;
+		if(!comp->data)
+			return false;
+		for(uint32_t j = 0; j < comp->h; ++j)
+			samples->insert(samples->end(), comp->data + (uint64_t)j * comp->stride,
+							comp->data + (uint64_t)j * comp->stride + comp->w);
+	}
+
+	return true;
+}
+
+static int32_t test_cache(grk_dparameters* parameters)
+{
+	// first windows only read some of the tiles, so later requests
+	// must read the remaining tiles from the code stream
+	Request requests[] = {{0, 0, 200, 200, 0},	   {300, 300, 500, 500, 0}, {0, 0, 0, 0, 0},
+						  {100, 100, 300, 300, 0}, {100, 100, 300, 300, 0}, {0, 0, 0, 0, 1},
+						  {100, 100, 300, 300, 1}, {100, 100, 300, 300, 0}, {0, 0, 0, 0, 0}};
+	int32_t rc = EXIT_FAILURE;
+	grk_stream* stream = nullptr;
+	auto codec = create_codec(parameters, &stream);
+	if(!codec)
+		return EXIT_FAILURE;
+	grk_tile_cache_stats prev;
+	memset(&prev, 0, sizeof(prev));
+	for(uint32_t i = 0; i < sizeof(requests) / sizeof(Request); ++i)
+	{
+		auto req = requests + i;
+		std::vector<int32_t> cached, fresh;
+		if(!decompress(codec, parameters, req, &cached))
+		{
+			spdlog::error("tile cache: failed to decompress request {}", i);
+			goto cleanup;
+		}
+		grk_tile_cache_stats stats;
+		if(!grk_decompress_get_tile_cache_stats(codec, &stats))
+			goto cleanup;
+		spdlog::info("request {}: hits {}, misses {}, evictions {}, bytes {}", i, stats.hits,
+					 stats.misses, stats.evictions, stats.bytes);
+		// repeated window must be served from cache when cache is unbounded
+		if(i == 4 && parameters->tileCacheMaxBytes == 0 &&
+		   (stats.hits == prev.hits || stats.misses != prev.misses))
+		{
+			spdlog::error("tile cache: repeated request {} was not served from cache", i);
+			goto cleanup;
+		}
+		if(parameters->tileCacheMaxBytes == 0 && stats.evictions)
+		{
+			spdlog::error("tile cache: unbounded cache evicted tiles");
+			goto cleanup;
+		}
+		prev = stats;
+
+		// compare with uncached decompress
+		auto strategy = parameters->tileCacheStrategy;
+		parameters->tileCacheStrategy = GRK_TILE_CACHE_NONE;
+		grk_stream* freshStream = nullptr;
+		auto freshCodec = create_codec(parameters, &freshStream);
+		bool freshRc = freshCodec && decompress(freshCodec, parameters, req, &fresh);
+		grk_object_unref(freshCodec);
+		grk_object_unref(freshStream);
+		parameters->tileCacheStrategy = strategy;
+		if(!freshRc)
+			goto cleanup;
+		if(cached != fresh)
+		{
+			spdlog::error("tile cache: request {} differs from uncached decompress", i);
+			goto cleanup;
+		}
+	}
+	if(parameters->tileCacheMaxBytes && !prev.evictions)
+	{
+		spdlog::error("tile cache: bounded cache did not evict tiles");
+		goto cleanup;
+	}
+	rc = EXIT_SUCCESS;
+cleanup:
+	grk_object_unref(codec);
+	grk_object_unref(stream);
+
+	return rc;
+}
+
+int32_t main(int argc, char** argv)
+{
+	grk_dparameters parameters;
+	int32_t rc;
+
+	/* should be test_tile_cache tte5.j2k [max bytes] */
+	if(argc != 2 && argc != 3)
+	{
+		spdlog::error("Usage: {} <input_file> [max cache bytes]", argv[0]);
+		return EXIT_FAILURE;
+	}
+	grk_initialize(nullptr, 0);
+	grk_set_info_handler(grk::infoCallback, nullptr);
+	grk_set_warning_handler(grk::warningCallback, nullptr);
+	grk_set_error_handler(grk::errorCallback, nullptr);
+	grk_decompress_set_default_params(&parameters);
+	strncpy(parameters.infile, argv[1], GRK_PATH_LEN - 1);
+	if(!grk::jpeg2000_file_format(parameters.infile, &parameters.decod_format))
+	{
+		spdlog::error("Failed to detect JPEG 2000 file format for file {}", parameters.infile);
+		return EXIT_FAILURE;
+	}
+	parameters.tileCacheStrategy = GRK_TILE_CACHE_LRU;
+	if(argc == 3)
+		parameters.tileCacheMaxBytes = strtoull(argv[2], nullptr, 10);
+	rc = test_cache(&parameters);
+	grk_deinitialize();
+
+	return rc;
+}
@@ -64,11 +64,14 @@ int main(int argc, char *argv[]) {
 	uint8_t comp_prec;
 	bool irreversible;
 	const char *output_file;
+	uint16_t num_layers = 1;
+	GRK_PROG_ORDER prog_order = GRK_LRCP;
+	bool write_plt = false;
 
 	grk_initialize(nullptr, 0);
 
-	/* should be test_tile_encoder 3 2000 2000 1000 1000 8 tte1.j2k */
-	if (argc == 9) {
+	/* should be test_tile_encoder 3 2000 2000 1000 1000 8 tte1.j2k [num layers] [progression] [plt] */
+	if (argc >= 9 && argc <= 12) {
 		num_comps = (uint16_t)atoi(argv[1]);
 		image_width = (uint32_t)atoi(argv[2]);
 		image_height = (uint32_t)atoi(argv[3]);
@@ -77,6 +80,12 @@ int main(int argc, char *argv[]) {
 		comp_prec = (uint8_t)atoi(argv[6]);
 		irreversible = atoi(argv[7]) ? true : false;
 		output_file = argv[8];
+		if (argc >= 10)
+			num_layers = (uint16_t)atoi(argv[9]);
+		if (argc >= 11)
+			prog_order = (GRK_PROG_ORDER)atoi(argv[10]);
+		if (argc == 12)
+			write_plt = atoi(argv[11]) ? true : false;
 	} else {
 		num_comps = 3U;
 		image_width = 2000U;
@@ -87,7 +96,7 @@ int main(int argc, char *argv[]) {
 		irreversible = true;
 		output_file = "test.j2k";
 	}
-	if (num_comps > NUM_COMPS_MAX)
+	if (num_comps > NUM_COMPS_MAX || num_layers == 0 || num_layers > GRK_MAX_LAYERS)
 		goto cleanup;
 
 	nb_tiles = (image_width / tile_width) * (image_height / tile_height);
@@ -107,9 +116,10 @@ int main(int argc, char *argv[]) {
 	/** you may here add custom encoding parameters */
 	/* rate specifications */
 	/** number of quality layers in the stream */
-	param.numlayers = 1;
+	param.numlayers = num_layers;
 	param.allocationByQuality = true;
-	param.layer_distortion[0] = 20;
+	for (i = 0; i < num_layers; ++i)
+		param.layer_distortion[i] = 20 + 10 * i;
 	/* is using others way of calculation */
 	/* param.cp_disto_alloc = 1 or param.cp_fixed_alloc = 1 */
 	/* param.tcp_rates[0] = ... */
@@ -155,7 +165,10 @@ int main(int argc, char *argv[]) {
 
 	/** progression order to use*/
 	/** GRK_LRCP, GRK_RLCP, GRK_RPCL, PCRL, CPRL */
-	param.prog_order = GRK_LRCP;
+	param.prog_order = prog_order;
+
+	/* write packet lengths in PLT markers */
+	param.writePLT = write_plt;
 
 	/** no "region" of interest, more precisely component */
 	/* param.roi_compno = -1; */
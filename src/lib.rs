@@ -65,9 +65,82 @@ pub const GRK_CODEC_JP2: _GRK_CODEC_FORMAT = 2;
 pub type _GRK_CODEC_FORMAT = ::std::os::raw::c_int;
 #[doc = " Supported codecs"]
 pub use self::_GRK_CODEC_FORMAT as GRK_CODEC_FORMAT;
+#[doc = "< tile images are not reused between decompress calls"]
 pub const GRK_TILE_CACHE_NONE: GRK_TILE_CACHE_STRATEGY = 0;
+#[doc = "< all decompressed tile images are kept"]
 pub const GRK_TILE_CACHE_ALL: GRK_TILE_CACHE_STRATEGY = 1;
+#[doc = "< least recently used tile images are evicted beyond tileCacheMaxBytes"]
+pub const GRK_TILE_CACHE_LRU: GRK_TILE_CACHE_STRATEGY = 2;
 pub type GRK_TILE_CACHE_STRATEGY = ::std::os::raw::c_uint;
+#[doc = " Tile cache statistics, accumulated over the lifetime of a decompress codec"]
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct _grk_tile_cache_stats {
+    #[doc = " number of tiles served from the cache"]
+    pub hits: u64,
+    #[doc = " number of tiles that had to be decompressed"]
+    pub misses: u64,
+    #[doc = " number of tile images evicted from the cache"]
+    pub evictions: u64,
+    #[doc = " number of bytes currently held by cached tiles: tile images, plus the code block"]
+    #[doc = " state and compressed data kept to decompress them again"]
+    pub bytes: u64,
+}
+#[doc = " Tile cache statistics, accumulated over the lifetime of a decompress codec"]
+pub type grk_tile_cache_stats = _grk_tile_cache_stats;
+#[doc = "< marker parsing / writing"]
+pub const GRK_STAGE_MARKERS: GRK_STAGE = 0;
+#[doc = "< packet parsing / writing"]
+pub const GRK_STAGE_T2: GRK_STAGE = 1;
+#[doc = "< Part 1 code block coding"]
+pub const GRK_STAGE_T1: GRK_STAGE = 2;
+#[doc = "< high throughput code block coding"]
+pub const GRK_STAGE_T1_HT: GRK_STAGE = 3;
+#[doc = "< wavelet transform"]
+pub const GRK_STAGE_DWT: GRK_STAGE = 4;
+#[doc = "< multiple component transform and DC level shift"]
+pub const GRK_STAGE_MCT: GRK_STAGE = 5;
+#[doc = "< copying tiles into the output image"]
+pub const GRK_STAGE_COMPOSITE: GRK_STAGE = 6;
+#[doc = "< stream callbacks"]
+pub const GRK_STAGE_IO: GRK_STAGE = 7;
+#[doc = "< rate control"]
+pub const GRK_STAGE_RATE_CONTROL: GRK_STAGE = 8;
+pub const GRK_NUM_STAGES: GRK_STAGE = 9;
+#[doc = " Codec stages that are profiled"]
+pub type GRK_STAGE = ::std::os::raw::c_uint;
+#[doc = " Profile of a single codec stage"]
+#[doc = ""]
+#[doc = " Stage invocations may run concurrently on different threads, so that"]
+#[doc = " wall time may exceed the elapsed time of the decompress or compress call."]
+#[doc = " CPU time is measured on the thread that invokes the stage."]
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct _grk_stage_stats {
+    #[doc = " number of stage invocations"]
+    pub count: u64,
+    #[doc = " wall time summed over all invocations, in nanoseconds"]
+    pub wallNs: u64,
+    #[doc = " thread CPU time summed over all invocations, in nanoseconds"]
+    pub cpuNs: u64,
+    #[doc = " number of bytes processed: compressed bytes for markers, T2, T1, I/O and rate control,"]
+    #[doc = "  and sample bytes for the remaining stages"]
+    pub bytes: u64,
+}
+#[doc = " Profile of a single codec stage"]
+#[doc = ""]
+#[doc = " Stage invocations may run concurrently on different threads, so that"]
+#[doc = " wall time may exceed the elapsed time of the decompress or compress call."]
+#[doc = " CPU time is measured on the thread that invokes the stage."]
+pub type grk_stage_stats = _grk_stage_stats;
+#[doc = " Stage profile, accumulated over the lifetime of a codec"]
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct _grk_codec_stats {
+    pub stages: [grk_stage_stats; 9usize],
+}
+#[doc = " Stage profile, accumulated over the lifetime of a codec"]
+pub type grk_codec_stats = _grk_codec_stats;
 #[doc = " Callback function prototype for logging"]
 #[doc = ""]
 #[doc = " @param msg               Event message"]
@@ -426,6 +499,10 @@ pub struct _grk_dparameters {
     pub nb_tile_to_decompress: u32,
     pub flags: u32,
     pub tileCacheStrategy: GRK_TILE_CACHE_STRATEGY,
+    #[doc = "Maximum number of bytes held by the tile cache, for the GRK_TILE_CACHE_LRU strategy,"]
+    #[doc = "counting tile images as well as the code block state and compressed data kept to"]
+    #[doc = "decompress them again. If equal to zero, the cache is unbounded"]
+    pub tileCacheMaxBytes: u64,
 }
 #[doc = " Core decompress parameters"]
 pub type grk_dparameters = _grk_dparameters;
@@ -492,6 +569,7 @@ pub struct _grk_decompress_params {
 #[doc = " Decompress parameters"]
 pub type grk_decompress_parameters = _grk_decompress_params;
 pub type grk_codec = grk_object;
+pub type grk_decompress_context = grk_object;
 pub type grk_stream_read_fn = ::std::option::Option<
     unsafe extern "C" fn(
         buffer: *mut ::std::os::raw::c_void,
@@ -509,6 +587,21 @@ pub type grk_stream_write_fn = ::std::option::Option<
 pub type grk_stream_seek_fn = ::std::option::Option<
     unsafe extern "C" fn(numBytes: u64, user_data: *mut ::std::os::raw::c_void) -> bool,
 >;
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct _grk_stream_range {
+    pub offset: u64,
+    pub length: usize,
+    pub buffer: *mut u8,
+}
+pub type grk_stream_range = _grk_stream_range;
+pub type grk_stream_read_ranges_fn = ::std::option::Option<
+    unsafe extern "C" fn(
+        ranges: *mut grk_stream_range,
+        numRanges: u32,
+        user_data: *mut ::std::os::raw::c_void,
+    ) -> bool,
+>;
 pub type grk_stream_free_user_data_fn =
     ::std::option::Option<unsafe extern "C" fn(user_data: *mut ::std::os::raw::c_void)>;
 pub type grk_stream = grk_object;
@@ -618,6 +711,17 @@ pub struct _grk_image_comptparm {
 }
 #[doc = " Image component parameters"]
 pub type grk_image_cmptparm = _grk_image_comptparm;
+#[doc = " In-memory code stream to be decompressed by grk_decompress_batch"]
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct _grk_decompress_batch_item {
+    pub data: *const u8,
+    pub len: usize,
+    pub image: *mut grk_image,
+    pub success: bool,
+}
+#[doc = " In-memory code stream to be decompressed by grk_decompress_batch"]
+pub type grk_decompress_batch_item = _grk_decompress_batch_item;
 #[doc = " Plugin pass"]
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
@@ -814,6 +918,21 @@ extern "C" {
     #[doc = " @param\t\tp_function\tthe function to use a skip function."]
     pub fn grk_stream_set_seek_function(stream: *mut grk_stream, p_function: grk_stream_seek_fn);
 }
+extern "C" {
+    #[doc = " Set the given function to be used as a range read function, for a seekable"]
+    #[doc = " read stream."]
+    #[doc = ""]
+    #[doc = " When a code stream has TLM markers, the decompressor uses the tile part lengths"]
+    #[doc = " to read all tile parts that it will parse ahead of time, in batches of coalesced"]
+    #[doc = " ranges, so that tiles are decompressed while later tiles are still being read."]
+    #[doc = ""]
+    #[doc = " @param\t\tstream\tthe stream to modify"]
+    #[doc = " @param\t\tp_function\tthe function to use as range read function."]
+    pub fn grk_stream_set_read_ranges_function(
+        stream: *mut grk_stream,
+        p_function: grk_stream_read_ranges_fn,
+    );
+}
 extern "C" {
     #[doc = " Set the given data to be used as a user data for the stream."]
     #[doc = ""]
@@ -876,6 +995,17 @@ extern "C" {
         read_stream: bool,
     ) -> *mut grk_stream;
 }
+extern "C" {
+    #[doc = " Create buffered read stream over memory mapped file, with a range read function"]
+    #[doc = " (see grk_stream_set_read_ranges_function)"]
+    #[doc = ""]
+    #[doc = " @param fname\t\t\tfile name"]
+    #[doc = " @param buffer_size\tsize of the chunk used to stream"]
+    pub fn grk_stream_create_mapped_file_range_stream(
+        fname: *const ::std::os::raw::c_char,
+        buffer_size: usize,
+    ) -> *mut grk_stream;
+}
 extern "C" {
     #[doc = " Create J2K/JP2 decompression structure"]
     #[doc = ""]
@@ -954,6 +1084,28 @@ extern "C" {
         end_y: u32,
     ) -> bool;
 }
+extern "C" {
+    #[doc = " Decompress directly into a caller-supplied interleaved buffer, instead of into"]
+    #[doc = " the planar 32 bit components of the composite image. Each tile is written to the"]
+    #[doc = " buffer as soon as it is decompressed, with components interleaved in code stream order."]
+    #[doc = " The buffer covers the composite image, i.e. the decompress window at the current"]
+    #[doc = " resolution reduction. All components must be unsigned, with the same sub-sampling,"]
+    #[doc = " and with precision no greater than bitsPerSample. This function should be called"]
+    #[doc = " after grk_decompress_read_header; the composite image will have no sample data."]
+    #[doc = ""]
+    #[doc = " @param\tcodec\t\t\tJPEG 2000 code stream"]
+    #[doc = " @param\tbuffer\t\t\tinterleaved buffer, or nullptr to decompress into the composite image"]
+    #[doc = " @param\tstride\t\t\tnumber of bytes between the start of two consecutive rows of buffer"]
+    #[doc = " @param\tbitsPerSample\tbits per sample of buffer : either 8 or 16"]
+    #[doc = ""]
+    #[doc = " @return\ttrue\t\t\tif the buffer could be set."]
+    pub fn grk_decompress_set_interleaved_output(
+        codec: *mut grk_codec,
+        buffer: *mut u8,
+        stride: u64,
+        bitsPerSample: u8,
+    ) -> bool;
+}
 extern "C" {
     #[doc = " Decompress image from a JPEG 2000 code stream"]
     #[doc = ""]
@@ -971,12 +1123,80 @@ extern "C" {
     #[doc = " @return\t\t\t\t\ttrue if successful, otherwise false"]
     pub fn grk_decompress_tile(codec: *mut grk_codec, tileIndex: u16) -> bool;
 }
+extern "C" {
+    #[doc = " Refine a completed decompress of the whole code stream with more quality layers"]
+    #[doc = " and/or less resolution reduction, keeping the decompress window."]
+    #[doc = " Packets and code block coding passes already processed by the earlier decompress"]
+    #[doc = " are re-used, so that only new packets and passes need to be processed."]
+    #[doc = ""]
+    #[doc = " @param\tcodec\t\t\tJPEG 2000 code stream"]
+    #[doc = " @param\tnumLayers\t\tnumber of quality layers to decompress (0 for all layers)"]
+    #[doc = " @param\treduce\t\t\tnumber of highest resolutions to discard"]
+    #[doc = ""]
+    #[doc = " @return\t\t\t\t\ttrue if successful, otherwise false"]
+    pub fn grk_decompress_refine(codec: *mut grk_codec, numLayers: u16, reduce: u8) -> bool;
+}
+extern "C" {
+    #[doc = " Get tile cache statistics"]
+    #[doc = ""]
+    #[doc = " @param\tcodec\t\t\tJPEG 2000 code stream"]
+    #[doc = " @param\tstats\t\t\ttile cache statistics"]
+    #[doc = ""]
+    #[doc = " @return\t\t\t\t\ttrue if successful, otherwise false"]
+    pub fn grk_decompress_get_tile_cache_stats(
+        codec: *mut grk_codec,
+        stats: *mut grk_tile_cache_stats,
+    ) -> bool;
+}
 extern "C" {
     #[doc = " End decompression"]
     #[doc = ""]
     #[doc = " @param\tcodec\t\t\tJPEG 2000 code stream"]
     pub fn grk_decompress_end(codec: *mut grk_codec) -> bool;
 }
+extern "C" {
+    #[doc = " Create a decompress context, to be shared by a run of decompressors."]
+    #[doc = " T1 coders, code block job lists and tile sample buffers are kept in the context"]
+    #[doc = " when a decompressor is done with them, and re-used by the next decompressor,"]
+    #[doc = " which removes most per-image setup when decompressing many small images."]
+    #[doc = " The context must be released with grk_object_unref before grk_deinitialize is called."]
+    #[doc = ""]
+    #[doc = " @return a handle to a decompress context"]
+    pub fn grk_decompress_context_create() -> *mut grk_decompress_context;
+}
+extern "C" {
+    #[doc = " Attach decompress context to decompressor. This function should be called"]
+    #[doc = " before grk_decompress. The decompressor holds a reference to the context, and"]
+    #[doc = " tiles created while it is attached keep their own reference until they are released,"]
+    #[doc = " so the context may safely be replaced or detached at any time."]
+    #[doc = ""]
+    #[doc = " @param\tcodec\t\t\tJPEG 2000 code stream"]
+    #[doc = " @param\tcontext\t\t\tdecompress context, or nullptr to detach current context"]
+    #[doc = ""]
+    #[doc = " @return\t\t\t\t\ttrue if successful, otherwise false"]
+    pub fn grk_decompress_set_context(
+        codec: *mut grk_codec,
+        context: *mut grk_decompress_context,
+    ) -> bool;
+}
+extern "C" {
+    #[doc = " Decompress a batch of in-memory code streams concurrently, on the library's"]
+    #[doc = " thread pool. Each code stream is decompressed in full with the same parameters;"]
+    #[doc = " J2K and JP2 formats are detected from the stream signature."]
+    #[doc = ""]
+    #[doc = " @param\tcontext\t\t\tdecompress context, or nullptr"]
+    #[doc = " @param\tparameters\t\tdecompression parameters"]
+    #[doc = " @param\titems\t\t\tcode streams; on return, each holds its image and status"]
+    #[doc = " @param\tnumItems\t\tnumber of code streams"]
+    #[doc = ""]
+    #[doc = " @return\t\t\t\t\ttrue if all code streams were successfully decompressed"]
+    pub fn grk_decompress_batch(
+        context: *mut grk_decompress_context,
+        parameters: *mut grk_dparameters,
+        items: *mut grk_decompress_batch_item,
+        numItems: u32,
+    ) -> bool;
+}
 extern "C" {
     #[doc = " Creates a J2K/JP2 compression structure"]
     #[doc = " @param \tformat \t\tCoder to select"]
@@ -1060,6 +1280,30 @@ extern "C" {
         data_size: u64,
     ) -> bool;
 }
+extern "C" {
+    #[doc = " Compress a horizontal strip of image rows."]
+    #[doc = ""]
+    #[doc = " Strips are pushed from top to bottom, right after grk_compress_start and before"]
+    #[doc = " grk_compress_end, until all image rows have been pushed. The image passed to"]
+    #[doc = " grk_compress_init need not have any component data allocated. Once the last row of"]
+    #[doc = " a tile row has been pushed, its tiles are compressed and written to the stream while"]
+    #[doc = " the next tile row is filled, so memory use is bounded by tile height rather than"]
+    #[doc = " image height. Strips may be of any height. Subsampled components are not supported."]
+    #[doc = ""]
+    #[doc = " @param\tcodec\t\tcompressor handle"]
+    #[doc = " @param\tdata\t\tarray of planar component buffers, one per component, holding"]
+    #[doc = " \t\t\t\t\t\tnumRows rows of component width samples each"]
+    #[doc = " @param\tstride\t\tarray of component buffer strides, in samples"]
+    #[doc = " @param\tnumRows\t\tnumber of rows in strip"]
+    #[doc = ""]
+    #[doc = " @return\ttrue if successful"]
+    pub fn grk_compress_push_rows(
+        codec: *mut grk_codec,
+        data: *const *const i32,
+        stride: *const u32,
+        numRows: u32,
+    ) -> bool;
+}
 extern "C" {
     #[doc = " Encode an image into a JPEG 2000 code stream using plugin"]
     #[doc = " @param codec \t\tcompressor handle"]
@@ -1082,6 +1326,23 @@ extern "C" {
     #[doc = ""]
     pub fn grk_dump_codec(codec: *mut grk_codec, info_flag: u32, output_stream: *mut FILE);
 }
+extern "C" {
+    #[doc = " Get stage profile of a compress or decompress codec"]
+    #[doc = ""]
+    #[doc = " @param\tcodec\t\t\tJPEG 2000 code stream"]
+    #[doc = " @param\tstats\t\t\tstage profile"]
+    #[doc = ""]
+    #[doc = " @return\t\t\t\t\ttrue if successful, otherwise false"]
+    pub fn grk_codec_get_stats(codec: *mut grk_codec, stats: *mut grk_codec_stats) -> bool;
+}
+extern "C" {
+    #[doc = " Get name of codec stage"]
+    #[doc = ""]
+    #[doc = " @param\tstage\t\t\tcodec stage"]
+    #[doc = ""]
+    #[doc = " @return\t\t\t\t\tstage name, or nullptr if stage is invalid"]
+    pub fn grk_codec_stage_name(stage: GRK_STAGE) -> *const ::std::os::raw::c_char;
+}
 extern "C" {
     #[doc = " Set the MCT matrix to use."]
     #[doc = ""]